@@ -4,19 +4,50 @@
 
 #include <iostream>
 #include "../src/router.hpp"
+#include "../src/static.hpp"
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
 
-int main()
+namespace
 {
   struct Request
   {
     int routed{ 0 };
   };
 
+  using Map = spt::http::router::HttpRouter<Request *, bool>::MapType;
+
+  bool handle( Request *user, Map&& /* args */ )
+  {
+    user->routed++;
+    return true;
+  }
+
+  template <typename Router>
+  void benchmark( const Router& r, const std::vector<std::string>& urls, std::string_view label )
+  {
+    std::cout << label << std::endl;
+    Request request;
+    for ( auto&& url : urls )
+    {
+      auto start = std::chrono::high_resolution_clock::now();
+      for ( int i = 0; i < 10000000; ++i )
+      {
+        r.route( "GET"s, url, &request );
+      }
+      auto stop = std::chrono::high_resolution_clock::now();
+      auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count();
+      std::cout << "[" << (10000.0 / ms) << " million req/sec] for URL: " << url << std::endl;
+    }
+
+    std::cout << "Checksum: " << request.routed << std::endl << std::endl;
+  }
+}
+
+int main()
+{
   spt::http::router::HttpRouter<Request *, bool> r;
-  Request request;
   r.add( "GET"s, "/service/candy/{kind}", [](Request *user, auto&& /* args */) {
     user->routed++;
     return true;
@@ -37,6 +68,35 @@ int main()
     return true;
   } );
 
+  // Handlers bound at compile time and held in an inline buffer
+  spt::http::router::HttpRouter<Request *, bool, Map, spt::http::router::InlineFunction<bool( Request *, Map&& )>> inlined;
+  inlined.add<&handle>( "GET"s, "/service/candy/{kind}" );
+  inlined.add<&handle>( "GET"s, "/service/shutdown" );
+  inlined.add<&handle>( "GET"s, "/" );
+  inlined.add<&handle>( "GET"s, "/{filename}" );
+
+  // Matches for dynamic paths remembered in a match cache
+  auto cached = spt::http::router::HttpRouter<Request *, bool>::Builder{}.withMatchCache( 64 ).build();
+  cached.add<&handle>( "GET"s, "/service/candy/{kind}" );
+  cached.add<&handle>( "GET"s, "/service/shutdown" );
+  cached.add<&handle>( "GET"s, "/" );
+  cached.add<&handle>( "GET"s, "/{filename}" );
+
+  // Recent matches remembered per thread
+  spt::http::router::HttpRouter<Request *, bool, Map, std::function<bool( Request *, Map&& )>, 32> memo;
+  memo.add<&handle>( "GET"s, "/service/candy/{kind}" );
+  memo.add<&handle>( "GET"s, "/service/shutdown" );
+  memo.add<&handle>( "GET"s, "/" );
+  memo.add<&handle>( "GET"s, "/{filename}" );
+
+  // Route table parsed and checked at compile time
+  using spt::http::router::Route;
+  const spt::http::router::StaticRouter<Request *, bool, Map,
+      Route<"GET", "/service/candy/{kind}", &handle>,
+      Route<"GET", "/service/shutdown", &handle>,
+      Route<"GET", "/", &handle>,
+      Route<"GET", "/{filename}", &handle>> fixed;
+
   // run benchmark of various urls
   std::vector<std::string> urls = {
       "/service/candy/lollipop",
@@ -50,17 +110,9 @@ int main()
       "/another_file.jpeg"
   };
 
-  for ( auto&& url : urls )
-  {
-    auto start = std::chrono::high_resolution_clock::now();
-    for ( int i = 0; i < 10000000; ++i )
-    {
-      r.route( "GET"s, url, &request );
-    }
-    auto stop = std::chrono::high_resolution_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count();
-    std::cout << "[" << (10000.0 / ms) << " million req/sec] for URL: " << url << std::endl;
-  }
-
-  std::cout << "Checksum: " << request.routed << std::endl << std::endl;
-}
\ No newline at end of file
+  benchmark( r, urls, "std::function handlers"sv );
+  benchmark( cached, urls, "std::function handlers with match cache"sv );
+  benchmark( memo, urls, "std::function handlers with thread local memo"sv );
+  benchmark( inlined, urls, "InlineFunction handlers bound at compile time"sv );
+  benchmark( fixed, urls, "StaticRouter"sv );
+}
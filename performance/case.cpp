@@ -0,0 +1,115 @@
+//
+// Case-insensitive routing benchmarks using Google Benchmark.  Compares a
+// case-insensitive router with lower casing each path into a new string before
+// routing with a case-sensitive router, and with routing paths that are already
+// in lower case.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <string>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+  struct Request
+  {
+    int routed{ 0 };
+  };
+
+  using Router = spt::http::router::HttpRouter<Request&, bool>;
+
+  constexpr auto Lower = std::array{
+      "/device/sensor/"sv,
+      "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv,
+      "/device/sensor/created/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z"sv,
+      "/device/sensor/customer/code/ABC123/history/summary"sv,
+      "/device/file/reports/2022/03/summary.pdf"sv,
+  };
+
+  constexpr auto Mixed = std::array{
+      "/Device/Sensor/"sv,
+      "/DEVICE/SENSOR/ID/6230f3069e7c9be9ff4b78a1"sv,
+      "/Device/Sensor/Created/Between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z"sv,
+      "/device/SENSOR/Customer/Code/ABC123/History/Summary"sv,
+      "/Device/File/Reports/2022/03/Summary.PDF"sv,
+  };
+
+  bool handle( Request& request, Router::MapType&& )
+  {
+    ++request.routed;
+    return true;
+  }
+
+  void configure( Router& router )
+  {
+    router.add( "GET"sv, "/device/sensor/"sv, &handle );
+    router.add( "GET"sv, "/device/sensor/id/{id}"sv, &handle );
+    router.add( "GET"sv, "/device/sensor/{property}/between/{start}/{end}"sv, &handle );
+    router.add( "GET"sv, "/device/sensor/customer/code/{code}/history/summary"sv, &handle );
+    router.add( "GET"sv, "/device/file/*"sv, &handle );
+  }
+
+  void route( benchmark::State& state, bool caseInsensitive, bool mixed )
+  {
+    Router router{ std::nullopt, std::nullopt, std::nullopt, 0, false, caseInsensitive };
+    configure( router );
+
+    const auto& paths = mixed ? Mixed : Lower;
+    auto request = Request{};
+    std::size_t i = 0;
+    for ( auto _ : state )
+    {
+      auto response = router.route( "GET"sv, paths[i++ % paths.size()], request );
+      benchmark::DoNotOptimize( response );
+    }
+    state.SetItemsProcessed( state.iterations() );
+    state.counters["routed"] = request.routed;
+  }
+
+  // Lower case each path into a new string first, which also lower cases the parameter values
+  void lowered( benchmark::State& state )
+  {
+    Router router;
+    configure( router );
+
+    auto request = Request{};
+    std::size_t i = 0;
+    for ( auto _ : state )
+    {
+      const auto path = spt::util::fold( Mixed[i++ % Mixed.size()] );
+      auto response = router.route( "GET"sv, path, request );
+      benchmark::DoNotOptimize( response );
+    }
+    state.SetItemsProcessed( state.iterations() );
+    state.counters["routed"] = request.routed;
+  }
+
+  // Compare paths of increasing length, to show the cost per byte of the vectorised compare
+  void compare( benchmark::State& state )
+  {
+    auto path = "/"s;
+    while ( path.size() < static_cast<std::size_t>( state.range( 0 ) ) ) path.append( "Segment/" );
+    path.resize( static_cast<std::size_t>( state.range( 0 ) ) );
+    const auto folded = spt::util::fold( path );
+
+    for ( auto _ : state )
+    {
+      auto result = spt::util::equalsFolded( folded, path );
+      benchmark::DoNotOptimize( result );
+    }
+    state.SetBytesProcessed( static_cast<std::int64_t>( state.iterations() * path.size() ) );
+  }
+}
+
+BENCHMARK_CAPTURE( route, sensitive_lower, false, false );
+BENCHMARK_CAPTURE( route, insensitive_lower, true, false );
+BENCHMARK_CAPTURE( route, insensitive_mixed, true, true );
+BENCHMARK( lowered );
+BENCHMARK( compare )->ArgName( "bytes" )->RangeMultiplier( 4 )->Range( 16, 4096 );
+
+BENCHMARK_MAIN();
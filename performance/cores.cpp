@@ -0,0 +1,195 @@
+//
+// Multi-core scaling of routing, with threads pinned to cores and per thread counters.
+//
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+  // Counter for a thread, on its own cache line so threads never share one
+  struct alignas( 64 ) Counter
+  {
+    std::uint64_t routed{ 0 };
+    double seconds{ 0 };
+  };
+
+  struct Request
+  {
+    Request( std::string_view m, std::string_view u ) : method{ m }, url{ u } {}
+    std::string_view method;
+    std::string url;
+  };
+
+  // CPUs the process may run on, threads are pinned to these in order
+  std::vector<int> cpus()
+  {
+    auto set = cpu_set_t{};
+    CPU_ZERO( &set );
+    auto result = std::vector<int>{};
+    if ( sched_getaffinity( 0, sizeof( set ), &set ) != 0 ) return result;
+    for ( int i = 0; i < CPU_SETSIZE; ++i ) if ( CPU_ISSET( i, &set ) ) result.push_back( i );
+    return result;
+  }
+
+  bool pin( std::thread& thread, int cpu )
+  {
+    auto set = cpu_set_t{};
+    CPU_ZERO( &set );
+    CPU_SET( cpu, &set );
+    return pthread_setaffinity_np( thread.native_handle(), sizeof( set ), &set ) == 0;
+  }
+
+  template <typename Router>
+  void configure( Router& r )
+  {
+    for ( auto i = 0; i < 20; ++i )
+    {
+      auto entity = "entity"s + std::to_string( i );
+      for ( auto&& [method, path] : {
+          std::pair{ "POST"sv, entity + "/" }, std::pair{ "GET"sv, entity + "/" },
+          std::pair{ "PUT"sv, entity + "/id/{id}" }, std::pair{ "DELETE"sv, entity + "/id/{id}" },
+          std::pair{ "GET"sv, entity + "/id/{id}" }, std::pair{ "GET"sv, entity + "/identifier/{identifier}" },
+          std::pair{ "GET"sv, entity + "/customer/code/{code}" }, std::pair{ "GET"sv, entity + "/facility/id/{id}" },
+          std::pair{ "GET"sv, entity + "/count/references/{id}" }, std::pair{ "GET"sv, entity + "/history/summary/{id}" },
+          std::pair{ "GET"sv, entity + "/history/document/{id}" },
+          std::pair{ "GET"sv, entity + "/{property}/between/{start}/{end}" } } )
+      {
+        r.add( method, path, []( Counter& counter, auto&& )
+        {
+          ++counter.routed;
+          return true;
+        } );
+      }
+    }
+  }
+
+  std::vector<Request> requests()
+  {
+    std::vector<Request> result;
+    result.reserve( 260 );
+    for ( auto i = 0; i < 20; ++i )
+    {
+      auto entity = "entity"s + std::to_string( i );
+      result.emplace_back( "POST"sv, entity + "/" );
+      result.emplace_back( "GET"sv, entity + "/" );
+      result.emplace_back( "GET"sv, entity + "/id/6230f3069e7c9be9ff4b78a1" );
+      result.emplace_back( "PUT"sv, entity + "/id/6230f3069e7c9be9ff4b78a1" );
+      result.emplace_back( "GET"sv, entity + "/identifier/Test Identifier" );
+      result.emplace_back( "GET"sv, entity + "/customer/code/int-test" );
+      result.emplace_back( "GET"sv, entity + "/facility/id/6230f3069e7c9be9ff4b78a1" );
+      result.emplace_back( "GET"sv, entity + "/history/summary/6230f3069e7c9be9ff4b78a1" );
+      result.emplace_back( "GET"sv, entity + "/history/document/6230f3069e7c9be9ff4b78a1" );
+      result.emplace_back( "GET"sv, entity + "/count/references/6230f3069e7c9be9ff4b78a1" );
+      result.emplace_back( "GET"sv, entity + "/created/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z" );
+      result.emplace_back( "GET"sv, entity + "/modified/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z" );
+      result.emplace_back( "DELETE"sv, entity + "/id/6230f3069e7c9be9ff4b78a1" );
+    }
+    return result;
+  }
+
+  // Route on `threads` pinned threads for the duration, returning requests per second.
+  // Each thread times itself, so threads finishing their last pass late do not skew the rate.
+  template <typename Router>
+  double run( const Router& r, const std::vector<Request>& reqs, const std::vector<int>& cores,
+      std::size_t threads, std::chrono::milliseconds duration )
+  {
+    auto counters = std::vector<Counter>( threads );
+    auto stop = std::atomic_bool{ false };
+    auto start = std::barrier{ static_cast<std::ptrdiff_t>( threads + 1 ) };
+
+    auto pool = std::vector<std::thread>{};
+    pool.reserve( threads );
+    for ( std::size_t t = 0; t < threads; ++t )
+    {
+      pool.emplace_back( [&r, &reqs, &stop, &start, &counter = counters[t]]
+      {
+        start.arrive_and_wait();
+        const auto begin = std::chrono::steady_clock::now();
+        while ( !stop.load( std::memory_order_relaxed ) )
+        {
+          for ( auto&& req : reqs ) r.route( req.method, req.url, counter );
+        }
+        counter.seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+      } );
+      if ( !cores.empty() && !pin( pool.back(), cores[t % cores.size()] ) )
+      {
+        std::cerr << "Unable to pin thread " << t << " to CPU " << cores[t % cores.size()] << std::endl;
+      }
+    }
+
+    start.arrive_and_wait();
+    std::this_thread::sleep_for( duration );
+    stop.store( true, std::memory_order_relaxed );
+    for ( auto& t : pool ) t.join();
+
+    auto rate = 0.0;
+    for ( const auto& c : counters ) rate += static_cast<double>( c.routed ) / c.seconds;
+    return rate;
+  }
+
+  template <typename Router>
+  void measure( const Router& r, std::string_view label, std::size_t maxThreads, std::chrono::milliseconds duration )
+  {
+    const auto cores = cpus();
+    const auto reqs = requests();
+
+    std::cout << label << std::endl;
+    std::cout << std::setw( 8 ) << "threads" << std::setw( 16 ) << "million req/s" << std::setw( 16 )
+      << "per thread" << std::setw( 12 ) << "efficiency" << std::endl;
+
+    auto single = 0.0;
+    for ( std::size_t threads = 1; threads <= maxThreads; ++threads )
+    {
+      const auto rate = run( r, reqs, cores, threads, duration ) / 1'000'000.0;
+      if ( threads == 1 ) single = rate;
+      std::cout << std::setw( 8 ) << threads << std::fixed << std::setprecision( 3 )
+        << std::setw( 16 ) << rate << std::setw( 16 ) << ( rate / static_cast<double>( threads ) )
+        << std::setw( 11 ) << std::setprecision( 1 ) << ( 100.0 * rate / ( single * static_cast<double>( threads ) ) ) << '%'
+        << std::defaultfloat << std::endl;
+    }
+    std::cout << std::endl;
+  }
+}
+
+int main( int argc, char** argv )
+{
+  const auto cores = cpus();
+  const auto maxThreads = argc > 1 ? std::stoul( argv[1] ) : std::max<std::size_t>( 1, cores.size() );
+  const auto duration = std::chrono::milliseconds{ argc > 2 ? std::stol( argv[2] ) : 1000 };
+  std::cout << "Pinning up to " << maxThreads << " threads to " << cores.size() << " CPUs, "
+    << duration.count() << "ms per run" << std::endl << std::endl;
+
+  {
+    spt::http::router::HttpRouter<Counter&, bool> r;
+    configure( r );
+    measure( r, "HttpRouter"sv, maxThreads, duration );
+  }
+
+  {
+    using Router = spt::http::router::HttpRouter<Counter&, bool>;
+    auto r = Router::Builder{}.withMatchCache( 1024 ).build();
+    configure( r );
+    measure( r, "HttpRouter with match cache"sv, maxThreads, duration );
+  }
+
+  {
+    using Map = spt::http::router::HttpRouter<Counter&, bool>::MapType;
+    spt::http::router::HttpRouter<Counter&, bool, Map, std::function<bool( Counter&, Map&& )>, 32> r;
+    configure( r );
+    measure( r, "HttpRouter with memo"sv, maxThreads, duration );
+  }
+}
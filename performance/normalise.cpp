@@ -0,0 +1,107 @@
+//
+// Path normalisation benchmarks using Google Benchmark.  Measures the cost of
+// checking paths that are already normal, which is the common case, against
+// rewriting paths that are not, and the cost added to routing.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <string>
+#include <vector>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+  struct Request
+  {
+    int routed{ 0 };
+  };
+
+  using Router = spt::http::router::HttpRouter<Request&, bool>;
+
+  constexpr auto Clean = std::array{
+      "/device/sensor/"sv,
+      "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv,
+      "/device/sensor/created/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z"sv,
+      "/device/file/reports/2022/03/summary.pdf"sv,
+  };
+
+  constexpr auto Dirty = std::array{
+      "//device//sensor/"sv,
+      "/device/sensor/id/%36230f3069e7c9be9ff4b78a1"sv,
+      "/device/./sensor/created/between/2022-03-14T20:11:50.620Z/../2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z"sv,
+      "http://example.com/device/file/reports/2022/03/summary.pdf"sv,
+  };
+
+  bool handle( Request& request, Router::MapType&& )
+  {
+    ++request.routed;
+    return true;
+  }
+
+  void normalise( benchmark::State& state, bool clean )
+  {
+    const auto& paths = clean ? Clean : Dirty;
+    auto buffer = std::array<char, 256>{};
+    std::size_t i = 0;
+    std::size_t bytes = 0;
+    for ( auto _ : state )
+    {
+      const auto& path = paths[i++ % paths.size()];
+      auto result = spt::util::normalise( path, buffer );
+      benchmark::DoNotOptimize( result );
+      bytes += path.size();
+    }
+    state.SetItemsProcessed( state.iterations() );
+    state.SetBytesProcessed( static_cast<std::int64_t>( bytes ) );
+  }
+
+  // Clean paths of increasing length, to show the cost per byte of the vectorised check
+  void length( benchmark::State& state )
+  {
+    auto path = "/"s;
+    while ( path.size() < static_cast<std::size_t>( state.range( 0 ) ) ) path.append( "segment/" );
+    path.resize( static_cast<std::size_t>( state.range( 0 ) ) );
+
+    auto buffer = std::string{};
+    for ( auto _ : state )
+    {
+      auto result = spt::util::normalise( path, buffer );
+      benchmark::DoNotOptimize( result );
+    }
+    state.SetBytesProcessed( static_cast<std::int64_t>( state.iterations() * path.size() ) );
+  }
+
+  void route( benchmark::State& state, bool normalising, bool clean )
+  {
+    Router router{ std::nullopt, std::nullopt, std::nullopt, 0, normalising };
+    router.add( "GET"sv, "/device/sensor/"sv, &handle );
+    router.add( "GET"sv, "/device/sensor/id/{id}"sv, &handle );
+    router.add( "GET"sv, "/device/sensor/{property}/between/{start}/{end}"sv, &handle );
+    router.add( "GET"sv, "/device/file/*"sv, &handle );
+
+    const auto& paths = clean ? Clean : Dirty;
+    auto request = Request{};
+    std::size_t i = 0;
+    for ( auto _ : state )
+    {
+      auto response = router.route( "GET"sv, paths[i++ % paths.size()], request );
+      benchmark::DoNotOptimize( response );
+    }
+    state.SetItemsProcessed( state.iterations() );
+    state.counters["routed"] = request.routed;
+  }
+}
+
+BENCHMARK_CAPTURE( normalise, clean, true );
+BENCHMARK_CAPTURE( normalise, dirty, false );
+BENCHMARK( length )->ArgName( "bytes" )->RangeMultiplier( 4 )->Range( 16, 4096 );
+BENCHMARK_CAPTURE( route, clean_plain, false, true );
+BENCHMARK_CAPTURE( route, clean_normalised, true, true );
+BENCHMARK_CAPTURE( route, dirty_normalised, true, false );
+
+BENCHMARK_MAIN();
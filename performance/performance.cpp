@@ -12,7 +12,7 @@
 using namespace std::string_literals;
 using namespace std::string_view_literals;
 
-int main()
+namespace
 {
   struct UserData
   {
@@ -31,137 +31,186 @@ int main()
     std::string url;
   };
 
-  spt::http::router::HttpRouter<UserData &, bool> r;
-  auto method = "GET"sv;
-  for ( auto i = 0; i < 20; ++i )
+  // Number of requests routed together in batch mode, as from a pipelined connection
+  constexpr std::size_t BatchSize = 16;
+
+  template <typename Router>
+  void measure( const Router& r, const std::vector<Request>& requests, std::string_view label )
   {
-    auto entity = "entity"s + std::to_string( i );
-    r.add( "POST"sv, entity + "/", []( UserData& data, auto )
-    {
-      ++data.routed;
-      return true;
-    } );
-    r.add( method, entity + "/", []( UserData& data, auto )
-    {
-      ++data.routed;
-      return true;
-    } );
-    r.add( "PUT"sv, entity + "/id/{id}", []( UserData& data, auto )
-    {
-      ++data.routed;
-      return true;
-    } );
-    r.add( "DELETE"sv, entity + "/id/{id}", []( UserData& data, auto )
-    {
-      ++data.routed;
-      return true;
-    } );
-    r.add( method, entity + "/id/{id}", []( UserData& data, auto )
-    {
-      ++data.routed;
-      return true;
-    } );
-    r.add( method, entity + "/identifier/{identifier}", []( UserData& data, auto )
-    {
-      ++data.routed;
-      return true;
-    } );
-    r.add( method, entity + "/customer/code/{code}", []( UserData& data, auto )
-    {
-      ++data.routed;
-      return true;
-    } );
-    r.add( method, entity + "/facility/id/{id}", []( UserData& data, auto )
     {
-      ++data.routed;
-      return true;
-    } );
-    r.add( method, entity + "/count/references/{id}", []( UserData& data, auto )
-    {
-      ++data.routed;
-      return true;
-    } );
-    r.add( method, entity + "/history/summary/{id}", []( UserData& data, auto )
-    {
-      ++data.routed;
-      return true;
-    } );
-    r.add( method, entity + "/history/document/{id}", []( UserData& data, auto )
-    {
-      ++data.routed;
-      return true;
-    } );
-    r.add( method, entity + "/{property}/between/{start}/{end}", []( UserData& data, auto )
+      UserData userData;
+      auto start = std::chrono::high_resolution_clock::now();
+      for ( auto i = 0; i < 1000000; ++i )
+      {
+        for ( auto&& req : requests )
+        {
+          r.route( req.method, req.url, userData );
+        }
+      }
+      auto stop = std::chrono::high_resolution_clock::now();
+      auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count();
+      std::cout << label << " single thread - [" << (double(userData.routed.load()) / (ms * 1000.0)) << " million req/sec]" << std::endl;
+      std::cout << "Total urls routed: " << userData.routed.load() << " in "
+        << ms/1000 << " seconds." << std::endl << std::endl;
+    }
+
+    if constexpr ( requires { r.routeBatch( std::span<const spt::http::router::RouteInput>{}, std::span<std::optional<bool>>{}, std::declval<UserData&>() ); } )
     {
-      ++data.routed;
-      return true;
-    } );
-  }
+      auto inputs = std::vector<spt::http::router::RouteInput>{};
+      inputs.reserve( requests.size() );
+      for ( auto&& req : requests ) inputs.push_back( { req.method, req.url } );
+      auto responses = std::vector<std::optional<bool>>( inputs.size() );
 
-  std::vector<Request> requests;
-  requests.reserve( 1000 );
-  for ( auto i = 0; i < 20; ++i )
-  {
-    auto entity = "entity"s + std::to_string( i );
-    requests.emplace_back( "POST"sv, entity + "/" );
-    requests.emplace_back( method, entity + "/" );
-    requests.emplace_back( method, entity + "/id/6230f3069e7c9be9ff4b78a1" );
-    requests.emplace_back( "PUT"sv, entity + "/id/6230f3069e7c9be9ff4b78a1" );
-    requests.emplace_back( method, entity + "/identifier/Test Identifier" );
-    requests.emplace_back( method, entity + "/customer/code/int-test" );
-    requests.emplace_back( method, entity + "/facility/id/6230f3069e7c9be9ff4b78a1" );
-    requests.emplace_back( method, entity + "/history/summary/6230f3069e7c9be9ff4b78a1" );
-    requests.emplace_back( method, entity + "/history/document/6230f3069e7c9be9ff4b78a1" );
-    requests.emplace_back( method, entity + "/count/references/6230f3069e7c9be9ff4b78a1" );
-    requests.emplace_back( method, entity + "/created/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z" );
-    requests.emplace_back( method, entity + "/modified/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z" );
-    requests.emplace_back( "DELETE"sv, entity + "/id/6230f3069e7c9be9ff4b78a1" );
-  }
+      UserData userData;
+      auto start = std::chrono::high_resolution_clock::now();
+      for ( auto i = 0; i < 1000000; ++i )
+      {
+        for ( std::size_t offset = 0; offset < inputs.size(); offset += BatchSize )
+        {
+          const auto count = std::min( BatchSize, inputs.size() - offset );
+          r.routeBatch( std::span{ inputs }.subspan( offset, count ), std::span{ responses }.subspan( offset, count ), userData );
+        }
+      }
+      auto stop = std::chrono::high_resolution_clock::now();
+      auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count();
+      std::cout << label << " single thread batches of " << BatchSize << " - [" << (double(userData.routed.load()) / (ms * 1000.0)) << " million req/sec]" << std::endl;
+      std::cout << "Total urls routed: " << userData.routed.load() << " in "
+        << ms/1000 << " seconds." << std::endl << std::endl;
+    }
 
-  {
-    UserData userData;
-    auto start = std::chrono::high_resolution_clock::now();
-    for ( auto i = 0; i < 1000000; ++i )
     {
-      for ( auto&& req : requests )
+      UserData userData;
+      auto start = std::chrono::high_resolution_clock::now();
+      std::vector<std::thread> v;
+      v.reserve( 10 );
+      for ( auto i = 0; i < 10; ++i )
+      {
+        v.emplace_back( [&requests,&userData, &r]{
+          for ( auto i = 0; i < 100000; ++i )
+          {
+            for ( auto&& req : requests )
+            {
+              r.route( req.method, req.url, userData );
+            }
+          }
+        } );
+      }
+
+      for ( auto&& t : v )
       {
-        r.route( req.method, req.url, userData );
+        if ( t.joinable() ) t.join();
       }
+
+      auto stop = std::chrono::high_resolution_clock::now();
+      auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count();
+      std::cout << label << " 10 threads - [" << (double(userData.routed.load()) / (ms * 1000.0)) << " million req/sec]" << std::endl;
+      std::cout << "Total urls routed: " << userData.routed.load() << " in "
+        << ms/1000 << " seconds." << std::endl << std::endl;
     }
-    auto stop = std::chrono::high_resolution_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count();
-    std::cout << "Single thread - [" << (double(userData.routed.load()) / (ms * 1000.0)) << " million req/sec]" << std::endl;
-    std::cout << "Total urls routed: " << userData.routed.load() << " in "
-      << ms/1000 << " seconds." << std::endl << std::endl;
   }
 
+  template <typename Map>
+  void run( std::string_view label )
   {
-    UserData userData;
-    auto start = std::chrono::high_resolution_clock::now();
-    std::vector<std::thread> v;
-    v.reserve( 10 );
-    for ( auto i = 0; i < 10; ++i )
+    std::cout << "Parameter map: " << label << std::endl << std::endl;
+    spt::http::router::HttpRouter<UserData &, bool, Map> r;
+    auto method = "GET"sv;
+    for ( auto i = 0; i < 20; ++i )
     {
-      v.emplace_back( [&requests,&userData, &r]{
-        for ( auto i = 0; i < 100000; ++i )
-        {
-          for ( auto&& req : requests )
-          {
-            r.route( req.method, req.url, userData );
-          }
-        }
+      auto entity = "entity"s + std::to_string( i );
+      r.add( "POST"sv, entity + "/", []( UserData& data, auto )
+      {
+        ++data.routed;
+        return true;
+      } );
+      r.add( method, entity + "/", []( UserData& data, auto )
+      {
+        ++data.routed;
+        return true;
+      } );
+      r.add( "PUT"sv, entity + "/id/{id}", []( UserData& data, auto )
+      {
+        ++data.routed;
+        return true;
+      } );
+      r.add( "DELETE"sv, entity + "/id/{id}", []( UserData& data, auto )
+      {
+        ++data.routed;
+        return true;
+      } );
+      r.add( method, entity + "/id/{id}", []( UserData& data, auto )
+      {
+        ++data.routed;
+        return true;
+      } );
+      r.add( method, entity + "/identifier/{identifier}", []( UserData& data, auto )
+      {
+        ++data.routed;
+        return true;
+      } );
+      r.add( method, entity + "/customer/code/{code}", []( UserData& data, auto )
+      {
+        ++data.routed;
+        return true;
+      } );
+      r.add( method, entity + "/facility/id/{id}", []( UserData& data, auto )
+      {
+        ++data.routed;
+        return true;
+      } );
+      r.add( method, entity + "/count/references/{id}", []( UserData& data, auto )
+      {
+        ++data.routed;
+        return true;
+      } );
+      r.add( method, entity + "/history/summary/{id}", []( UserData& data, auto )
+      {
+        ++data.routed;
+        return true;
+      } );
+      r.add( method, entity + "/history/document/{id}", []( UserData& data, auto )
+      {
+        ++data.routed;
+        return true;
+      } );
+      r.add( method, entity + "/{property}/between/{start}/{end}", []( UserData& data, auto )
+      {
+        ++data.routed;
+        return true;
       } );
     }
 
-    for ( auto&& t : v )
-    {
-      if ( t.joinable() ) t.join();
+    std::vector<Request> requests;
+    requests.reserve( 1000 );
+    for ( auto i = 0; i < 20; ++i )
+    {
+      auto entity = "entity"s + std::to_string( i );
+      requests.emplace_back( "POST"sv, entity + "/" );
+      requests.emplace_back( method, entity + "/" );
+      requests.emplace_back( method, entity + "/id/6230f3069e7c9be9ff4b78a1" );
+      requests.emplace_back( "PUT"sv, entity + "/id/6230f3069e7c9be9ff4b78a1" );
+      requests.emplace_back( method, entity + "/identifier/Test Identifier" );
+      requests.emplace_back( method, entity + "/customer/code/int-test" );
+      requests.emplace_back( method, entity + "/facility/id/6230f3069e7c9be9ff4b78a1" );
+      requests.emplace_back( method, entity + "/history/summary/6230f3069e7c9be9ff4b78a1" );
+      requests.emplace_back( method, entity + "/history/document/6230f3069e7c9be9ff4b78a1" );
+      requests.emplace_back( method, entity + "/count/references/6230f3069e7c9be9ff4b78a1" );
+      requests.emplace_back( method, entity + "/created/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z" );
+      requests.emplace_back( method, entity + "/modified/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z" );
+      requests.emplace_back( "DELETE"sv, entity + "/id/6230f3069e7c9be9ff4b78a1" );
     }
 
-    auto stop = std::chrono::high_resolution_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count();
-    std::cout << "10 threads - [" << (double(userData.routed.load()) / (ms * 1000.0)) << " million req/sec]" << std::endl;
-    std::cout << "Total urls routed: " << userData.routed.load() << " in "
-      << ms/1000 << " seconds." << std::endl << std::endl;
+    measure( r, requests, "HttpRouter"sv );
+    measure( r.compile(), requests, "CompiledRouter"sv );
   }
 }
+
+int main()
+{
+#ifdef HAS_BOOST
+  run<boost::container::flat_map<std::string_view, std::string_view>>( "boost::container::flat_map"sv );
+#else
+  run<std::map<std::string_view, std::string_view>>( "std::map"sv );
+#endif
+  run<spt::http::router::InlineParams<4>>( "spt::http::router::InlineParams"sv );
+}
@@ -0,0 +1,129 @@
+//
+// Regular expression constraint benchmarks using Google Benchmark.  Compares
+// the automata the router compiles patterns to with std::regex, for matching
+// alone and for routing with a constrained parameter.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <regex>
+#include <string>
+#include <vector>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+  struct Request
+  {
+    int routed{ 0 };
+  };
+
+  using Router = spt::http::router::HttpRouter<Request&, bool>;
+
+  struct Pattern
+  {
+    std::string_view expression;
+    std::array<std::string_view, 4> matching;
+    std::array<std::string_view, 4> other;
+  };
+
+  constexpr auto Patterns = std::array{
+      Pattern{ "\\d{4}-\\d{2}-\\d{2}"sv,
+          { "2022-03-14"sv, "1999-12-31"sv, "2038-01-19"sv, "0001-01-01"sv },
+          { "2022-3-14"sv, "20220314"sv, "2022-03-14T20:11:50.620Z"sv, "created"sv } },
+      Pattern{ "[A-Z]{3}-\\d+"sv,
+          { "ABC-1"sv, "XYZ-42"sv, "SKU-0123456789"sv, "ORD-2022"sv },
+          { "AB-1"sv, "abc-42"sv, "SKU-"sv, "6230f3069e7c9be9ff4b78a1"sv } },
+      Pattern{ "(?:[a-z0-9_-]+\\.)+(json|csv|xml)"sv,
+          { "report.json"sv, "sensor.2022_03.csv"sv, "a.b.c.xml"sv, "summary-2022.json"sv },
+          { "report.pdf"sv, "report"sv, ".json"sv, "Report.JSON"sv } },
+  };
+
+  bool handle( Request& request, Router::MapType&& )
+  {
+    ++request.routed;
+    return true;
+  }
+
+  template <typename Match>
+  void run( benchmark::State& state, Match&& match, bool matching )
+  {
+    const auto& p = Patterns[static_cast<std::size_t>( state.range( 0 ) )];
+    const auto& values = matching ? p.matching : p.other;
+    std::size_t i = 0;
+    for ( auto _ : state )
+    {
+      auto result = match( values[i++ % values.size()] );
+      benchmark::DoNotOptimize( result );
+    }
+    state.SetItemsProcessed( state.iterations() );
+    state.SetLabel( std::string{ p.expression } );
+  }
+
+  void dfa( benchmark::State& state, bool matching )
+  {
+    const auto automaton = spt::http::router::impl::Dfa::compile( Patterns[static_cast<std::size_t>( state.range( 0 ) )].expression );
+    run( state, [&automaton]( std::string_view value ) { return automaton.match( value ); }, matching );
+  }
+
+  void regex( benchmark::State& state, bool matching )
+  {
+    const auto re = std::regex{ std::string{ Patterns[static_cast<std::size_t>( state.range( 0 ) )].expression } };
+    run( state, [&re]( std::string_view value ) { return std::regex_match( std::cbegin( value ), std::cend( value ), re ); }, matching );
+  }
+
+  // Route with the constraint in the path, against a plain parameter validated by the handler
+  void route( benchmark::State& state, bool constrained )
+  {
+    const auto& p = Patterns[static_cast<std::size_t>( state.range( 0 ) )];
+    const auto re = std::regex{ std::string{ p.expression } };
+
+    Router router;
+    if ( constrained )
+    {
+      router.add( "GET"sv, "/report/{value:"s.append( p.expression ).append( "}" ), &handle );
+    }
+    else
+    {
+      router.add( "GET"sv, "/report/{value}"sv, [&re]( Request& request, Router::MapType&& args )
+      {
+        const auto& value = args["value"];
+        if ( !std::regex_match( std::cbegin( value ), std::cend( value ), re ) ) return false;
+        return handle( request, std::move( args ) );
+      } );
+    }
+
+    auto paths = std::vector<std::string>{};
+    for ( const auto v : p.matching ) paths.push_back( "/report/"s.append( v ) );
+    for ( const auto v : p.other ) paths.push_back( "/report/"s.append( v ) );
+
+    auto request = Request{};
+    std::size_t i = 0;
+    for ( auto _ : state )
+    {
+      auto response = router.route( "GET"sv, paths[i++ % paths.size()], request );
+      benchmark::DoNotOptimize( response );
+    }
+    state.SetItemsProcessed( state.iterations() );
+    state.SetLabel( std::string{ p.expression } );
+    state.counters["routed"] = request.routed;
+  }
+
+  void patterns( benchmark::internal::Benchmark* b )
+  {
+    b->ArgName( "pattern" )->DenseRange( 0, static_cast<int>( Patterns.size() ) - 1 );
+  }
+}
+
+BENCHMARK_CAPTURE( dfa, match, true )->Apply( patterns );
+BENCHMARK_CAPTURE( dfa, mismatch, false )->Apply( patterns );
+BENCHMARK_CAPTURE( regex, match, true )->Apply( patterns );
+BENCHMARK_CAPTURE( regex, mismatch, false )->Apply( patterns );
+BENCHMARK_CAPTURE( route, constrained, true )->Apply( patterns );
+BENCHMARK_CAPTURE( route, handler_regex, false )->Apply( patterns );
+
+BENCHMARK_MAIN();
@@ -0,0 +1,284 @@
+//
+// Replay a corpus of requests, for instance extracted from access logs, against
+// a router built from a routes file.
+//
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+  // Read only memory mapping of a file
+  class MappedFile
+  {
+  public:
+    explicit MappedFile( const char* name )
+    {
+      const auto fd = ::open( name, O_RDONLY );
+      if ( fd < 0 ) throw std::runtime_error{ "Unable to open "s + name + ": " + std::strerror( errno ) };
+
+      struct stat st{};
+      if ( ::fstat( fd, &st ) != 0 )
+      {
+        ::close( fd );
+        throw std::runtime_error{ "Unable to stat "s + name + ": " + std::strerror( errno ) };
+      }
+
+      size = static_cast<std::size_t>( st.st_size );
+      if ( size > 0 )
+      {
+        data = ::mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if ( data == MAP_FAILED )
+        {
+          ::close( fd );
+          throw std::runtime_error{ "Unable to map "s + name + ": " + std::strerror( errno ) };
+        }
+        ::madvise( data, size, MADV_SEQUENTIAL );
+      }
+      ::close( fd );
+    }
+
+    ~MappedFile()
+    {
+      if ( size > 0 ) ::munmap( data, size );
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] std::string_view view() const
+    {
+      return size > 0 ? std::string_view{ static_cast<const char*>( data ), size } : std::string_view{};
+    }
+
+  private:
+    void* data{ nullptr };
+    std::size_t size{ 0 };
+  };
+
+  // Split `METHOD path ...` lines into views of the mapped file.  Blank lines and
+  // lines starting with `#` are skipped, a leading `"` (as in the request field
+  // of the nginx combined log format) and any query string are dropped.
+  std::vector<spt::http::router::RouteInput> parse( std::string_view text )
+  {
+    auto result = std::vector<spt::http::router::RouteInput>{};
+    result.reserve( static_cast<std::size_t>( std::count( text.begin(), text.end(), '\n' ) ) + 1 );
+
+    constexpr auto blank = " \t\r"sv;
+    while ( !text.empty() )
+    {
+      const auto eol = text.find( '\n' );
+      auto line = text.substr( 0, eol );
+      text = eol == std::string_view::npos ? std::string_view{} : text.substr( eol + 1 );
+
+      line.remove_prefix( std::min( line.find_first_not_of( blank ), line.size() ) );
+      if ( line.starts_with( '"' ) ) line.remove_prefix( 1 );
+      if ( line.empty() || line.starts_with( '#' ) ) continue;
+
+      const auto ms = line.find_first_of( blank );
+      if ( ms == std::string_view::npos ) continue;
+      const auto method = line.substr( 0, ms );
+      line.remove_prefix( ms );
+      line.remove_prefix( std::min( line.find_first_not_of( blank ), line.size() ) );
+      auto path = line.substr( 0, line.find_first_of( blank ) );
+      path = path.substr( 0, path.find( '?' ) );
+      if ( path.empty() ) continue;
+
+      result.push_back( { method, path } );
+    }
+
+    return result;
+  }
+
+  constexpr auto NotFound = std::numeric_limits<std::uint32_t>::max();
+  constexpr auto NotAllowed = NotFound - 1;
+
+  // Each thread has its own counters, padded so that threads do not share cache lines
+  struct alignas( 64 ) Worker
+  {
+    std::uint64_t routed{ 0 };
+    std::vector<std::uint64_t> matched;
+    std::vector<std::uint32_t> latencies;
+  };
+
+  using Router = spt::http::router::HttpRouter<Worker&, std::uint32_t>;
+
+  struct Result
+  {
+    double seconds{ 0 };
+    std::uint64_t requests{ 0 };
+    std::vector<std::uint32_t> latencies;
+    std::vector<std::uint64_t> matched;
+  };
+
+  void record( Worker& worker, std::optional<std::uint32_t> response, std::size_t routes )
+  {
+    const auto r = response.value_or( NotFound );
+    ++worker.matched[r == NotFound ? routes : r == NotAllowed ? routes + 1 : r];
+  }
+
+  // Each thread replays the corpus `passes` times without timing individual calls
+  // for the throughput, then once more timing each call for the latency.
+  Result replay( const Router& router, const std::vector<spt::http::router::RouteInput>& corpus,
+      std::size_t routes, std::size_t threads, std::size_t passes )
+  {
+    auto workers = std::vector<Worker>( threads );
+    for ( auto& w : workers )
+    {
+      w.matched.resize( routes + 2 );
+      w.latencies.reserve( corpus.size() );
+    }
+
+    auto run = [&]( auto&& fn )
+    {
+      auto pool = std::vector<std::thread>{};
+      pool.reserve( threads );
+      const auto start = std::chrono::steady_clock::now();
+      for ( std::size_t t = 0; t < threads; ++t ) pool.emplace_back( fn, std::ref( workers[t] ) );
+      for ( auto& t : pool ) t.join();
+      return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    };
+
+    auto result = Result{};
+    result.seconds = run( [&]( Worker& worker )
+    {
+      for ( std::size_t p = 0; p < passes; ++p )
+      {
+        for ( const auto& r : corpus ) router.route( r.method, r.path, worker );
+      }
+    } );
+    result.requests = passes * threads * corpus.size();
+
+    for ( auto& w : workers ) w.routed = 0;
+    run( [&]( Worker& worker )
+    {
+      for ( const auto& r : corpus )
+      {
+        const auto start = std::chrono::steady_clock::now();
+        const auto response = router.route( r.method, r.path, worker );
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        worker.latencies.push_back( static_cast<std::uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>( elapsed ).count() ) );
+        record( worker, response, routes );
+      }
+    } );
+
+    result.matched.resize( routes + 2 );
+    for ( auto& w : workers )
+    {
+      result.latencies.insert( result.latencies.end(), w.latencies.begin(), w.latencies.end() );
+      for ( std::size_t i = 0; i < w.matched.size(); ++i ) result.matched[i] += w.matched[i];
+    }
+    return result;
+  }
+
+  std::uint32_t percentile( std::vector<std::uint32_t>& values, double p )
+  {
+    if ( values.empty() ) return 0;
+    const auto n = std::min( values.size() - 1, static_cast<std::size_t>( p * static_cast<double>( values.size() ) ) );
+    std::nth_element( values.begin(), values.begin() + static_cast<std::ptrdiff_t>( n ), values.end() );
+    return values[n];
+  }
+
+  void report( std::string_view label, Result& result )
+  {
+    std::cout << label << " - [" << ( static_cast<double>( result.requests ) / ( result.seconds * 1'000'000.0 ) )
+      << " million req/sec] " << result.requests << " requests in " << result.seconds << " seconds." << std::endl;
+    std::cout << "Latency p50 " << percentile( result.latencies, 0.5 ) << "ns, p99 " << percentile( result.latencies, 0.99 )
+      << "ns, p999 " << percentile( result.latencies, 0.999 ) << "ns" << std::endl << std::endl;
+  }
+
+  void matches( const std::vector<spt::http::router::RouteInput>& routes, const Result& result )
+  {
+    auto order = std::vector<std::size_t>( result.matched.size() );
+    for ( std::size_t i = 0; i < order.size(); ++i ) order[i] = i;
+    std::stable_sort( order.begin(), order.end(), [&result]( std::size_t a, std::size_t b )
+    {
+      return result.matched[a] > result.matched[b];
+    } );
+
+    auto total = std::uint64_t{ 0 };
+    for ( const auto m : result.matched ) total += m;
+
+    std::cout << "Matched routes (one replay of the corpus):" << std::endl;
+    for ( const auto i : order )
+    {
+      if ( result.matched[i] == 0 ) continue;
+      std::cout << std::setw( 12 ) << result.matched[i] << std::setw( 8 ) << std::fixed << std::setprecision( 2 )
+        << ( 100.0 * static_cast<double>( result.matched[i] ) / static_cast<double>( total ) ) << "%  ";
+      if ( i == routes.size() ) std::cout << "404 Not Found";
+      else if ( i == routes.size() + 1 ) std::cout << "405 Method Not Allowed";
+      else std::cout << routes[i].method << ' ' << routes[i].path;
+      std::cout << std::defaultfloat << std::endl;
+    }
+  }
+}
+
+int main( int argc, char** argv )
+{
+  if ( argc < 3 )
+  {
+    std::cerr << "Usage: " << argv[0] << " <routes file> <corpus file> [threads] [passes]" << std::endl;
+    return 1;
+  }
+
+  try
+  {
+    const auto routesFile = MappedFile{ argv[1] };
+    const auto corpusFile = MappedFile{ argv[2] };
+    const auto threads = argc > 3 ? std::stoul( argv[3] ) : std::max( 1u, std::thread::hardware_concurrency() );
+    const auto passes = argc > 4 ? std::stoul( argv[4] ) : 10ul;
+
+    const auto routes = parse( routesFile.view() );
+    auto router = Router::Builder{}.
+      withNotFound( []( Worker&, auto&& ) { return NotFound; } ).
+      withMethodNotAllowed( []( Worker&, auto&& ) { return NotAllowed; } ).
+      build();
+    for ( std::uint32_t i = 0; i < routes.size(); ++i )
+    {
+      router.add( routes[i].method, routes[i].path, [i]( Worker& worker, auto&& )
+      {
+        ++worker.routed;
+        return i;
+      } );
+    }
+
+    const auto corpus = parse( corpusFile.view() );
+    std::cout << "Routes: " << routes.size() << ", corpus: " << corpus.size() << " requests" << std::endl << std::endl;
+    if ( corpus.empty() ) return 0;
+
+    auto single = replay( router, corpus, routes.size(), 1, passes );
+    report( "Single thread", single );
+
+    if ( threads > 1 )
+    {
+      auto multi = replay( router, corpus, routes.size(), threads, passes );
+      report( std::to_string( threads ) + " threads", multi );
+    }
+
+    matches( routes, single );
+  }
+  catch ( const std::exception& e )
+  {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
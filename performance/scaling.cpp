@@ -0,0 +1,265 @@
+//
+// Route table scaling benchmarks using Google Benchmark.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+  struct Request
+  {
+    int routed{ 0 };
+  };
+
+  using Router = spt::http::router::HttpRouter<Request&, bool>;
+
+  struct Input
+  {
+    std::string method;
+    std::string path;
+  };
+
+  // Registrations for each resource: 3 static, 4 parametrised and 1 wildcard
+  struct Template
+  {
+    std::string_view method;
+    std::string_view route;
+  };
+
+  constexpr auto Templates = std::array{
+      Template{ "GET"sv, ""sv },
+      Template{ "POST"sv, ""sv },
+      Template{ "GET"sv, "/search/recent"sv },
+      Template{ "GET"sv, "/{id}"sv },
+      Template{ "PUT"sv, "/{id}"sv },
+      Template{ "GET"sv, "/{id}/history/{version}"sv },
+      Template{ "GET"sv, "/{property}/between/{start}/{end}"sv },
+      Template{ "GET"sv, "/files/*"sv },
+  };
+
+  // Request paths matching each template
+  constexpr auto Samples = std::array{
+      ""sv,
+      ""sv,
+      "/search/recent"sv,
+      "/6230f3069e7c9be9ff4b78a1"sv,
+      "/6230f3069e7c9be9ff4b78a1"sv,
+      "/6230f3069e7c9be9ff4b78a1/history/42"sv,
+      "/created/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z"sv,
+      "/files/reports/2022/03/summary.pdf"sv,
+  };
+
+  constexpr auto Resources = std::array{
+      "users"sv, "accounts"sv, "orders"sv, "invoices"sv, "products"sv, "devices"sv, "sites"sv, "documents"sv };
+
+  constexpr std::size_t Requests = 1024;
+
+  std::string resource( std::size_t i )
+  {
+    auto r = std::string{ Resources[i % Resources.size()] };
+    return "/api/v"s.append( std::to_string( 1 + i % 3 ) ).append( "/" ).append( r ).append( std::to_string( i / Resources.size() ) );
+  }
+
+  bool handle( Request& request, Router::MapType&& )
+  {
+    ++request.routed;
+    return true;
+  }
+
+  // The configured paths for a table of the size, the specs reference these
+  std::vector<std::string> paths( std::size_t size )
+  {
+    auto result = std::vector<std::string>{};
+    result.reserve( size );
+    for ( std::size_t i = 0; result.size() < size; ++i )
+    {
+      const auto base = resource( i );
+      for ( std::size_t t = 0; t < Templates.size() && result.size() < size; ++t )
+      {
+        result.push_back( base + std::string{ Templates[t].route } );
+      }
+    }
+    return result;
+  }
+
+  std::vector<Router::RouteSpec> specs( const std::vector<std::string>& paths )
+  {
+    auto result = std::vector<Router::RouteSpec>{};
+    result.reserve( paths.size() );
+    for ( std::size_t i = 0; i < paths.size(); ++i )
+    {
+      result.push_back( { Templates[i % Templates.size()].method, paths[i], &handle } );
+    }
+    return result;
+  }
+
+  struct Fixture
+  {
+    explicit Fixture( std::size_t size ) : configured{ paths( size ) }
+    {
+      auto routes = specs( configured );
+      router.addAll( routes );
+
+      // Fixed seed so that every run (and release) routes the same requests
+      auto engine = std::mt19937_64{ size };
+      auto pick = std::uniform_int_distribution<std::size_t>{ 0, size - 1 };
+      hits.reserve( Requests );
+      notFound.reserve( Requests );
+      notAllowed.reserve( Requests );
+      for ( std::size_t i = 0; i < Requests; ++i )
+      {
+        const auto route = pick( engine );
+        const auto base = resource( route / Templates.size() );
+        const auto t = route % Templates.size();
+        hits.push_back( { std::string{ Templates[t].method }, base + std::string{ Samples[t] } } );
+
+        // Half the misses fail after descending into the trie, half at the first segment
+        if ( i % 2 == 0 ) notFound.push_back( { "GET"s, base + "/6230f3069e7c9be9ff4b78a1/unknown"s } );
+        else notFound.push_back( { "GET"s, "/assets/"s + std::to_string( route ) + "/index.html"s } );
+
+        notAllowed.push_back( { "DELETE"s, base + std::string{ Samples[t] } } );
+      }
+    }
+
+    std::vector<std::string> configured;
+    Router router;
+    std::vector<Input> hits;
+    std::vector<Input> notFound;
+    std::vector<Input> notAllowed;
+  };
+
+  // Route tables are built once for each size
+  const Fixture& fixture( std::size_t size )
+  {
+    static auto fixtures = std::map<std::size_t, std::unique_ptr<Fixture>>{};
+    auto& f = fixtures[size];
+    if ( !f ) f = std::make_unique<Fixture>( size );
+    return *f;
+  }
+
+  enum class Kind { Hit, NotFound, NotAllowed };
+
+  const std::vector<Input>& inputs( const Fixture& f, Kind kind )
+  {
+    switch ( kind )
+    {
+    case Kind::Hit: return f.hits;
+    case Kind::NotFound: return f.notFound;
+    case Kind::NotAllowed: return f.notAllowed;
+    }
+    return f.hits;
+  }
+
+  void route( benchmark::State& state, Kind kind )
+  {
+    const auto& f = fixture( static_cast<std::size_t>( state.range( 0 ) ) );
+    const auto& requests = inputs( f, kind );
+    auto request = Request{};
+    std::size_t i = 0;
+    for ( auto _ : state )
+    {
+      const auto& input = requests[i++ % requests.size()];
+      auto response = f.router.route( input.method, input.path, request );
+      benchmark::DoNotOptimize( response );
+    }
+    state.SetItemsProcessed( state.iterations() );
+    state.counters["routed"] = request.routed;
+  }
+
+  void canRoute( benchmark::State& state, Kind kind )
+  {
+    const auto& f = fixture( static_cast<std::size_t>( state.range( 0 ) ) );
+    const auto& requests = inputs( f, kind );
+    std::size_t i = 0;
+    for ( auto _ : state )
+    {
+      const auto& input = requests[i++ % requests.size()];
+      auto result = f.router.canRoute( input.method, input.path );
+      benchmark::DoNotOptimize( result );
+    }
+    state.SetItemsProcessed( state.iterations() );
+  }
+
+  void sizes( benchmark::internal::Benchmark* b )
+  {
+    b->ArgName( "routes" )->RangeMultiplier( 10 )->Range( 10, 100'000 );
+  }
+
+  // Startup cost of configuring the routes one at a time
+  void add( benchmark::State& state )
+  {
+    const auto configured = paths( static_cast<std::size_t>( state.range( 0 ) ) );
+    for ( auto _ : state )
+    {
+      Router router;
+      for ( std::size_t i = 0; i < configured.size(); ++i )
+      {
+        router.add( Templates[i % Templates.size()].method, configured[i], &handle );
+      }
+      benchmark::DoNotOptimize( router );
+    }
+    state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+  }
+
+  // Startup cost of configuring the routes in bulk
+  void addAll( benchmark::State& state )
+  {
+    const auto configured = paths( static_cast<std::size_t>( state.range( 0 ) ) );
+    for ( auto _ : state )
+    {
+      state.PauseTiming();
+      auto routes = specs( configured );
+      state.ResumeTiming();
+
+      Router router;
+      router.addAll( routes );
+      benchmark::DoNotOptimize( router );
+    }
+    state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+  }
+}
+
+BENCHMARK_CAPTURE( route, hit, Kind::Hit )->Apply( sizes );
+BENCHMARK_CAPTURE( route, not_found, Kind::NotFound )->Apply( sizes );
+BENCHMARK_CAPTURE( route, method_not_allowed, Kind::NotAllowed )->Apply( sizes );
+BENCHMARK_CAPTURE( canRoute, hit, Kind::Hit )->Apply( sizes );
+BENCHMARK_CAPTURE( canRoute, not_found, Kind::NotFound )->Apply( sizes );
+BENCHMARK_CAPTURE( canRoute, method_not_allowed, Kind::NotAllowed )->Apply( sizes );
+// Adding 100k routes one at a time takes minutes
+BENCHMARK( add )->ArgName( "routes" )->Arg( 1'000 )->Arg( 10'000 )->Unit( benchmark::kMillisecond );
+BENCHMARK( addAll )->ArgName( "routes" )->Arg( 1'000 )->Arg( 10'000 )->Arg( 100'000 )->Unit( benchmark::kMillisecond );
+
+// Write JSON results to scaling.json unless an output file is specified, so
+// results can be kept and compared across releases.
+int main( int argc, char** argv )
+{
+  auto args = std::vector<char*>( argv, argv + argc );
+  auto out = "--benchmark_out=scaling.json"s;
+  auto format = "--benchmark_out_format=json"s;
+  if ( std::none_of( argv, argv + argc, []( const char* a ) { return std::strncmp( a, "--benchmark_out=", 16 ) == 0; } ) )
+  {
+    args.push_back( out.data() );
+    args.push_back( format.data() );
+  }
+
+  auto count = static_cast<int>( args.size() );
+  benchmark::Initialize( &count, args.data() );
+  if ( benchmark::ReportUnrecognizedArguments( count, args.data() ) ) return 1;
+  benchmark::AddCustomContext( "routes", "3/8 static, 4/8 parametrised, 1/8 wildcard" );
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,73 @@
+//
+// Compare the vectorised path segmenter with util::split
+//
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "../src/split.hpp"
+
+namespace
+{
+  std::string url( std::size_t size )
+  {
+    static constexpr std::string_view parts[] = { "device", "sensor", "id", "6230f3069e7c9be9ff4b78a1", "history", "json" };
+    std::string out;
+    for ( std::size_t i = 0; out.size() < size; ++i ) out.append( "/" ).append( parts[i % std::size( parts )] );
+    out.resize( size );
+    return out;
+  }
+
+  template <typename Function>
+  void measure( std::string_view label, std::string_view path, std::size_t iterations, Function&& function )
+  {
+    // Read through a volatile so the loop invariant path is segmented each iteration
+    const char* volatile data = path.data();
+    std::size_t checksum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for ( std::size_t i = 0; i < iterations; ++i ) checksum += function( std::string_view{ data, path.size() } );
+    auto stop = std::chrono::high_resolution_clock::now();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>( stop - start ).count();
+    std::cout << "  " << label << ": " << ( double( ns ) / iterations ) << " ns/path, "
+      << ( double( path.size() ) * iterations / ns ) << " GB/s (checksum " << checksum << ")" << std::endl;
+  }
+}
+
+int main()
+{
+  for ( std::size_t size : { 10, 50, 100, 250, 500, 1000, 2000 } )
+  {
+    const auto path = url( size );
+    const std::size_t iterations = 200'000'000 / ( size + 50 );
+    std::cout << "URL of " << size << " bytes" << std::endl;
+
+    auto views = std::array<std::string_view, 512>{};
+    auto offsets = std::array<spt::util::Segment, 512>{};
+
+    measure( "split vector", path, iterations, []( std::string_view p )
+    {
+      return spt::util::split<std::string_view>( p ).size();
+    } );
+
+    measure( "split buffer", path, iterations, [&views]( std::string_view p )
+    {
+      const auto count = spt::util::split( p, views );
+      return count + views[count / 2].size();
+    } );
+
+    measure( "segment views", path, iterations, [&views]( std::string_view p )
+    {
+      const auto count = spt::util::segment( p, views );
+      return count + views[count / 2].size();
+    } );
+
+    measure( "segment offsets", path, iterations, [&offsets]( std::string_view p )
+    {
+      const auto count = spt::util::segment( p, offsets );
+      return count + offsets[count / 2].size;
+    } );
+
+    std::cout << std::endl;
+  }
+}
@@ -0,0 +1,312 @@
+#pragma once
+
+#include "split.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace spt::http::router
+{
+  /// Counters for the match cache of a HttpRouter.
+  struct CacheStats
+  {
+    std::uint64_t hits{ 0 };
+    std::uint64_t misses{ 0 };
+    std::size_t size{ 0 };
+    std::size_t capacity{ 0 };
+  };
+
+  namespace impl
+  {
+    /**
+     * Next value for the generation of a route table.  Values are unique across
+     * all routers, so a generation identifies both a router and a version of its routes.
+     */
+    inline std::uint64_t nextGeneration() noexcept
+    {
+      static std::atomic<std::uint64_t> generation{ 0 };
+      return generation.fetch_add( 1, std::memory_order_relaxed ) + 1;
+    }
+
+    /**
+     * Bounded cache of the routes matched for request paths, split into shards
+     * each with its own lock and least recently used eviction.  A shard is picked
+     * by the hash of the path, so threads routing different paths rarely contend.
+     *
+     * Entries hold the index of the matched route and the offsets of the parameter
+     * values in the path, along with the generation of the route table they were
+     * resolved against.  Entries from an earlier generation are treated as misses
+     * and replaced, so modifying the table invalidates the cache without clearing it.
+     * Paths longer than `MaxPath`, or matching routes with more than `MaxParams`
+     * parameters, are not cached.  Memory is allocated once when created.
+     */
+    class MatchCache
+    {
+    public:
+      static constexpr std::size_t MaxPath = 128;
+      static constexpr std::size_t MaxParams = 8;
+      static constexpr auto npos = std::numeric_limits<std::uint32_t>::max();
+
+      /// The resolved route for a path.
+      struct Match
+      {
+        std::uint32_t route{ npos };
+        std::uint32_t wildcard{ npos };
+        std::uint32_t count{ 0 };
+        std::array<util::Segment, MaxParams> params{};
+      };
+
+      /**
+       * Create a cache with the specified total number of entries.
+       * @param capacity The maximum number of entries, split evenly across the shards.
+       */
+      explicit MatchCache( std::size_t capacity ) :
+          shards( std::bit_floor( std::clamp<std::size_t>( capacity / 16, 1, MaxShards ) ) )
+      {
+        const auto size = std::max<std::size_t>( 1, ( capacity + shards.size() - 1 ) / shards.size() );
+        for ( auto& shard : shards ) shard.reserve( size );
+      }
+
+      ~MatchCache() = default;
+      MatchCache(const MatchCache&) = delete;
+      MatchCache& operator=(const MatchCache&) = delete;
+
+      /**
+       * Look up the match for the path.
+       * @param path The request path.
+       * @param hash The hash of the path.
+       * @param generation The generation of the route table being routed against.
+       * @return The cached match, or `std::nullopt` if the path is not cached for the generation.
+       */
+      std::optional<Match> find( std::string_view path, std::uint64_t hash, std::uint64_t generation )
+      {
+        return shard( hash ).find( path, hash, generation );
+      }
+
+      /**
+       * Cache the match for the path, evicting the least recently used entry in
+       * the shard if full.
+       * @param path The request path.
+       * @param hash The hash of the path.
+       * @param generation The generation of the route table the match was resolved against.
+       * @param match The match to cache.
+       */
+      void insert( std::string_view path, std::uint64_t hash, std::uint64_t generation, const Match& match )
+      {
+        if ( path.size() > MaxPath || match.count > MaxParams ) return;
+        shard( hash ).insert( path, hash, generation, match );
+      }
+
+      [[nodiscard]] CacheStats stats() const
+      {
+        auto result = CacheStats{};
+        for ( const auto& s : shards )
+        {
+          auto lock = std::scoped_lock<std::mutex>{ s.mutex };
+          result.hits += s.hits;
+          result.misses += s.misses;
+          result.size += s.entries.size();
+          result.capacity += s.entries.capacity();
+        }
+        return result;
+      }
+
+    private:
+      static constexpr std::size_t MaxShards = 16;
+
+      struct Entry
+      {
+        std::uint64_t hash{ 0 };
+        std::uint64_t generation{ 0 };
+        Match match{};
+        std::uint32_t previous{ npos };
+        std::uint32_t next{ npos };
+        std::uint32_t chain{ npos };
+        std::uint32_t size{ 0 };
+        char path[MaxPath]{};
+
+        [[nodiscard]] bool is( std::string_view p, std::uint64_t h ) const
+        {
+          return hash == h && size == p.size() && std::memcmp( path, p.data(), p.size() ) == 0;
+        }
+      };
+
+      // Entries are linked in most recently used order, and chained per hash bucket
+      struct alignas( 64 ) Shard
+      {
+        void reserve( std::size_t size )
+        {
+          entries.reserve( size );
+          buckets.assign( std::bit_ceil( 2 * size ), npos );
+        }
+
+        std::optional<Match> find( std::string_view path, std::uint64_t hash, std::uint64_t generation )
+        {
+          auto lock = std::scoped_lock<std::mutex>{ mutex };
+          const auto idx = lookup( path, hash );
+          if ( idx == npos || entries[idx].generation != generation )
+          {
+            ++misses;
+            return std::nullopt;
+          }
+
+          ++hits;
+          unlink( idx );
+          link( idx );
+          return entries[idx].match;
+        }
+
+        void insert( std::string_view path, std::uint64_t hash, std::uint64_t generation, const Match& match )
+        {
+          auto lock = std::scoped_lock<std::mutex>{ mutex };
+          auto idx = lookup( path, hash );
+          if ( idx != npos ) unlink( idx );
+          else
+          {
+            if ( entries.size() < entries.capacity() )
+            {
+              idx = static_cast<std::uint32_t>( entries.size() );
+              entries.emplace_back();
+            }
+            else
+            {
+              idx = tail;
+              unlink( idx );
+              unchain( idx );
+            }
+
+            auto& entry = entries[idx];
+            entry.hash = hash;
+            entry.size = static_cast<std::uint32_t>( path.size() );
+            std::memcpy( entry.path, path.data(), path.size() );
+            auto& bucket = buckets[hash & ( buckets.size() - 1 )];
+            entry.chain = bucket;
+            bucket = idx;
+          }
+
+          entries[idx].generation = generation;
+          entries[idx].match = match;
+          link( idx );
+        }
+
+        [[nodiscard]] std::uint32_t lookup( std::string_view path, std::uint64_t hash ) const
+        {
+          auto idx = buckets[hash & ( buckets.size() - 1 )];
+          while ( idx != npos && !entries[idx].is( path, hash ) ) idx = entries[idx].chain;
+          return idx;
+        }
+
+        void link( std::uint32_t idx )
+        {
+          entries[idx].previous = npos;
+          entries[idx].next = head;
+          if ( head != npos ) entries[head].previous = idx;
+          head = idx;
+          if ( tail == npos ) tail = idx;
+        }
+
+        void unlink( std::uint32_t idx )
+        {
+          auto& entry = entries[idx];
+          if ( entry.previous != npos ) entries[entry.previous].next = entry.next;
+          else head = entry.next;
+          if ( entry.next != npos ) entries[entry.next].previous = entry.previous;
+          else tail = entry.previous;
+        }
+
+        void unchain( std::uint32_t idx )
+        {
+          auto* link = &buckets[entries[idx].hash & ( buckets.size() - 1 )];
+          while ( *link != idx ) link = &entries[*link].chain;
+          *link = entries[idx].chain;
+        }
+
+        std::vector<Entry> entries{};
+        std::vector<std::uint32_t> buckets{};
+        std::uint64_t hits{ 0 };
+        std::uint64_t misses{ 0 };
+        std::uint32_t head{ npos };
+        std::uint32_t tail{ npos };
+        mutable std::mutex mutex;
+      };
+
+      Shard& shard( std::uint64_t hash )
+      {
+        // High bits pick the shard, low bits the bucket within the shard
+        return shards[( hash >> 56 ) & ( shards.size() - 1 )];
+      }
+
+      std::vector<Shard> shards;
+    };
+
+    /**
+     * Small direct mapped memo of recent matches, intended to be held per thread
+     * so that lookups and updates need no synchronisation.  Entries carry the
+     * generation of the route table they were resolved against, and only match
+     * the same generation, so modifying the table invalidates the memo.
+     * @tparam Size The number of entries.  Must be a power of two.
+     */
+    template <std::size_t Size>
+    requires ( std::has_single_bit( Size ) )
+    class RouteMemo
+    {
+    public:
+      using Match = MatchCache::Match;
+
+      /**
+       * Look up the match for the path.
+       * @param path The request path.
+       * @param hash The hash of the path.
+       * @param generation The generation of the route table being routed against.
+       * @return The memoised match, or `nullptr` if the path is not memoised for the generation.
+       */
+      [[nodiscard]] const Match* find( std::string_view path, std::uint64_t hash, std::uint64_t generation ) const noexcept
+      {
+        const auto& entry = entries[hash & ( Size - 1 )];
+        if ( entry.generation != generation || entry.hash != hash || entry.size != path.size() ) return nullptr;
+        if ( std::memcmp( entry.path, path.data(), path.size() ) != 0 ) return nullptr;
+        return &entry.match;
+      }
+
+      /**
+       * Memoise the match for the path, replacing the entry in the same slot.
+       * @param path The request path.
+       * @param hash The hash of the path.
+       * @param generation The generation of the route table the match was resolved against.
+       * @param match The match to memoise.
+       */
+      void insert( std::string_view path, std::uint64_t hash, std::uint64_t generation, const Match& match ) noexcept
+      {
+        if ( path.size() > MatchCache::MaxPath || match.count > MatchCache::MaxParams ) return;
+        auto& entry = entries[hash & ( Size - 1 )];
+        entry.hash = hash;
+        entry.generation = generation;
+        entry.match = match;
+        entry.size = static_cast<std::uint32_t>( path.size() );
+        std::memcpy( entry.path, path.data(), path.size() );
+      }
+
+    private:
+      struct Entry
+      {
+        std::uint64_t hash{ 0 };
+        std::uint64_t generation{ 0 };
+        Match match{};
+        std::uint32_t size{ 0 };
+        char path[MatchCache::MaxPath]{};
+      };
+
+      std::array<Entry, Size> entries{};
+    };
+  }
+}
@@ -0,0 +1,950 @@
+#pragma once
+
+#include "concat.hpp"
+#include "constraint.hpp"
+#include "error.hpp"
+#include "index.hpp"
+#include "mapping.hpp"
+#include "method.hpp"
+#include "query.hpp"
+#include "regex.hpp"
+#include "split.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace spt::http::router
+{
+  namespace impl
+  {
+    /**
+     * A configured route as input to a compiled router.  Routes must be specified
+     * in the sorted order maintained by the router.
+     */
+    struct CompiledRoute
+    {
+      /// The path as configured, with the wildcard represented by `~`.
+      std::string_view path;
+      /// The segments of the path.  Parameters are in the `{name}` or `{name:type}` form.
+      std::span<const std::string> parts;
+      /// The automata for the parts constrained by a regular expression, indexed as `parts`.
+      std::span<const std::shared_ptr<const impl::Dfa>> patterns;
+      /// The methods configured for the path, and the index of their handler.
+      std::vector<std::pair<MethodId, std::uint32_t>> handlers;
+      bool wildcard{ false };
+    };
+  }
+
+  /**
+   * Identifies a handler of a compiled router loaded from an image, so that the
+   * handler can be bound.
+   */
+  struct RouteId
+  {
+    /// The index of the handler, in the order the routes were compiled.
+    std::uint32_t id;
+    /// The method/verb the handler is configured for.
+    std::string_view method;
+    /// The path the handler is configured for, as configured (`/device/sensor/id/{id}`, `/device/file/*`).
+    std::string_view path;
+  };
+
+  /**
+   * Read-only router compiled from the routes configured in a HttpRouter.  Use
+   * HttpRouter::compile to create an instance once all the routes have been
+   * configured.
+   *
+   * Routing results are identical to the HttpRouter it was compiled from.  All
+   * routing data (trie nodes and edges, routes, handler indices and the interned
+   * segment strings) is held in flat arrays of integers in a single allocation,
+   * with the data used by every lookup (static path hash slots and trie nodes)
+   * at the start.  Automata for regular expression constraints are stored in the
+   * same allocation.  Handlers are referenced by integer index.  The router cannot
+   * be modified, so no synchronisation is needed to route from multiple threads.
+   *
+   * The routing data holds offsets rather than pointers, so it can be saved as a
+   * binary image and loaded back (from memory or a memory mapped file) without
+   * parsing.  Handlers are not part of the image, and are bound when loading.
+   * @tparam Request User defined structure with the request context necessary for
+   *   the handler function.
+   * @tparam Response The response from the handler function.
+   * @tparam Map The type of map to use to return the parsed path parameters.
+   * @tparam Function The type used to hold handler functions.
+   */
+  template <typename Request, typename Response, typename Map, typename Function = std::function<Response( Request, Map&& )>>
+  requires (std::same_as<std::string, typename Map::key_type> && std::same_as<std::string, typename Map::mapped_type>) ||
+      (std::same_as<std::string_view, typename Map::key_type> && std::same_as<std::string_view, typename Map::mapped_type>)
+  class CompiledRouter
+  {
+  public:
+    using MapType [[maybe_unused]] = Map;
+
+    /**
+     * The key in the path parameters map with the sub-path that matches a wildcard
+     * route.  Same as HttpRouter::WildcardKey.
+     */
+    static inline const auto WildcardKey = std::string{ "_wildcard_" };
+
+    /**
+     * Request handler callback function.  Same as HttpRouter::Handler.
+     */
+    using Handler = Function;
+
+    /**
+     * Create a compiled router.  Use HttpRouter::compile rather than invoking directly.
+     * @param routes The configured routes in sorted order.
+     * @param methods The registry of methods the route handlers are configured for.
+     * @param handlers The handlers referenced by index from the routes.
+     * @param error404 Optional handler function to handle path not found condition.
+     * @param error405 Optional handler function to handle path not configured for method condition.
+     * @param error500 Optional handler function to handle exception caught while despatching the request to handler.
+     */
+    CompiledRouter( std::span<const impl::CompiledRoute> routes, const impl::Methods& methods,
+        std::vector<Handler>&& handlers, std::optional<Handler> error404 = std::nullopt,
+        std::optional<Handler> error405 = std::nullopt, std::optional<Handler> error500 = std::nullopt ) :
+        handlers{ std::move( handlers ) }, notFound{ std::move( error404 ) },
+        methodNotAllowed{ std::move( error405 ) }, errorHandler{ std::move( error500 ) }
+    {
+      build( routes, methods );
+    }
+
+    ~CompiledRouter() = default;
+    CompiledRouter(CompiledRouter&&) noexcept = default;
+    CompiledRouter& operator=(CompiledRouter&&) noexcept = default;
+    CompiledRouter(const CompiledRouter&) = delete;
+    CompiledRouter& operator=(const CompiledRouter&) = delete;
+
+    /**
+     * Attempt to route the request for specified path and method.
+     * @param method The HTTP method/verb from the client.
+     * @param path The request URI path.
+     * @param request The custom data used by the handler callback function.
+     * @param checkWithoutTrailingSlash If `true` and if the `path` ends with
+     *   a trailing slash ('/'), attempt to find a match after trimming the
+     *   trailing slash in case the original path does not match.
+     * @return Returns std::nullopt if no configured route matches.
+     */
+    std::optional<Response> route( std::string_view method, std::string_view path,
+        Request request, bool checkWithoutTrailingSlash = false ) const
+    {
+      return routePath( method, path, Query{}, request, checkWithoutTrailingSlash );
+    }
+
+    /**
+     * Attempt to route the request for the specified request target, as for
+     * `HttpRouter::routeTarget`.
+     * @param method The HTTP method/verb from the client.
+     * @param target The request target, the path with an optional query string and fragment.
+     * @param request The custom data used by the handler callback function.
+     * @param checkWithoutTrailingSlash As for `route`, applied to the path.
+     * @return Returns std::nullopt if no configured route matches.
+     */
+    std::optional<Response> routeTarget( std::string_view method, std::string_view target,
+        Request request, bool checkWithoutTrailingSlash = false ) const
+    {
+      const auto t = impl::target( target );
+      return routePath( method, t.path, t.query, request, checkWithoutTrailingSlash );
+    }
+
+    /// Check if a handler has been registered for the specified resource using the specified method/verb.
+    /// @param method The HTTP method/verb configured for the resourse
+    /// @param path The path to check if a handler has been configured
+    /// @return A tuple of two booleans.  The first value indicates the resource has a handler, while the
+    ///   second indicates if the method has been configured for the resource.
+    [[nodiscard]] std::tuple<bool, bool> canRoute( std::string_view method, std::string_view path ) const
+    {
+      if ( method.empty() || path.empty() ) return { false, false };
+
+      const auto m = find( method );
+      if ( const auto idx = exact( path ); idx != npos ) return { true, has( routes[idx], m ) };
+
+      const auto from = lowerBound( path );
+      if ( from == routes.size() ) return { false, false };
+      if ( text( routes[from].path ) == path && !routes[from].wildcard ) return { true, has( routes[from], m ) };
+
+      auto buffer = std::array<std::string_view, MaxSegments>{};
+      const auto count = util::segment( path, buffer );
+      const auto idx = count > buffer.size() ?
+          match( util::split<std::string_view>( path ), from ) :
+          match( std::span{ buffer.data(), count }, from );
+      if ( idx == npos ) return { false, false };
+      return { true, has( routes[idx], m ) };
+    }
+
+    /// The number of bytes in the single allocation holding the routing data.
+    [[nodiscard]] std::size_t bytes() const noexcept { return size; }
+
+    /**
+     * Write the routing data as a binary image, which can be loaded with `load`
+     * or `map`.  The image is a fixed size header followed by the routing data
+     * as held in memory, so it may only be loaded by a build with the same
+     * image version, byte order and data layout.  Open streams in binary mode.
+     * @param out The stream to write the image to.
+     */
+    void save( std::ostream& out ) const
+    {
+      auto header = Header{};
+      std::memset( &header, 0, sizeof( header ) );
+      std::memcpy( header.magic.data(), Magic.data(), Magic.size() );
+      header.version = ImageVersion;
+      header.order = ByteOrder;
+      header.layout = layout();
+      header.size = size;
+      header.handlers = static_cast<std::uint32_t>( handlers.size() );
+      header.sections = {
+          section( slots ), section( nodes ), section( edges ), section( children ), section( terminals ),
+          section( routes ), section( handlerIndices ), section( params ), section( customMethods ),
+          section( std::span{ strings } ), section( patterns ) };
+
+      out.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+      out.write( reinterpret_cast<const char*>( base ), static_cast<std::streamsize>( size ) );
+    }
+
+    /**
+     * Load a router from an image written by `save`.  Routing data is used in
+     * place, nothing is copied or parsed, so the cost of loading is that of binding
+     * the handlers.  The image is checked against the version and layout of this
+     * build, and the indices and offsets in the routing data are checked to be in
+     * range in a single pass, so that a corrupt image is rejected rather than read
+     * out of bounds while routing.
+     *
+     * @code
+     * auto router = Router::load( image, owner, [&handlers]( const RouteId& r ) { return handlers.at( r.path ); } );
+     * @endcode
+     * @param image The bytes of the image.  Must be aligned to 8 bytes.
+     * @param owner Owner of the image, held by the router.  May be empty if the
+     *   caller keeps the image alive for the lifetime of the router.
+     * @param bind Invoked for each handler in the image with its `RouteId`, returns
+     *   the handler to use.  Strings in the `RouteId` are valid for the call only.
+     * @param error404 Optional handler function to handle path not found condition.
+     * @param error405 Optional handler function to handle path not configured for method condition.
+     * @param error500 Optional handler function to handle exception caught while despatching the request to handler.
+     * @return The router.
+     * @throws InvalidImageError If the image was not written by a compatible build, or is truncated or corrupt.
+     */
+    template <typename Bind>
+    requires std::is_invocable_r_v<Handler, Bind, const RouteId&>
+    [[nodiscard]] static CompiledRouter load( std::span<const std::byte> image, std::shared_ptr<const void> owner,
+        Bind&& bind, std::optional<Handler> error404 = std::nullopt,
+        std::optional<Handler> error405 = std::nullopt, std::optional<Handler> error500 = std::nullopt )
+    {
+      auto router = CompiledRouter{ std::move( error404 ), std::move( error405 ), std::move( error500 ) };
+      const auto count = router.attach( image, std::move( owner ) );
+      router.bind( std::forward<Bind>( bind ), count );
+      return router;
+    }
+
+    /**
+     * Load a router from an image file written by `save`, memory mapped read only.
+     * The routing data is used directly from the mapped pages, which are shared
+     * through the page cache with other processes mapping the same file.
+     * @param file The path to the image file.
+     * @param bind Invoked for each handler in the image, as for `load`.
+     * @param error404 Optional handler function to handle path not found condition.
+     * @param error405 Optional handler function to handle path not configured for method condition.
+     * @param error500 Optional handler function to handle exception caught while despatching the request to handler.
+     * @return The router.
+     * @throws InvalidImageError If the image was not written by a compatible build, or is truncated or corrupt.
+     * @throws std::system_error If the file cannot be opened or mapped.
+     */
+    template <typename Bind>
+    requires std::is_invocable_r_v<Handler, Bind, const RouteId&>
+    [[nodiscard]] static CompiledRouter map( const std::string& file, Bind&& bind,
+        std::optional<Handler> error404 = std::nullopt, std::optional<Handler> error405 = std::nullopt,
+        std::optional<Handler> error500 = std::nullopt )
+    {
+      auto mapped = impl::map( file );
+      return load( mapped.bytes, std::move( mapped.owner ), std::forward<Bind>( bind ),
+          std::move( error404 ), std::move( error405 ), std::move( error500 ) );
+    }
+
+  private:
+    static constexpr auto npos = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::size_t MaxSegments = 32;
+
+    // Offset and length of a string in the interned text
+    struct Text
+    {
+      std::uint32_t offset;
+      std::uint32_t length;
+    };
+
+    struct Slot
+    {
+      std::uint64_t hash{ 0 };
+      std::uint32_t route{ npos };
+    };
+
+    struct Node
+    {
+      std::uint32_t statics{ 0 };
+      std::uint32_t staticCount{ 0 };
+      std::uint32_t params{ 0 };
+      std::uint32_t paramCount{ 0 };
+      std::uint32_t wildcard{ npos };
+      // The routes ending at this node, in sorted table order, as a range of the terminals
+      std::uint32_t routes{ 0 };
+      std::uint32_t routeCount{ 0 };
+      // Constraint on the parameter segment leading to this node, and the offset of its automaton
+      std::uint32_t pattern{ npos };
+      Constraint constraint{ Constraint::None };
+    };
+
+    struct Edge
+    {
+      Text text;
+      std::uint32_t child;
+    };
+
+    struct Route
+    {
+      std::uint64_t mask;
+      Text path;
+      std::uint32_t handlers;
+      std::uint32_t params;
+      std::uint32_t paramCount;
+      std::uint32_t depth;
+      bool wildcard;
+    };
+
+    struct Param
+    {
+      std::uint32_t depth;
+      Text name;
+    };
+
+    // Offset (from the start of the routing data) and element count of an array
+    struct Section
+    {
+      std::uint64_t offset;
+      std::uint64_t count;
+    };
+
+    // Fixed size header of a saved image, followed by the routing data
+    struct alignas( 64 ) Header
+    {
+      std::array<char, 8> magic;
+      std::uint32_t version;
+      std::uint32_t order;
+      std::uint64_t layout;
+      std::uint64_t size;
+      std::uint32_t handlers;
+      std::uint32_t reserved;
+      std::array<Section, 11> sections;
+    };
+
+    static constexpr std::string_view Magic{ "SPTROUTE", 8 };
+    static constexpr std::uint32_t ImageVersion = 4;
+    static constexpr std::uint32_t ByteOrder = 0x01020304;
+
+    // Sizes of the records in the routing data, so that an image from an incompatible build is rejected
+    [[nodiscard]] static constexpr std::uint64_t layout() noexcept
+    {
+      return std::uint64_t{ sizeof( Slot ) } | std::uint64_t{ sizeof( Node ) } << 8 |
+          std::uint64_t{ sizeof( Edge ) } << 16 | std::uint64_t{ sizeof( Route ) } << 24 |
+          std::uint64_t{ sizeof( Param ) } << 32 | std::uint64_t{ sizeof( Text ) } << 40 |
+          std::uint64_t{ alignof( Slot ) } << 48 | std::uint64_t{ impl::MaxMethods } << 56;
+    }
+
+    // Temporary trie node used while compiling
+    struct Pending
+    {
+      std::vector<std::pair<std::string_view, std::uint32_t>> statics;
+      std::vector<std::pair<std::string_view, std::uint32_t>> params;
+      std::uint32_t wildcard{ npos };
+      std::vector<std::uint32_t> routes;
+      const impl::Dfa* pattern{ nullptr };
+      Constraint constraint{ Constraint::None };
+    };
+
+    // Router loaded from an image, routing data and handlers are attached after
+    CompiledRouter( std::optional<Handler> error404, std::optional<Handler> error405, std::optional<Handler> error500 ) :
+        notFound{ std::move( error404 ) }, methodNotAllowed{ std::move( error405 ) }, errorHandler{ std::move( error500 ) } {}
+
+    template <typename T>
+    [[nodiscard]] Section section( std::span<const T> values ) const noexcept
+    {
+      return Section{ static_cast<std::uint64_t>( reinterpret_cast<const std::byte*>( values.data() ) - base ), values.size() };
+    }
+
+    template <typename T>
+    [[nodiscard]] std::span<const T> section( const Section& s, std::string_view name ) const
+    {
+      using std::operator""sv;
+      if ( s.offset % alignof( T ) != 0 || s.offset > size || s.count > ( size - s.offset ) / sizeof( T ) )
+      {
+        throw InvalidImageError{ util::concat( "Invalid "sv, name, " section in image"sv ) };
+      }
+      return { reinterpret_cast<const T*>( base + s.offset ), static_cast<std::size_t>( s.count ) };
+    }
+
+    // Use the routing data in the image in place, returns the number of handlers to bind
+    std::size_t attach( std::span<const std::byte> image, std::shared_ptr<const void> owner )
+    {
+      using std::operator""sv;
+      using std::operator""s;
+      if ( image.size() < sizeof( Header ) ) throw InvalidImageError{ "Image is smaller than the header"s };
+
+      auto header = Header{};
+      std::memcpy( &header, image.data(), sizeof( header ) );
+      if ( std::string_view{ header.magic.data(), header.magic.size() } != Magic ) throw InvalidImageError{ "Not a router image"s };
+      if ( header.version != ImageVersion )
+      {
+        throw InvalidImageError{ util::concat( "Unsupported image version "sv, std::to_string( header.version ) ) };
+      }
+      if ( header.order != ByteOrder ) throw InvalidImageError{ "Image byte order does not match"s };
+      if ( header.layout != layout() ) throw InvalidImageError{ "Image data layout does not match"s };
+      if ( header.size > image.size() - sizeof( Header ) ) throw InvalidImageError{ "Image is truncated"s };
+
+      base = image.data() + sizeof( Header );
+      if ( reinterpret_cast<std::uintptr_t>( base ) % alignof( std::uint64_t ) != 0 )
+      {
+        throw InvalidImageError{ "Image is not aligned to 8 bytes"s };
+      }
+
+      size = static_cast<std::size_t>( header.size );
+      slots = section<Slot>( header.sections[0], "slots"sv );
+      nodes = section<Node>( header.sections[1], "nodes"sv );
+      edges = section<Edge>( header.sections[2], "edges"sv );
+      children = section<std::uint32_t>( header.sections[3], "children"sv );
+      terminals = section<std::uint32_t>( header.sections[4], "terminals"sv );
+      routes = section<Route>( header.sections[5], "routes"sv );
+      handlerIndices = section<std::uint32_t>( header.sections[6], "handlers"sv );
+      params = section<Param>( header.sections[7], "params"sv );
+      customMethods = section<Text>( header.sections[8], "methods"sv );
+      const auto t = section<char>( header.sections[9], "strings"sv );
+      strings = std::string_view{ t.data(), t.size() };
+      patterns = section<std::uint16_t>( header.sections[10], "patterns"sv );
+
+      if ( !std::has_single_bit( slots.size() ) && !slots.empty() ) throw InvalidImageError{ "Invalid slots section in image"s };
+      if ( nodes.empty() ) throw InvalidImageError{ "Invalid nodes section in image"s };
+      validate();
+      storage = std::move( owner );
+      return header.handlers;
+    }
+
+    // Check the indices and offsets used while routing, so that matching need not.  Handlers are checked by `bind`.
+    void validate() const
+    {
+      using std::operator""s;
+      const auto inText = [this]( Text t ) { return std::size_t{ t.offset } + t.length <= strings.size(); };
+      const auto inRange = []( std::uint32_t first, std::uint32_t count, std::size_t size )
+      {
+        return std::size_t{ first } + count <= size;
+      };
+
+      if ( std::ranges::any_of( edges, [&]( const Edge& e ) { return !inText( e.text ) || e.child >= nodes.size(); } ) )
+      {
+        throw InvalidImageError{ "Invalid edges in image"s };
+      }
+      if ( std::ranges::any_of( children, [this]( std::uint32_t c ) { return c >= nodes.size(); } ) )
+      {
+        throw InvalidImageError{ "Invalid children in image"s };
+      }
+      if ( std::ranges::any_of( terminals, [this]( std::uint32_t t ) { return t >= routes.size(); } ) )
+      {
+        throw InvalidImageError{ "Invalid terminals in image"s };
+      }
+      if ( impl::StandardMethods + customMethods.size() > impl::MaxMethods || !std::ranges::all_of( customMethods, inText ) )
+      {
+        throw InvalidImageError{ "Invalid methods in image"s };
+      }
+      for ( const auto& route : routes )
+      {
+        // Not read as a bool until known to hold a valid one
+        std::uint8_t wildcard;
+        std::memcpy( &wildcard, &route.wildcard, sizeof( wildcard ) );
+        if ( wildcard > 1 || !inText( route.path ) || !inRange( route.params, route.paramCount, params.size() ) ||
+            std::ranges::any_of( params.subspan( route.params, route.paramCount ),
+                [&]( const Param& p ) { return !inText( p.name ) || p.depth >= route.depth; } ) )
+        {
+          throw InvalidImageError{ "Invalid routes in image"s };
+        }
+      }
+      if ( std::ranges::any_of( slots, [this]( const Slot& slot ) { return slot.route != npos && slot.route >= routes.size(); } ) ||
+          ( !slots.empty() && std::ranges::none_of( slots, []( const Slot& slot ) { return slot.route == npos; } ) ) )
+      {
+        throw InvalidImageError{ "Invalid slots in image"s };
+      }
+
+      // Walk the trie from the root, each node must be reached once, and its routes must be as deep as the node
+      auto depths = std::vector<std::uint32_t>( nodes.size(), npos );
+      auto wildcards = std::vector<bool>( nodes.size(), false );
+      auto pending = std::vector<std::uint32_t>{ 0 };
+      depths[0] = 0;
+      const auto visit = [&]( std::uint32_t node, std::uint32_t child, bool wildcard )
+      {
+        if ( child >= nodes.size() || depths[child] != npos ) throw InvalidImageError{ "Invalid nodes in image"s };
+        depths[child] = depths[node] + 1;
+        wildcards[child] = wildcard;
+        pending.push_back( child );
+      };
+
+      while ( !pending.empty() )
+      {
+        const auto idx = pending.back();
+        pending.pop_back();
+        const auto& node = nodes[idx];
+        if ( !inRange( node.statics, node.staticCount, edges.size() ) || !inRange( node.params, node.paramCount, children.size() ) ||
+            !inRange( node.routes, node.routeCount, terminals.size() ) || node.constraint > Constraint::Regex ||
+            ( node.constraint == Constraint::Regex &&
+                ( node.pattern > patterns.size() || !impl::wellFormed( patterns.subspan( node.pattern ) ) ) ) )
+        {
+          throw InvalidImageError{ "Invalid nodes in image"s };
+        }
+
+        for ( const auto r : terminals.subspan( node.routes, node.routeCount ) )
+        {
+          if ( routes[r].depth != depths[idx] || routes[r].wildcard != wildcards[idx] )
+          {
+            throw InvalidImageError{ "Invalid nodes in image"s };
+          }
+        }
+
+        for ( const auto& e : edges.subspan( node.statics, node.staticCount ) ) visit( idx, e.child, false );
+        for ( const auto c : children.subspan( node.params, node.paramCount ) ) visit( idx, c, false );
+        if ( node.wildcard != npos ) visit( idx, node.wildcard, true );
+      }
+    }
+
+    template <typename Bind>
+    void bind( Bind&& fn, std::size_t count )
+    {
+      using std::operator""sv;
+      using std::operator""s;
+      auto bound = std::vector<std::optional<Handler>>( count );
+      auto path = std::string{};
+
+      for ( const auto& r : routes )
+      {
+        if ( std::size_t{ r.path.offset } + r.path.length > strings.size() ) throw InvalidImageError{ "Invalid route in image"s };
+        path.assign( text( r.path ) );
+        if ( r.wildcard && path.ends_with( '~' ) ) path.back() = '*';
+
+        auto rank = 0u;
+        for ( auto mask = r.mask; mask != 0; mask &= mask - 1, ++rank )
+        {
+          const auto m = static_cast<impl::MethodId>( std::countr_zero( mask ) );
+          if ( m >= impl::StandardMethods + customMethods.size() || std::size_t{ r.handlers } + rank >= handlerIndices.size() )
+          {
+            throw InvalidImageError{ util::concat( "Invalid handlers for "sv, path, " in image"sv ) };
+          }
+
+          const auto id = handlerIndices[r.handlers + rank];
+          if ( id >= count || bound[id] ) throw InvalidImageError{ util::concat( "Invalid handlers for "sv, path, " in image"sv ) };
+          const auto method = m < impl::StandardMethods ? impl::MethodNames[m] : text( customMethods[m - impl::StandardMethods] );
+          bound[id].emplace( fn( RouteId{ id, method, path } ) );
+        }
+      }
+
+      handlers.reserve( count );
+      for ( auto& h : bound )
+      {
+        if ( !h ) throw InvalidImageError{ "Image has handlers not referenced by any route"s };
+        handlers.push_back( std::move( *h ) );
+      }
+    }
+
+    void build( std::span<const impl::CompiledRoute> input, const impl::Methods& methods )
+    {
+      using Children = std::vector<std::pair<std::string_view, std::uint32_t>> Pending::*;
+
+      auto blob = std::string{};
+      auto interned = std::unordered_map<std::string_view, std::uint32_t>{};
+      auto intern = [&blob, &interned]( std::string_view value )
+      {
+        auto [it, inserted] = interned.try_emplace( value, static_cast<std::uint32_t>( blob.size() ) );
+        if ( inserted ) blob.append( value );
+        return Text{ it->second, static_cast<std::uint32_t>( value.size() ) };
+      };
+
+      auto pending = std::vector<Pending>( 1 );
+      auto child = [&pending]( std::uint32_t node, std::string_view part, Children children )
+      {
+        auto& cs = pending[node].*children;
+        auto it = std::lower_bound( std::begin( cs ), std::end( cs ), part,
+            []( const auto& c, std::string_view p ) { return c.first < p; } );
+        if ( it != std::end( cs ) && it->first == part ) return it->second;
+
+        const auto idx = static_cast<std::uint32_t>( pending.size() );
+        cs.emplace( it, part, idx );
+        pending.emplace_back();
+        return idx;
+      };
+
+      auto rs = std::vector<Route>{};
+      auto ps = std::vector<Param>{};
+      auto indices = std::vector<std::uint32_t>{};
+      rs.reserve( input.size() );
+      for ( std::uint32_t i = 0; i < input.size(); ++i )
+      {
+        const auto& in = input[i];
+        auto& r = rs.emplace_back( Route{ 0, intern( in.path ), static_cast<std::uint32_t>( indices.size() ),
+            static_cast<std::uint32_t>( ps.size() ), 0, static_cast<std::uint32_t>( in.parts.size() ), in.wildcard } );
+
+        // Handler indices ordered by method, so the rank of the method bit in the mask is the offset
+        auto hs = in.handlers;
+        std::sort( std::begin( hs ), std::end( hs ) );
+        for ( const auto& [m, h] : hs )
+        {
+          r.mask |= impl::bit( m );
+          indices.push_back( h );
+        }
+
+        std::uint32_t node = 0;
+        for ( std::uint32_t depth = 0; depth < in.parts.size(); ++depth )
+        {
+          const auto part = std::string_view{ in.parts[depth] };
+          if ( part == "~" )
+          {
+            if ( pending[node].wildcard == npos )
+            {
+              pending[node].wildcard = static_cast<std::uint32_t>( pending.size() );
+              pending.emplace_back();
+            }
+            node = pending[node].wildcard;
+          }
+          else if ( part.starts_with( '{' ) )
+          {
+            node = child( node, part, &Pending::params );
+            pending[node].constraint = impl::constraint( part ).value_or( Constraint::None );
+            if ( pending[node].constraint == Constraint::Regex ) pending[node].pattern = in.patterns[depth].get();
+            ps.push_back( Param{ depth, intern( impl::parameter( part ) ) } );
+            ++r.paramCount;
+          }
+          else node = child( node, part, &Pending::statics );
+        }
+        // Routes are compiled in sorted order, so the routes of a node are as well
+        pending[node].routes.push_back( i );
+      }
+
+      auto ns = std::vector<Node>{};
+      auto es = std::vector<Edge>{};
+      auto cs = std::vector<std::uint32_t>{};
+      auto ts = std::vector<std::uint32_t>{};
+      auto ws = std::vector<std::uint16_t>{};
+      auto automata = std::unordered_map<const impl::Dfa*, std::uint32_t>{};
+      ns.reserve( pending.size() );
+      for ( const auto& p : pending )
+      {
+        auto pattern = npos;
+        if ( p.pattern != nullptr )
+        {
+          auto [it, inserted] = automata.try_emplace( p.pattern, static_cast<std::uint32_t>( ws.size() ) );
+          if ( inserted ) ws.insert( std::end( ws ), std::cbegin( p.pattern->data() ), std::cend( p.pattern->data() ) );
+          pattern = it->second;
+        }
+
+        ns.push_back( Node{ static_cast<std::uint32_t>( es.size() ), static_cast<std::uint32_t>( p.statics.size() ),
+            static_cast<std::uint32_t>( cs.size() ), static_cast<std::uint32_t>( p.params.size() ), p.wildcard,
+            static_cast<std::uint32_t>( ts.size() ), static_cast<std::uint32_t>( p.routes.size() ), pattern, p.constraint } );
+        for ( const auto& [part, c] : p.statics ) es.push_back( Edge{ intern( part ), c } );
+        for ( const auto& pc : p.params ) cs.push_back( pc.second );
+        ts.insert( std::end( ts ), std::cbegin( p.routes ), std::cend( p.routes ) );
+      }
+
+      auto ss = std::vector<Slot>{};
+      const auto statics = std::count_if( std::cbegin( input ), std::cend( input ), []( const impl::CompiledRoute& r )
+      {
+        return !r.wildcard && std::none_of( std::cbegin( r.parts ), std::cend( r.parts ),
+            []( const std::string& part ) { return part.starts_with( '{' ); } );
+      } );
+      if ( statics > 0 )
+      {
+        ss.resize( std::bit_ceil( static_cast<std::size_t>( 2 * statics ) ) );
+        const auto mask = ss.size() - 1;
+        for ( std::uint32_t i = 0; i < input.size(); ++i )
+        {
+          const auto& r = input[i];
+          if ( r.wildcard || std::any_of( std::cbegin( r.parts ), std::cend( r.parts ),
+              []( const std::string& part ) { return part.starts_with( '{' ); } ) ) continue;
+
+          const auto h = impl::hash( r.path );
+          auto j = h & mask;
+          while ( ss[j].route != npos ) j = ( j + 1 ) & mask;
+          ss[j] = Slot{ h, i };
+        }
+      }
+
+      auto ms = std::vector<Text>{};
+      for ( auto id = impl::StandardMethods; id < methods.size(); ++id )
+      {
+        ms.push_back( intern( methods.name( static_cast<impl::MethodId>( id ) ) ) );
+      }
+
+      // Most frequently accessed arrays first
+      auto offsets = std::array<std::size_t, 11>{};
+      offsets[0] = reserve<Slot>( ss.size() );
+      offsets[1] = reserve<Node>( ns.size() );
+      offsets[2] = reserve<Edge>( es.size() );
+      offsets[3] = reserve<std::uint32_t>( cs.size() );
+      offsets[4] = reserve<std::uint32_t>( ts.size() );
+      offsets[5] = reserve<Route>( rs.size() );
+      offsets[6] = reserve<std::uint32_t>( indices.size() );
+      offsets[7] = reserve<Param>( ps.size() );
+      offsets[8] = reserve<Text>( ms.size() );
+      offsets[9] = reserve<char>( blob.size() );
+      offsets[10] = reserve<std::uint16_t>( ws.size() );
+      auto buffer = std::make_unique<std::byte[]>( size );
+
+      slots = place( buffer.get(), offsets[0], ss );
+      nodes = place( buffer.get(), offsets[1], ns );
+      edges = place( buffer.get(), offsets[2], es );
+      children = place( buffer.get(), offsets[3], cs );
+      terminals = place( buffer.get(), offsets[4], ts );
+      routes = place( buffer.get(), offsets[5], rs );
+      handlerIndices = place( buffer.get(), offsets[6], indices );
+      params = place( buffer.get(), offsets[7], ps );
+      customMethods = place( buffer.get(), offsets[8], ms );
+      const auto t = place( buffer.get(), offsets[9], blob );
+      strings = std::string_view{ t.data(), t.size() };
+      patterns = place( buffer.get(), offsets[10], ws );
+
+      base = buffer.get();
+      storage = std::shared_ptr<const std::byte[]>{ std::move( buffer ) };
+    }
+
+    template <typename T>
+    std::size_t reserve( std::size_t count )
+    {
+      size = ( size + alignof( T ) - 1 ) & ~( alignof( T ) - 1 );
+      const auto offset = size;
+      size += count * sizeof( T );
+      return offset;
+    }
+
+    template <typename Container>
+    static auto place( std::byte* buffer, std::size_t offset, const Container& values )
+    {
+      using T = typename Container::value_type;
+      auto ptr = reinterpret_cast<T*>( buffer + offset );
+      std::uninitialized_copy( std::cbegin( values ), std::cend( values ), ptr );
+      return std::span<const T>{ ptr, values.size() };
+    }
+
+    [[nodiscard]] std::string_view text( Text t ) const noexcept { return strings.substr( t.offset, t.length ); }
+
+    [[nodiscard]] impl::MethodId find( std::string_view method ) const noexcept
+    {
+      if ( const auto m = impl::parse( method ); m != Method::Other ) return static_cast<impl::MethodId>( m );
+      for ( std::size_t i = 0; i < customMethods.size(); ++i )
+      {
+        if ( text( customMethods[i] ) == method ) return static_cast<impl::MethodId>( impl::StandardMethods + i );
+      }
+      return impl::UnknownMethod;
+    }
+
+    [[nodiscard]] static bool has( const Route& route, impl::MethodId m ) noexcept
+    {
+      return ( route.mask & impl::bit( m ) ) != 0;
+    }
+
+    [[nodiscard]] const Handler* handler( const Route& route, impl::MethodId m ) const noexcept
+    {
+      if ( !has( route, m ) ) return nullptr;
+      const auto rank = std::popcount( route.mask & ( impl::bit( m ) - 1 ) );
+      return &handlers[handlerIndices[route.handlers + rank]];
+    }
+
+    [[nodiscard]] std::uint32_t exact( std::string_view path ) const noexcept
+    {
+      if ( slots.empty() ) return npos;
+
+      const auto h = impl::hash( path );
+      const auto mask = slots.size() - 1;
+      for ( auto i = h & mask; ; i = ( i + 1 ) & mask )
+      {
+        const auto& slot = slots[i];
+        if ( slot.route == npos ) return npos;
+        if ( slot.hash == h && text( routes[slot.route].path ) == path ) return slot.route;
+      }
+    }
+
+    [[nodiscard]] std::uint32_t lowerBound( std::string_view path ) const noexcept
+    {
+      const auto it = std::partition_point( std::cbegin( routes ), std::cend( routes ),
+          [this, path]( const Route& r ) { return text( r.path ) < path; } );
+      return static_cast<std::uint32_t>( std::distance( std::cbegin( routes ), it ) );
+    }
+
+    [[nodiscard]] bool accepts( const Node& node, std::string_view part ) const noexcept
+    {
+      if ( node.constraint == Constraint::Regex ) return impl::match( patterns.data() + node.pattern, part );
+      return impl::valid( node.constraint, part );
+    }
+
+    // The first route of the node at or after `from`, as impl::Trie::terminal
+    [[nodiscard]] std::uint32_t terminal( const Node& node, std::uint32_t from ) const noexcept
+    {
+      const auto first = std::cbegin( terminals ) + node.routes;
+      const auto last = first + node.routeCount;
+      const auto it = std::lower_bound( first, last, from );
+      return it == last ? npos : *it;
+    }
+
+    template <typename Parts>
+    [[nodiscard]] std::uint32_t match( const Parts& parts, std::uint32_t from ) const
+    {
+      if ( parts.empty() ) return npos;
+      return match( 0, 0, parts, from );
+    }
+
+    // Same visiting order as impl::Trie::find
+    template <typename Parts>
+    [[nodiscard]] std::uint32_t match( std::uint32_t idx, std::size_t depth, const Parts& parts, std::uint32_t from ) const
+    {
+      const auto& node = nodes[idx];
+      if ( depth == parts.size() ) return terminal( node, from );
+
+      const auto part = std::string_view{ parts[depth] };
+
+      auto st = npos;
+      auto lead = std::numeric_limits<unsigned char>::max();
+      if ( node.staticCount > 0 )
+      {
+        const auto first = std::cbegin( edges ) + node.statics;
+        const auto last = first + node.staticCount;
+        auto it = std::lower_bound( first, last, part,
+            [this]( const Edge& e, std::string_view p ) { return text( e.text ) < p; } );
+        if ( it != last && text( it->text ) == part )
+        {
+          st = it->child;
+          lead = static_cast<unsigned char>( part.front() );
+        }
+      }
+
+      auto result = npos;
+      if ( st != npos && lead < '{' && ( result = match( st, depth + 1, parts, from ) ) != npos ) return result;
+
+      for ( std::uint32_t i = 0; i < node.paramCount; ++i )
+      {
+        const auto c = children[node.params + i];
+        if ( !accepts( nodes[c], part ) ) continue;
+        if ( ( result = match( c, depth + 1, parts, from ) ) != npos ) return result;
+      }
+
+      if ( st != npos && lead >= '{' && lead < '~' && ( result = match( st, depth + 1, parts, from ) ) != npos ) return result;
+      if ( node.wildcard != npos && ( result = terminal( nodes[node.wildcard], from ) ) != npos ) return result;
+      if ( st != npos && lead >= '~' ) return match( st, depth + 1, parts, from );
+      return npos;
+    }
+
+    std::optional<Response> routePath( std::string_view method, std::string_view path, const Query& query,
+        Request request, bool checkWithoutTrailingSlash ) const
+    {
+      if ( method.empty() || path.empty() ) return std::nullopt;
+      try
+      {
+        const auto m = find( method );
+        auto resp = routeParameters( m, path, request, query );
+        if ( !resp && checkWithoutTrailingSlash && path.ends_with( '/' ) )
+        {
+          return routeParameters( m, path.substr( 0, path.size() - 1 ), request, query );
+        }
+
+        return resp;
+      }
+      catch ( const std::exception& )
+      {
+        if ( errorHandler ) return impl::call( *errorHandler, request, Map{}, query );
+        throw;
+      }
+    }
+
+    std::optional<Response> routeExact( const Route& r, impl::MethodId m, Request request, const Query& query ) const
+    {
+      if ( auto h = handler( r, m ); h ) return impl::call( *h, request, Map{}, query );
+      if ( methodNotAllowed ) return impl::call( *methodNotAllowed, request, Map{}, query );
+      return std::nullopt;
+    }
+
+    std::optional<Response> routeParameters( impl::MethodId m, std::string_view path, Request request,
+        const Query& query ) const
+    {
+      if ( const auto idx = exact( path ); idx != npos ) return routeExact( routes[idx], m, request, query );
+
+      const auto from = lowerBound( path );
+      if ( from == routes.size() ) return std::nullopt;
+      if ( text( routes[from].path ) == path && !routes[from].wildcard ) return routeExact( routes[from], m, request, query );
+
+      auto buffer = std::array<std::string_view, MaxSegments>{};
+      const auto count = util::segment( path, buffer );
+      if ( count > buffer.size() ) return routeDynamic( util::split<std::string_view>( path ), from, m, path, request, query );
+      return routeDynamic( std::span{ buffer.data(), count }, from, m, path, request, query );
+    }
+
+    template <typename Parts>
+    std::optional<Response> routeDynamic( const Parts& parts, std::uint32_t from, impl::MethodId m,
+        std::string_view path, Request request, const Query& query ) const
+    {
+      Map values{};
+
+      const auto idx = match( parts, from );
+      if ( idx == npos )
+      {
+        if ( notFound ) return impl::call( *notFound, request, std::move( values ), query );
+        return std::nullopt;
+      }
+
+      const auto& matched = routes[idx];
+      for ( std::uint32_t i = 0; i < matched.paramCount; ++i )
+      {
+        const auto& param = params[matched.params + i];
+        const auto key = text( param.name );
+        values.try_emplace( { key.data(), key.size() }, parts[param.depth] );
+      }
+
+      auto h = handler( matched, m );
+      if ( !h )
+      {
+        if ( methodNotAllowed ) return impl::call( *methodNotAllowed, request, std::move( values ), query );
+        return std::nullopt;
+      }
+
+      if ( matched.wildcard )
+      {
+        std::size_t offset = 0;
+        for ( std::size_t j = 0; j < matched.depth - 1; ++j ) offset += ( 1 + parts[j].size() );
+        values.try_emplace( WildcardKey, path.substr( ++offset ) );
+      }
+
+      return impl::call( *h, request, std::move( values ), query );
+    }
+
+    // Owner of the routing data, either the buffer it was compiled into or the image it was loaded from
+    std::shared_ptr<const void> storage;
+    const std::byte* base{ nullptr };
+    std::size_t size{ 0 };
+    std::span<const Slot> slots;
+    std::span<const Node> nodes;
+    std::span<const Edge> edges;
+    std::span<const std::uint32_t> children;
+    std::span<const std::uint32_t> terminals;
+    std::span<const Route> routes;
+    std::span<const std::uint32_t> handlerIndices;
+    std::span<const Param> params;
+    std::span<const Text> customMethods;
+    std::string_view strings;
+    std::span<const std::uint16_t> patterns;
+
+    std::vector<Handler> handlers;
+    std::optional<Handler> notFound{ std::nullopt };
+    std::optional<Handler> methodNotAllowed{ std::nullopt };
+    std::optional<Handler> errorHandler{ std::nullopt };
+  };
+}
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#include <immintrin.h>
+#endif
+
+namespace spt::http::router
+{
+  /**
+   * Constraint on the value of a path parameter, configured as `{name:type}`.
+   * Values are validated while matching, and a value that does not satisfy the
+   * constraint does not match the parameter, so matching continues with the
+   * next candidate route.  A type that is not a plain identifier is a regular
+   * expression (`{date:\d{4}-\d{2}-\d{2}}`).
+   */
+  enum class Constraint : std::uint8_t
+  {
+    /// `{name}`, any non-empty segment.
+    None,
+    /// `{name:int}`, an optional `-` followed by decimal digits, in the range of a 64 bit signed integer.
+    Int,
+    /// `{name:hex24}`, 24 hexadecimal digits, such as a MongoDB ObjectId.
+    Hex24,
+    /// `{name:uuid}`, a UUID in the canonical `8-4-4-4-12` hexadecimal digit form.
+    Uuid,
+    /// `{name:pattern}`, a regular expression matching the whole segment, compiled to a DFA.
+    Regex
+  };
+
+  /// The value of a `{name:hex24}` parameter.
+  struct ObjectId
+  {
+    std::array<std::uint8_t, 12> bytes{};
+    bool operator==( const ObjectId& ) const = default;
+  };
+
+  /// The value of a `{name:uuid}` parameter.
+  struct Uuid
+  {
+    std::array<std::uint8_t, 16> bytes{};
+    bool operator==( const Uuid& ) const = default;
+  };
+
+  namespace impl
+  {
+    /**
+     * The constraint for the specified parameter part.
+     * @param part The parameter in the `{name}` or `{name:type}` form.
+     * @return The constraint, or std::nullopt if the type is not a known constraint.
+     */
+    constexpr std::optional<Constraint> constraint( std::string_view part ) noexcept
+    {
+      using std::operator""sv;
+      const auto idx = part.find( ':' );
+      if ( idx == std::string_view::npos ) return Constraint::None;
+
+      const auto type = part.substr( idx + 1, part.size() - idx - 2 );
+      if ( type == "int"sv ) return Constraint::Int;
+      if ( type == "hex24"sv ) return Constraint::Hex24;
+      if ( type == "uuid"sv ) return Constraint::Uuid;
+
+      const auto identifier = std::all_of( std::cbegin( type ), std::cend( type ), []( char c )
+      {
+        return ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) || ( c >= '0' && c <= '9' ) || c == '_';
+      } );
+      if ( identifier ) return std::nullopt;
+      return Constraint::Regex;
+    }
+
+    /**
+     * The name of the parameter, which is the key for its value in the parameters map.
+     * @param part The parameter in the `{name}` or `{name:type}` form.
+     * @return The name without the braces and constraint.
+     */
+    constexpr std::string_view parameter( std::string_view part ) noexcept
+    {
+      const auto name = part.substr( 1, part.size() - 2 );
+      return name.substr( 0, name.find( ':' ) );
+    }
+
+    /**
+     * The type of the parameter, the text of the constraint.
+     * @param part The parameter in the `{name}` or `{name:type}` form.
+     * @return The type or regular expression, empty if the parameter is not constrained.
+     */
+    constexpr std::string_view type( std::string_view part ) noexcept
+    {
+      const auto idx = part.find( ':' );
+      if ( idx == std::string_view::npos ) return {};
+      return part.substr( idx + 1, part.size() - idx - 2 );
+    }
+
+    /**
+     * The position of the wildcard in a configured path.  A `*` in a parameter
+     * segment is part of its regular expression (`{name:[a-z]*}`), and not a wildcard.
+     * @param path The configured path.
+     * @return The position of the first `*` outside a parameter segment, or
+     *   `std::string_view::npos` if there is none.
+     */
+    constexpr std::size_t wildcard( std::string_view path ) noexcept
+    {
+      auto parameter = false;
+      for ( std::size_t i = 0; i < path.size(); ++i )
+      {
+        if ( i == 0 || path[i - 1] == '/' ) parameter = path[i] == '{';
+        if ( !parameter && path[i] == '*' ) return i;
+      }
+      return std::string_view::npos;
+    }
+
+    constexpr bool hex( char c ) noexcept
+    {
+      const auto u = static_cast<unsigned char>( c );
+      return static_cast<unsigned char>( u - '0' ) < 10 || static_cast<unsigned char>( ( u | 0x20 ) - 'a' ) < 6;
+    }
+
+    // Value of a hexadecimal digit, without branching on the case
+    constexpr std::uint8_t nibble( char c ) noexcept
+    {
+      const auto u = static_cast<unsigned char>( c );
+      return static_cast<std::uint8_t>( ( u & 0xf ) + 9 * ( u >> 6 ) );
+    }
+
+    /// Bit `i` is set if byte `i` of the 16 bytes starting at `data` is a hexadecimal digit.
+    inline std::uint64_t hexMask( const char* data ) noexcept
+    {
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+      // Signed comparisons, bytes with the high bit set are outside both ranges
+      const auto block = _mm_loadu_si128( reinterpret_cast<const __m128i*>( data ) );
+      const auto digit = _mm_and_si128( _mm_cmpgt_epi8( block, _mm_set1_epi8( '0' - 1 ) ),
+          _mm_cmplt_epi8( block, _mm_set1_epi8( '9' + 1 ) ) );
+      const auto lower = _mm_or_si128( block, _mm_set1_epi8( 0x20 ) );
+      const auto alpha = _mm_and_si128( _mm_cmpgt_epi8( lower, _mm_set1_epi8( 'a' - 1 ) ),
+          _mm_cmplt_epi8( lower, _mm_set1_epi8( 'f' + 1 ) ) );
+      return static_cast<std::uint32_t>( _mm_movemask_epi8( _mm_or_si128( digit, alpha ) ) );
+#else
+      std::uint64_t mask = 0;
+      for ( std::size_t i = 0; i < 16; ++i ) mask |= std::uint64_t{ hex( data[i] ) } << i;
+      return mask;
+#endif
+    }
+
+    inline bool integer( std::string_view value ) noexcept
+    {
+      using std::operator""sv;
+      const auto negative = !value.empty() && value.front() == '-';
+      const auto digits = value.substr( negative ? 1 : 0 );
+      if ( digits.empty() || digits.size() > 19 ) return false;
+
+      unsigned invalid = 0;
+      for ( const auto c : digits ) invalid |= static_cast<unsigned char>( c - '0' ) > 9;
+      if ( invalid != 0 ) return false;
+      return digits.size() < 19 || digits <= ( negative ? "9223372036854775808"sv : "9223372036854775807"sv );
+    }
+
+    // Two overlapping 16 byte blocks cover the 24 digits
+    inline bool hex24( std::string_view value ) noexcept
+    {
+      if ( value.size() != 24 ) return false;
+      return ( hexMask( value.data() ) | hexMask( value.data() + 8 ) << 8 ) == 0xffffff;
+    }
+
+    inline bool uuid( std::string_view value ) noexcept
+    {
+      constexpr std::uint64_t dashes = ( 1ull << 8 ) | ( 1ull << 13 ) | ( 1ull << 18 ) | ( 1ull << 23 );
+      constexpr std::uint64_t digits = ( ( 1ull << 36 ) - 1 ) & ~dashes;
+      if ( value.size() != 36 ) return false;
+
+      const auto* data = value.data();
+      const auto mask = hexMask( data ) | hexMask( data + 16 ) << 16 | hexMask( data + 20 ) << 20;
+      return mask == digits && ( ( data[8] == '-' ) & ( data[13] == '-' ) & ( data[18] == '-' ) & ( data[23] == '-' ) );
+    }
+
+    /**
+     * Check if the value of a path segment satisfies the constraint.  Regular
+     * expressions are matched with their compiled automaton instead.
+     * @param c The constraint configured for the parameter.
+     * @param value The value of the path segment.
+     * @return `true` if the value satisfies the constraint.
+     */
+    inline bool valid( Constraint c, std::string_view value ) noexcept
+    {
+      switch ( c )
+      {
+      case Constraint::None: return true;
+      case Constraint::Int: return integer( value );
+      case Constraint::Hex24: return hex24( value );
+      case Constraint::Uuid: return uuid( value );
+      case Constraint::Regex: return false;
+      }
+      return false;
+    }
+  }
+
+  /**
+   * Convert the value of a constrained path parameter to its type.  The router
+   * only invokes a handler once the values have been validated while matching,
+   * so the conversion does not check the value again.  Use with the value of a
+   * `{name:int}` (`std::int64_t`), `{name:hex24}` (`ObjectId`) or `{name:uuid}`
+   * (`Uuid`) parameter only.
+   *
+   * @code
+   * router.add( "GET"sv, "/device/sensor/id/{id:hex24}"sv, []( const Request&, Router::MapType&& args )
+   * {
+   *   const auto id = spt::http::router::typed<spt::http::router::ObjectId>( args["id"] );
+   *   ...
+   * } );
+   * @endcode
+   * @tparam T The type of the value.
+   * @param value The value of the parameter, as passed to the handler.
+   * @return The typed value.
+   */
+  template <typename T>
+  requires std::same_as<T, std::int64_t> || std::same_as<T, ObjectId> || std::same_as<T, Uuid>
+  [[nodiscard]] constexpr T typed( std::string_view value ) noexcept
+  {
+    if constexpr ( std::same_as<T, std::int64_t> )
+    {
+      const auto negative = value.front() == '-';
+      std::uint64_t result = 0;
+      for ( const auto c : value.substr( negative ? 1 : 0 ) ) result = result * 10 + static_cast<std::uint64_t>( c - '0' );
+      return static_cast<std::int64_t>( negative ? 0 - result : result );
+    }
+    else
+    {
+      auto result = T{};
+      std::size_t i = 0;
+      for ( auto&& byte : result.bytes )
+      {
+        if ( value[i] == '-' ) ++i;
+        byte = static_cast<std::uint8_t>( impl::nibble( value[i] ) << 4 | impl::nibble( value[i + 1] ) );
+        i += 2;
+      }
+      return result;
+    }
+  }
+}
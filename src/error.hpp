@@ -38,4 +38,24 @@ namespace spt::http::router
   private:
     std::string msg;
   };
+
+  struct InvalidMethodError : std::exception
+  {
+    InvalidMethodError( std::string&& msg ) : std::exception(), msg{ std::move( msg ) } {}
+
+    const char* what() const noexcept override { return msg.c_str(); }
+
+  private:
+    std::string msg;
+  };
+
+  struct InvalidImageError : std::exception
+  {
+    InvalidImageError( std::string&& msg ) : std::exception(), msg{ std::move( msg ) } {}
+
+    const char* what() const noexcept override { return msg.c_str(); }
+
+  private:
+    std::string msg;
+  };
 }
\ No newline at end of file
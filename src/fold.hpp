@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#include <immintrin.h>
+#endif
+
+namespace spt::util
+{
+  namespace detail
+  {
+    constexpr char lower( char c ) noexcept
+    {
+      return c >= 'A' && c <= 'Z' ? static_cast<char>( c + ( 'a' - 'A' ) ) : c;
+    }
+
+    /// Fold the ASCII letters in the 8 bytes of the word to lower case, leaving other bytes as they are.
+    constexpr std::uint64_t lower( std::uint64_t word ) noexcept
+    {
+      constexpr auto ones = 0x0101010101010101ULL;
+      const auto ascii = word & ( 0x7f * ones );
+      // The high bit of each byte is set if the byte is at least `A`, and if it is past `Z`
+      const auto atLeastA = ascii + ( 0x80 - 'A' ) * ones;
+      const auto pastZ = ascii + ( 0x80 - 'Z' - 1 ) * ones;
+      const auto upper = ( atLeastA ^ pastZ ) & ~word & ( 0x80 * ones );
+      return word | ( upper >> 2 );
+    }
+
+    constexpr int compare( char lhs, char rhs ) noexcept
+    {
+      return static_cast<int>( static_cast<unsigned char>( lhs ) ) - static_cast<int>( static_cast<unsigned char>( rhs ) );
+    }
+  }
+
+  /**
+   * Fold the ASCII letters in the text to lower case.  Other bytes, including
+   * those of multi-byte UTF-8 sequences, are left as they are.
+   * @param text The text to fold.
+   * @return A copy of the text in lower case.
+   */
+  inline std::string fold( std::string_view text )
+  {
+    auto out = std::string{ text };
+    std::ranges::transform( out, std::begin( out ), []( char c ) { return detail::lower( c ); } );
+    return out;
+  }
+
+  /**
+   * Fold the ASCII letters in the text to lower case into the buffer, 8 bytes
+   * at a time.
+   * @param text The text to fold.
+   * @param buffer Holds the folded text.  Must be at least as large as the text.
+   * @return The folded text, a view of the buffer.
+   */
+  inline std::string_view fold( std::string_view text, std::span<char> buffer ) noexcept
+  {
+    std::size_t i = 0;
+    for ( ; i + sizeof( std::uint64_t ) <= text.size(); i += sizeof( std::uint64_t ) )
+    {
+      std::uint64_t word;
+      std::memcpy( &word, text.data() + i, sizeof( word ) );
+      word = detail::lower( word );
+      std::memcpy( buffer.data() + i, &word, sizeof( word ) );
+    }
+    for ( ; i < text.size(); ++i ) buffer[i] = detail::lower( text[i] );
+    return { buffer.data(), text.size() };
+  }
+
+  /**
+   * Compare text that has been folded to lower case with text in any case, as
+   * if the latter had been folded as well, without copying it.  The text is
+   * folded and compared 32 (AVX2) or 16 (SSE2) bytes at a time.
+   * @param folded Text in lower case, as returned by `fold`.
+   * @param text The text to compare, in any case.
+   * @return Less than, equal to or greater than zero if the folded text sorts
+   *   before, the same as or after the text folded, in the byte order of
+   *   `std::string_view::compare`.
+   */
+  inline int compareFolded( std::string_view folded, std::string_view text ) noexcept
+  {
+    const auto size = std::min( folded.size(), text.size() );
+    const auto* lhs = folded.data();
+    const auto* rhs = text.data();
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    for ( ; i + 32 <= size; i += 32 )
+    {
+      const auto l = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( lhs + i ) );
+      const auto r = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( rhs + i ) );
+      // Bytes from `A` to `Z`, signed so that bytes of 0x80 and above are below `A`
+      const auto upper = _mm256_and_si256( _mm256_cmpgt_epi8( r, _mm256_set1_epi8( 'A' - 1 ) ),
+          _mm256_cmpgt_epi8( _mm256_set1_epi8( 'Z' + 1 ), r ) );
+      const auto lowered = _mm256_or_si256( r, _mm256_and_si256( upper, _mm256_set1_epi8( 0x20 ) ) );
+      const auto differ = ~static_cast<std::uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( l, lowered ) ) );
+      if ( differ != 0 )
+      {
+        const auto j = i + std::countr_zero( differ );
+        return detail::compare( lhs[j], detail::lower( rhs[j] ) );
+      }
+    }
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+    for ( ; i + 16 <= size; i += 16 )
+    {
+      const auto l = _mm_loadu_si128( reinterpret_cast<const __m128i*>( lhs + i ) );
+      const auto r = _mm_loadu_si128( reinterpret_cast<const __m128i*>( rhs + i ) );
+      const auto upper = _mm_and_si128( _mm_cmpgt_epi8( r, _mm_set1_epi8( 'A' - 1 ) ),
+          _mm_cmpgt_epi8( _mm_set1_epi8( 'Z' + 1 ), r ) );
+      const auto lowered = _mm_or_si128( r, _mm_and_si128( upper, _mm_set1_epi8( 0x20 ) ) );
+      const auto differ = ~static_cast<std::uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( l, lowered ) ) ) & 0xffffU;
+      if ( differ != 0 )
+      {
+        const auto j = i + std::countr_zero( differ );
+        return detail::compare( lhs[j], detail::lower( rhs[j] ) );
+      }
+    }
+#endif
+
+    // 8 bytes at a time, finding the differing byte in the loop below
+    for ( ; i + sizeof( std::uint64_t ) <= size; i += sizeof( std::uint64_t ) )
+    {
+      std::uint64_t l;
+      std::uint64_t r;
+      std::memcpy( &l, lhs + i, sizeof( l ) );
+      std::memcpy( &r, rhs + i, sizeof( r ) );
+      if ( l != detail::lower( r ) ) break;
+    }
+
+    for ( ; i < size; ++i )
+    {
+      if ( const auto c = detail::compare( lhs[i], detail::lower( rhs[i] ) ); c != 0 ) return c;
+    }
+
+    if ( folded.size() == text.size() ) return 0;
+    return folded.size() < text.size() ? -1 : 1;
+  }
+
+  /**
+   * Check if text in any case is the same as text folded to lower case.
+   * @param folded Text in lower case, as returned by `fold`.
+   * @param text The text to compare, in any case.
+   * @return `true` if the text folded is the same as the folded text.
+   */
+  inline bool equalsFolded( std::string_view folded, std::string_view text ) noexcept
+  {
+    return folded.size() == text.size() && compareFolded( folded, text ) == 0;
+  }
+}
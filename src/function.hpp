@@ -0,0 +1,226 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace spt::http::router
+{
+  namespace impl
+  {
+    /// As `std::invoke_r` (C++23), the result is discarded if `R` is `void`, or else converted to `R`.
+    template <typename R, typename F, typename... Args>
+    constexpr R invokeR( F&& f, Args&&... args )
+    {
+      if constexpr ( std::is_void_v<R> ) std::invoke( std::forward<F>( f ), std::forward<Args>( args )... );
+      else return std::invoke( std::forward<F>( f ), std::forward<Args>( args )... );
+    }
+  }
+
+  template <typename Signature, std::size_t Size = 6 * sizeof( void* )>
+  class InlineFunction;
+
+  /**
+   * Type erased function wrapper that stores the callable in an inline buffer and
+   * never allocates.  Callables that do not fit the buffer are rejected at compile
+   * time.  Invoking costs a single indirect call, and copying or moving callables
+   * that are trivially copyable (captureless lambdas, lambdas capturing references
+   * or pointers) is a `memcpy` of the buffer.
+   *
+   * May be specified as the *Function* template parameter of the router to store
+   * handlers without the heap allocations `std::function` makes for larger callables.
+   * @tparam R The return type.
+   * @tparam Args The argument types.
+   * @tparam Size The size of the inline buffer.
+   */
+  template <typename R, typename... Args, std::size_t Size>
+  class InlineFunction<R( Args... ), Size>
+  {
+  public:
+    InlineFunction() noexcept = default;
+    InlineFunction( std::nullptr_t ) noexcept {}
+
+    template <typename F>
+    requires ( !std::same_as<std::remove_cvref_t<F>, InlineFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...> )
+    InlineFunction( F&& f )
+    {
+      using T = std::decay_t<F>;
+      static_assert( sizeof( T ) <= Size, "Callable does not fit the inline buffer, specify a larger Size" );
+      static_assert( alignof( T ) <= alignof( std::max_align_t ), "Callable is over-aligned for the inline buffer" );
+      static_assert( std::is_copy_constructible_v<T>, "Callable must be copy constructible" );
+
+      ::new( static_cast<void*>( buffer ) ) T( std::forward<F>( f ) );
+      invoker = &invoke<T>;
+      if constexpr ( !std::is_trivially_copyable_v<T> ) manager = &manage<T>;
+    }
+
+    InlineFunction( const InlineFunction& other ) : invoker{ other.invoker }, manager{ other.manager }
+    {
+      if ( manager ) manager( Operation::Copy, buffer, other.buffer );
+      else std::memcpy( buffer, other.buffer, Size );
+    }
+
+    InlineFunction( InlineFunction&& other ) noexcept : invoker{ other.invoker }, manager{ other.manager }
+    {
+      if ( manager ) manager( Operation::Move, buffer, other.buffer );
+      else std::memcpy( buffer, other.buffer, Size );
+    }
+
+    InlineFunction& operator=( const InlineFunction& other )
+    {
+      if ( this != &other )
+      {
+        auto copy = InlineFunction{ other };
+        *this = std::move( copy );
+      }
+      return *this;
+    }
+
+    InlineFunction& operator=( InlineFunction&& other ) noexcept
+    {
+      if ( this != &other )
+      {
+        reset();
+        invoker = other.invoker;
+        manager = other.manager;
+        if ( manager ) manager( Operation::Move, buffer, other.buffer );
+        else std::memcpy( buffer, other.buffer, Size );
+      }
+      return *this;
+    }
+
+    ~InlineFunction() { reset(); }
+
+    R operator()( Args... args ) const
+    {
+      return invoker( buffer, std::forward<Args>( args )... );
+    }
+
+    explicit operator bool() const noexcept { return invoker != nullptr; }
+
+  private:
+    enum class Operation : std::uint8_t { Copy, Move, Destroy };
+
+    template <typename T>
+    static R invoke( void* target, Args... args )
+    {
+      return impl::invokeR<R>( *std::launder( static_cast<T*>( target ) ), std::forward<Args>( args )... );
+    }
+
+    template <typename T>
+    static void manage( Operation operation, void* destination, void* source )
+    {
+      switch ( operation )
+      {
+      case Operation::Copy:
+        ::new( destination ) T( *std::launder( static_cast<const T*>( source ) ) );
+        break;
+      case Operation::Move:
+        ::new( destination ) T( std::move( *std::launder( static_cast<T*>( source ) ) ) );
+        break;
+      case Operation::Destroy:
+        std::destroy_at( std::launder( static_cast<T*>( destination ) ) );
+        break;
+      }
+    }
+
+    void reset() noexcept
+    {
+      if ( manager ) manager( Operation::Destroy, buffer, nullptr );
+      invoker = nullptr;
+      manager = nullptr;
+    }
+
+    // Mutable, as with std::function the target is invoked as a non-const lvalue
+    alignas( std::max_align_t ) mutable std::byte buffer[Size]{};
+    R (*invoker)( void*, Args... ){ nullptr };
+    void (*manager)( Operation, void*, void* ){ nullptr };
+  };
+
+  template <typename Signature>
+  class FunctionRef;
+
+  /**
+   * Non-owning reference to a callable.  Holds a pointer to the callable and a
+   * pointer to a function that invokes it, so is trivially copyable and invoking
+   * costs a single indirect call.
+   *
+   * The referenced callable is owned by the caller and must outlive the reference
+   * (and any router the reference is added to).  Only lvalue callables, function
+   * pointers and stateless callables (captureless lambdas, which are invoked via a
+   * default constructed instance) may be referenced, so a temporary lambda passed
+   * to the router is rejected at compile time rather than left dangling.
+   * @tparam R The return type.
+   * @tparam Args The argument types.
+   */
+  template <typename R, typename... Args>
+  class FunctionRef<R( Args... )>
+  {
+  public:
+    template <typename F>
+    requires ( !std::same_as<std::remove_cvref_t<F>, FunctionRef> && std::is_invocable_r_v<R, F&, Args...> )
+    FunctionRef( F&& f ) noexcept
+    {
+      using T = std::remove_cvref_t<F>;
+      if constexpr ( std::is_pointer_v<T> && std::is_function_v<std::remove_pointer_t<T>> )
+      {
+        target.function = reinterpret_cast<void (*)()>( f );
+        invoker = &invokePointer<T>;
+      }
+      else if constexpr ( std::is_function_v<std::remove_reference_t<F>> )
+      {
+        target.function = reinterpret_cast<void (*)()>( &f );
+        invoker = &invokePointer<std::add_pointer_t<std::remove_reference_t<F>>>;
+      }
+      else if constexpr ( std::is_empty_v<T> && std::is_default_constructible_v<T> )
+      {
+        invoker = &invokeStateless<T>;
+      }
+      else
+      {
+        static_assert( std::is_lvalue_reference_v<F>, "FunctionRef cannot reference a temporary callable" );
+        target.object = const_cast<void*>( static_cast<const void*>( std::addressof( f ) ) );
+        invoker = &invokeObject<std::remove_reference_t<F>>;
+      }
+    }
+
+    R operator()( Args... args ) const
+    {
+      return invoker( target, std::forward<Args>( args )... );
+    }
+
+  private:
+    union Target
+    {
+      void* object;
+      void (*function)();
+    };
+
+    template <typename P>
+    static R invokePointer( Target t, Args... args )
+    {
+      return impl::invokeR<R>( reinterpret_cast<P>( t.function ), std::forward<Args>( args )... );
+    }
+
+    template <typename T>
+    static R invokeStateless( Target, Args... args )
+    {
+      return impl::invokeR<R>( T{}, std::forward<Args>( args )... );
+    }
+
+    template <typename T>
+    static R invokeObject( Target t, Args... args )
+    {
+      return impl::invokeR<R>( *static_cast<T*>( t.object ), std::forward<Args>( args )... );
+    }
+
+    Target target{ nullptr };
+    R (*invoker)( Target, Args... ){ nullptr };
+  };
+}
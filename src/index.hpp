@@ -0,0 +1,243 @@
+#pragma once
+
+#include "fold.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if !defined(__GNUC__) && !defined(__clang__) && ( defined(_M_X64) || defined(_M_IX86) )
+#include <xmmintrin.h>
+#endif
+
+namespace spt::http::router::impl
+{
+  /// Hash 8 bytes at a time, folding ASCII letters to lower case first if `Fold` is `true`.
+  template <bool Fold>
+  inline std::uint64_t hashWords( std::string_view value ) noexcept
+  {
+    constexpr auto mix = []( std::uint64_t h )
+    {
+      h ^= h >> 30;
+      h *= 0xbf58476d1ce4e5b9ULL;
+      h ^= h >> 27;
+      h *= 0x94d049bb133111ebULL;
+      return h ^ ( h >> 31 );
+    };
+    constexpr auto word = []( std::uint64_t w ) { if constexpr ( Fold ) return util::detail::lower( w ); else return w; };
+
+    std::uint64_t h = 0x9e3779b97f4a7c15ULL ^ value.size();
+    std::size_t i = 0;
+    for ( ; i + sizeof( std::uint64_t ) <= value.size(); i += sizeof( std::uint64_t ) )
+    {
+      std::uint64_t w;
+      std::memcpy( &w, value.data() + i, sizeof( w ) );
+      h = mix( h ^ word( w ) );
+    }
+
+    std::uint64_t tail = 0;
+    if ( i < value.size() ) std::memcpy( &tail, value.data() + i, value.size() - i );
+    return mix( h ^ word( tail ) );
+  }
+
+  /**
+   * Simple non-cryptographic hash of the input, consuming 8 bytes at a time.
+   * Stable across runs for the same byte order.
+   * @param value The value to hash.
+   * @return The hash value.
+   */
+  inline std::uint64_t hash( std::string_view value ) noexcept
+  {
+    return hashWords<false>( value );
+  }
+
+  /**
+   * Hash of the input folded to lower case, without copying it.  The same as
+   * `hash( util::fold( value ) )`.
+   * @param value The value to hash, in any case.
+   * @return The hash value.
+   */
+  inline std::uint64_t foldedHash( std::string_view value ) noexcept
+  {
+    return hashWords<true>( value );
+  }
+
+  /// Hint that the memory at the address will be read soon.
+  inline void prefetch( [[maybe_unused]] const void* address ) noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch( address );
+#elif defined(_M_X64) || defined(_M_IX86)
+    _mm_prefetch( static_cast<const char*>( address ), _MM_HINT_T0 );
+#endif
+  }
+
+  /**
+   * Open addressing hash table of static paths (no parameters or wildcard) to
+   * their index in the sorted route table.  An exact match costs one hash, a
+   * short linear probe and one string compare.  The load factor is kept at or
+   * below one half, so misses usually terminate at the first empty slot.
+   */
+  struct StaticIndex
+  {
+    static constexpr auto npos = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * Add the specified static path.
+     * @param path The configured path.
+     * @param route The index of the route in the sorted route table.
+     */
+    void insert( std::string_view path, std::size_t route )
+    {
+      if ( 2 * ( count + 1 ) > slots.size() ) grow();
+      place( Slot{ std::string{ path }, hash( path ), route } );
+      ++count;
+    }
+
+    /**
+     * Adjust route indices after a route has been inserted into the sorted table.
+     * @param from The position at which the new route was inserted.  All indices
+     *   at or after this position are incremented.
+     */
+    void shift( std::size_t from )
+    {
+      for ( auto&& slot : slots )
+      {
+        if ( slot.route != npos && slot.route >= from ) ++slot.route;
+      }
+    }
+
+    /**
+     * Adjust route indices after a route has been removed from the sorted table,
+     * removing its path if it is a static path.
+     * @param path The configured path.
+     * @param route The position from which the route was removed.  All indices
+     *   after this position are decremented.
+     */
+    void erase( std::string_view path, std::size_t route )
+    {
+      for ( auto&& s : slots )
+      {
+        if ( s.route != npos && s.route > route ) --s.route;
+      }
+      if ( find( path ) != route ) return;
+
+      // Backward shift deletion, so probe sequences stay unbroken without tombstones
+      const auto mask = slots.size() - 1;
+      auto i = position( path );
+      for ( auto j = ( i + 1 ) & mask; slots[j].route != npos; j = ( j + 1 ) & mask )
+      {
+        const auto home = slots[j].hash & mask;
+        if ( ( ( j - home ) & mask ) >= ( ( j - i ) & mask ) )
+        {
+          slots[i] = std::move( slots[j] );
+          i = j;
+        }
+      }
+      slots[i] = Slot{};
+      --count;
+    }
+
+    /**
+     * Find the route configured for the specified path.
+     * @param path The request path.
+     * @return The index of the route in the sorted route table or `npos`.
+     */
+    [[nodiscard]] std::size_t find( std::string_view path ) const
+    {
+      if ( count == 0 ) return npos;
+      return find( path, hash( path ) );
+    }
+
+    /**
+     * Find the route configured for the specified path, when the hash of the path
+     * has already been computed.
+     * @param path The request path.
+     * @param h The value returned by `hash( path )`.
+     * @return The index of the route in the sorted route table or `npos`.
+     */
+    [[nodiscard]] std::size_t find( std::string_view path, std::uint64_t h ) const
+    {
+      if ( count == 0 ) return npos;
+
+      const auto mask = slots.size() - 1;
+      for ( auto i = h & mask; ; i = ( i + 1 ) & mask )
+      {
+        const auto& slot = slots[i];
+        if ( slot.route == npos ) return npos;
+        if ( slot.hash == h && std::string_view{ slot.path } == path ) return slot.route;
+      }
+    }
+
+    /**
+     * Find the route configured for the specified path in any case, when the
+     * configured paths were folded to lower case before they were added.
+     * @param path The request path, in any case.
+     * @param h The value returned by `foldedHash( path )`.
+     * @return The index of the route in the sorted route table or `npos`.
+     */
+    [[nodiscard]] std::size_t findFolded( std::string_view path, std::uint64_t h ) const
+    {
+      if ( count == 0 ) return npos;
+
+      const auto mask = slots.size() - 1;
+      for ( auto i = h & mask; ; i = ( i + 1 ) & mask )
+      {
+        const auto& slot = slots[i];
+        if ( slot.route == npos ) return npos;
+        if ( slot.hash == h && util::equalsFolded( slot.path, path ) ) return slot.route;
+      }
+    }
+
+    /**
+     * Prefetch the slot where the search for a path with the specified hash starts.
+     * @param h The value returned by `hash( path )`.
+     */
+    void prefetch( std::uint64_t h ) const noexcept
+    {
+      if ( count == 0 ) return;
+      impl::prefetch( &slots[h & ( slots.size() - 1 )] );
+    }
+
+  private:
+    struct Slot
+    {
+      std::string path;
+      std::uint64_t hash{ 0 };
+      std::size_t route{ npos };
+    };
+
+    [[nodiscard]] std::size_t position( std::string_view path ) const
+    {
+      const auto h = hash( path );
+      const auto mask = slots.size() - 1;
+      auto i = h & mask;
+      while ( slots[i].hash != h || std::string_view{ slots[i].path } != path ) i = ( i + 1 ) & mask;
+      return i;
+    }
+
+    void place( Slot&& slot )
+    {
+      const auto mask = slots.size() - 1;
+      auto i = slot.hash & mask;
+      while ( slots[i].route != npos ) i = ( i + 1 ) & mask;
+      slots[i] = std::move( slot );
+    }
+
+    void grow()
+    {
+      auto old = std::move( slots );
+      slots = std::vector<Slot>( old.empty() ? 16 : 2 * old.size() );
+      for ( auto&& slot : old )
+      {
+        if ( slot.route != npos ) place( std::move( slot ) );
+      }
+    }
+
+    std::vector<Slot> slots;
+    std::size_t count{ 0 };
+  };
+}
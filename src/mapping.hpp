@@ -0,0 +1,114 @@
+#pragma once
+
+#include "concat.hpp"
+#include "error.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace spt::http::router::impl
+{
+  /// A read only view of a file mapped into memory, and the owner that unmaps it when released.
+  struct MappedFile
+  {
+    std::span<const std::byte> bytes;
+    std::shared_ptr<const void> owner;
+  };
+
+  /**
+   * Map the file into memory read only.  The pages are backed by the page cache,
+   * so processes mapping the same file share them.
+   * @param file The path to the file.
+   * @return The mapped bytes, valid for as long as the owner is held.
+   * @throws std::system_error If the file cannot be opened or mapped.
+   * @throws InvalidImageError If the file is empty.
+   */
+  inline MappedFile map( const std::string& file )
+  {
+    using std::operator""sv;
+
+#ifdef _WIN32
+    auto handle = ::CreateFileA( file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if ( handle == INVALID_HANDLE_VALUE )
+    {
+      throw std::system_error( static_cast<int>( ::GetLastError() ), std::system_category(), util::concat( "Unable to open "sv, file ) );
+    }
+
+    auto size = LARGE_INTEGER{};
+    if ( !::GetFileSizeEx( handle, &size ) )
+    {
+      const auto error = static_cast<int>( ::GetLastError() );
+      ::CloseHandle( handle );
+      throw std::system_error( error, std::system_category(), util::concat( "Unable to read size of "sv, file ) );
+    }
+    if ( size.QuadPart == 0 )
+    {
+      ::CloseHandle( handle );
+      throw InvalidImageError{ util::concat( "Empty file "sv, file ) };
+    }
+
+    auto mapping = ::CreateFileMappingA( handle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    ::CloseHandle( handle );
+    if ( mapping == nullptr )
+    {
+      throw std::system_error( static_cast<int>( ::GetLastError() ), std::system_category(), util::concat( "Unable to map "sv, file ) );
+    }
+
+    const auto* data = ::MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+    ::CloseHandle( mapping );
+    if ( data == nullptr )
+    {
+      throw std::system_error( static_cast<int>( ::GetLastError() ), std::system_category(), util::concat( "Unable to map "sv, file ) );
+    }
+
+    return { { static_cast<const std::byte*>( data ), static_cast<std::size_t>( size.QuadPart ) },
+        std::shared_ptr<const void>{ data, []( const void* p ) { ::UnmapViewOfFile( p ); } } };
+#else
+    const auto fd = ::open( file.c_str(), O_RDONLY );
+    if ( fd < 0 ) throw std::system_error( errno, std::generic_category(), util::concat( "Unable to open "sv, file ) );
+
+    struct stat st{};
+    if ( ::fstat( fd, &st ) != 0 )
+    {
+      const auto error = errno;
+      ::close( fd );
+      throw std::system_error( error, std::generic_category(), util::concat( "Unable to read size of "sv, file ) );
+    }
+
+    const auto size = static_cast<std::size_t>( st.st_size );
+    if ( size == 0 )
+    {
+      ::close( fd );
+      throw InvalidImageError{ util::concat( "Empty file "sv, file ) };
+    }
+
+    auto* data = ::mmap( nullptr, size, PROT_READ, MAP_SHARED, fd, 0 );
+    const auto error = errno;
+    ::close( fd );
+    if ( data == MAP_FAILED ) throw std::system_error( error, std::generic_category(), util::concat( "Unable to map "sv, file ) );
+
+    return { { static_cast<const std::byte*>( data ), size },
+        std::shared_ptr<const void>{ data, [size]( const void* p ) { ::munmap( const_cast<void*>( p ), size ); } } };
+#endif
+  }
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "concat.hpp"
+#include "error.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace spt::http::router
+{
+  /**
+   * The standard HTTP methods/verbs.  Requests using these are resolved without
+   * any string comparisons against the configured routes.
+   */
+  enum class Method : std::uint8_t
+  {
+    Get, Head, Post, Put, Delete, Connect, Options, Trace, Patch, Other
+  };
+
+  namespace impl
+  {
+    /// Identifier of a method/verb.  Standard methods use the `Method` value, custom methods follow.
+    using MethodId = std::uint8_t;
+
+    /// The number of standard methods, each of which has a fixed slot in a route.
+    constexpr std::size_t StandardMethods = static_cast<std::size_t>( Method::Other );
+
+    /// The maximum number of distinct methods (standard plus custom) a router supports.
+    constexpr std::size_t MaxMethods = 64;
+
+    /// Identifier returned for a method that has not been configured for any route.
+    constexpr MethodId UnknownMethod = 0xff;
+
+    constexpr std::array<std::string_view, StandardMethods> MethodNames{
+      "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH"
+    };
+
+    /**
+     * Parse the specified method/verb into one of the standard methods.  Comparison is
+     * case-sensitive, as method names are.
+     * @param method The method/verb as received from the client.
+     * @return The standard method, or `Method::Other` if not a standard method.
+     */
+    constexpr Method parse( std::string_view method ) noexcept
+    {
+      using std::operator""sv;
+      switch ( method.size() )
+      {
+      case 3:
+        if ( method == "GET"sv ) return Method::Get;
+        if ( method == "PUT"sv ) return Method::Put;
+        break;
+      case 4:
+        if ( method == "POST"sv ) return Method::Post;
+        if ( method == "HEAD"sv ) return Method::Head;
+        break;
+      case 5:
+        if ( method == "PATCH"sv ) return Method::Patch;
+        if ( method == "TRACE"sv ) return Method::Trace;
+        break;
+      case 6:
+        if ( method == "DELETE"sv ) return Method::Delete;
+        break;
+      case 7:
+        if ( method == "OPTIONS"sv ) return Method::Options;
+        if ( method == "CONNECT"sv ) return Method::Connect;
+        break;
+      default:
+        break;
+      }
+      return Method::Other;
+    }
+
+    constexpr std::uint64_t bit( MethodId id ) noexcept
+    {
+      return id < MaxMethods ? std::uint64_t{ 1 } << id : 0;
+    }
+
+    /**
+     * Registry of the methods configured in a router.  Standard methods map to their
+     * enum value, custom methods (`PURGE`, `PROPFIND`...) are kept in an overflow table
+     * and numbered after the standard methods.
+     */
+    struct Methods
+    {
+      /**
+       * Resolve the identifier for the method received in a request.
+       * @param method The method/verb as received from the client.
+       * @return The identifier, or `UnknownMethod` if not a standard method and not
+       *   configured as a custom method.
+       */
+      [[nodiscard]] MethodId find( std::string_view method ) const noexcept
+      {
+        if ( const auto m = parse( method ); m != Method::Other ) return static_cast<MethodId>( m );
+        for ( std::size_t i = 0; i < custom.size(); ++i )
+        {
+          if ( custom[i] == method ) return static_cast<MethodId>( StandardMethods + i );
+        }
+        return UnknownMethod;
+      }
+
+      /**
+       * Resolve the identifier for the method being configured, adding it to the
+       * overflow table if it is a new custom method.
+       * @param method The method/verb being configured.
+       * @return The identifier for the method.
+       * @throws InvalidMethodError If the maximum number of distinct methods has been reached.
+       */
+      MethodId intern( std::string_view method )
+      {
+        const auto id = resolve( method );
+        if ( id == size() ) custom.emplace_back( method );
+        return id;
+      }
+
+      /**
+       * Resolve the identifier `intern` would return for the method being
+       * configured, without adding it to the overflow table.  Lets callers
+       * validate a route before modifying the table.
+       * @param method The method/verb being configured.
+       * @return The identifier for the method, `size()` if a new custom method.
+       * @throws InvalidMethodError If the maximum number of distinct methods has been reached.
+       */
+      [[nodiscard]] MethodId resolve( std::string_view method ) const
+      {
+        using std::operator""sv;
+        if ( const auto id = find( method ); id != UnknownMethod ) return id;
+        if ( StandardMethods + custom.size() >= MaxMethods )
+        {
+          throw InvalidMethodError{ util::concat( "Too many distinct methods configured, cannot add "sv, method ) };
+        }
+        return static_cast<MethodId>( StandardMethods + custom.size() );
+      }
+
+      /// The number of method identifiers in use, standard methods included.
+      [[nodiscard]] std::size_t size() const noexcept { return StandardMethods + custom.size(); }
+
+      [[nodiscard]] std::string_view name( MethodId id ) const noexcept
+      {
+        if ( id < StandardMethods ) return MethodNames[id];
+        return custom[id - StandardMethods];
+      }
+
+    private:
+      std::vector<std::string> custom;
+    };
+  }
+}
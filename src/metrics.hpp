@@ -0,0 +1,245 @@
+#pragma once
+
+#include "method.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace spt::http::router
+{
+  /**
+   * Histogram of handler latency.  Bucket `0` counts latencies under 1ns, and
+   * bucket `i` latencies in `[2^(i-1), 2^i)` nanoseconds.  The last bucket also
+   * counts all latencies above its lower bound (about 1 second).
+   */
+  struct LatencyHistogram
+  {
+    static constexpr std::size_t Buckets = 32;
+
+    /// Exclusive upper bound in nanoseconds of the bucket, except for the last bucket which is unbounded.
+    static constexpr std::uint64_t bound( std::size_t bucket ) noexcept { return std::uint64_t{ 1 } << bucket; }
+
+    /// Bucket that counts the latency.
+    static constexpr std::size_t bucket( std::uint64_t nanos ) noexcept
+    {
+      return std::min<std::size_t>( static_cast<std::size_t>( std::bit_width( nanos ) ), Buckets - 1 );
+    }
+
+    [[nodiscard]] std::uint64_t count() const noexcept
+    {
+      std::uint64_t total = 0;
+      for ( const auto c : counts ) total += c;
+      return total;
+    }
+
+    std::array<std::uint64_t, Buckets> counts{};
+    /// Total of the recorded latencies in nanoseconds.
+    std::uint64_t sum{ 0 };
+  };
+
+  /// Counters for a method configured for a path.
+  struct MethodStats
+  {
+    std::string method;
+    std::uint64_t requests{ 0 };
+    /// Requests for which the handler threw an exception.
+    std::uint64_t errors{ 0 };
+    LatencyHistogram latency{};
+  };
+
+  /// Counters for a configured path.
+  struct PathStats
+  {
+    std::string path;
+    /// Requests that matched the path with a method that is not configured.
+    std::uint64_t methodNotAllowed{ 0 };
+    std::vector<MethodStats> methods;
+  };
+
+  /// Counters for a HttpRouter, aggregated across threads.
+  struct RouterStats
+  {
+    /// Requests that did not match any configured path.
+    std::uint64_t notFound{ 0 };
+    std::vector<PathStats> paths;
+  };
+
+  namespace impl
+  {
+    /// Sequence number of the current thread, used to spread threads over stripes.
+    inline std::size_t threadIndex() noexcept
+    {
+      static std::atomic<std::size_t> next{ 0 };
+      thread_local const auto value = next.fetch_add( 1, std::memory_order_relaxed );
+      return value;
+    }
+
+    // Assumes 64 byte cache lines, as for the snapshot read indicators.  Threads are
+    // spread over the stripes, so increments are only contended when more threads
+    // than stripes record concurrently.
+    inline constexpr std::size_t MetricStripes = 16;
+
+    /// Counter striped over cache lines.
+    class Counter
+    {
+    public:
+      void increment() noexcept
+      {
+        stripes[threadIndex() % MetricStripes].value.fetch_add( 1, std::memory_order_relaxed );
+      }
+
+      [[nodiscard]] std::uint64_t load() const noexcept
+      {
+        std::uint64_t total = 0;
+        for ( const auto& s : stripes ) total += s.value.load( std::memory_order_relaxed );
+        return total;
+      }
+
+    private:
+      struct alignas( 64 ) Stripe
+      {
+        std::atomic<std::uint64_t> value{ 0 };
+      };
+
+      std::array<Stripe, MetricStripes> stripes{};
+    };
+
+    /// Request and error counts and handler latency for a method configured for a path.
+    class RouteMetrics
+    {
+    public:
+      /**
+       * Record a request handled by the handler.
+       * @param elapsed The time taken by the handler.
+       * @param error If the handler threw an exception.
+       */
+      void record( std::chrono::nanoseconds elapsed, bool error ) noexcept
+      {
+        auto& stripe = stripes[threadIndex() % MetricStripes];
+        const auto nanos = static_cast<std::uint64_t>( std::max<std::chrono::nanoseconds::rep>( elapsed.count(), 0 ) );
+        stripe.latency[LatencyHistogram::bucket( nanos )].fetch_add( 1, std::memory_order_relaxed );
+        stripe.sum.fetch_add( nanos, std::memory_order_relaxed );
+        if ( error ) stripe.errors.fetch_add( 1, std::memory_order_relaxed );
+      }
+
+      /**
+       * Add the values recorded on all threads to the stats.
+       * @param stats The stats to add to.
+       */
+      void read( MethodStats& stats ) const noexcept
+      {
+        for ( const auto& stripe : stripes )
+        {
+          stats.errors += stripe.errors.load( std::memory_order_relaxed );
+          stats.latency.sum += stripe.sum.load( std::memory_order_relaxed );
+          for ( std::size_t i = 0; i < LatencyHistogram::Buckets; ++i )
+          {
+            stats.latency.counts[i] += stripe.latency[i].load( std::memory_order_relaxed );
+          }
+        }
+        stats.requests = stats.latency.count();
+      }
+
+      /// Requests for which the handler threw an exception, recorded on all threads.
+      [[nodiscard]] std::uint64_t errors() const noexcept
+      {
+        std::uint64_t total = 0;
+        for ( const auto& stripe : stripes ) total += stripe.errors.load( std::memory_order_relaxed );
+        return total;
+      }
+
+    private:
+      // Every request lands in exactly one bucket, so the request count is the sum of the buckets
+      struct alignas( 64 ) Stripe
+      {
+        std::array<std::atomic<std::uint64_t>, LatencyHistogram::Buckets> latency{};
+        std::atomic<std::uint64_t> sum{ 0 };
+        std::atomic<std::uint64_t> errors{ 0 };
+      };
+
+      std::array<Stripe, MetricStripes> stripes{};
+    };
+
+    /// The metrics for a path, and for each method configured for the path.
+    struct PathMetrics
+    {
+      [[nodiscard]] RouteMetrics* find( MethodId method ) const noexcept
+      {
+        for ( auto&& [m, metrics] : methods ) if ( m == method ) return metrics;
+        return nullptr;
+      }
+
+      void add( MethodId method, RouteMetrics* metrics ) { methods.emplace_back( method, metrics ); }
+      void remove( MethodId method ) { std::erase_if( methods, [method]( const auto& m ) { return m.first == method; } ); }
+
+      Counter* methodNotAllowed{ nullptr };
+      std::vector<std::pair<MethodId, RouteMetrics*>> methods;
+    };
+
+    /// Placeholder for PathMetrics when metrics are compiled out.
+    struct NoMetrics {};
+
+    /**
+     * Helpers to write metrics in the Prometheus text exposition format, appending
+     * to the output without intermediate strings.
+     */
+    namespace prometheus
+    {
+      // Upper bounds in seconds of the histogram buckets written, every other
+      // power of two from 2^10 to 2^30 nanoseconds (about 1µs to 1s)
+      inline constexpr std::size_t FirstBucket = 10;
+      inline constexpr std::size_t BucketStep = 2;
+      inline constexpr std::array<std::string_view, 11> Bounds{
+          "1.024e-06", "4.096e-06", "1.6384e-05", "6.5536e-05", "0.000262144", "0.001048576",
+          "0.004194304", "0.016777216", "0.067108864", "0.268435456", "1.073741824" };
+
+      inline void number( std::string& out, std::uint64_t value )
+      {
+        char buffer[24];
+        const auto [end, ec] = std::to_chars( std::begin( buffer ), std::end( buffer ), value );
+        out.append( buffer, end );
+      }
+
+      /// Write nanoseconds as seconds, with the 9 fractional digits.
+      inline void seconds( std::string& out, std::uint64_t nanos )
+      {
+        number( out, nanos / 1'000'000'000 );
+        char buffer[10] = { '.', '0', '0', '0', '0', '0', '0', '0', '0', '0' };
+        auto fraction = nanos % 1'000'000'000;
+        for ( auto i = 9; i > 0 && fraction != 0; --i, fraction /= 10 ) buffer[i] = static_cast<char>( '0' + fraction % 10 );
+        out.append( buffer, sizeof( buffer ) );
+      }
+
+      /// Write a label value, escaping `\`, `"` and new lines.  A trailing `~` (wildcard) is written as `*`.
+      inline void label( std::string& out, std::string_view value )
+      {
+        for ( std::size_t i = 0; i < value.size(); ++i )
+        {
+          const auto c = value[i];
+          if ( c == '\\' ) out.append( "\\\\" );
+          else if ( c == '"' ) out.append( "\\\"" );
+          else if ( c == '\n' ) out.append( "\\n" );
+          else if ( c == '~' && i == value.size() - 1 ) out.push_back( '*' );
+          else out.push_back( c );
+        }
+      }
+
+      /// Write the `# HELP` and `# TYPE` lines for a metric family.
+      inline void family( std::string& out, std::string_view name, std::string_view type, std::string_view help )
+      {
+        out.append( "# HELP " ).append( name ).append( " " ).append( help ).append( "\n" );
+        out.append( "# TYPE " ).append( name ).append( " " ).append( type ).append( "\n" );
+      }
+    }
+  }
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#include <immintrin.h>
+#endif
+
+namespace spt::util
+{
+  namespace detail
+  {
+    constexpr int hexDigit( char c ) noexcept
+    {
+      if ( c >= '0' && c <= '9' ) return c - '0';
+      if ( c >= 'a' && c <= 'f' ) return c - 'a' + 10;
+      if ( c >= 'A' && c <= 'F' ) return c - 'A' + 10;
+      return -1;
+    }
+
+    // RFC 3986 unreserved characters, which are equivalent to their percent-encoded form
+    constexpr bool unreserved( char c ) noexcept
+    {
+      return ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) || ( c >= '0' && c <= '9' ) ||
+          c == '-' || c == '.' || c == '_' || c == '~';
+    }
+
+    /// The unreserved character encoded at `i` (a `%`), or `0` if it is not one.
+    constexpr char encodedUnreserved( std::string_view path, std::size_t i ) noexcept
+    {
+      if ( i + 2 >= path.size() ) return 0;
+      const auto hi = hexDigit( path[i + 1] );
+      const auto lo = hexDigit( path[i + 2] );
+      if ( hi < 0 || lo < 0 ) return 0;
+      const auto c = static_cast<char>( hi << 4 | lo );
+      return unreserved( c ) ? c : 0;
+    }
+
+    /// Check if the `/` or `%` at `i` starts something that normalisation rewrites.
+    constexpr bool changes( std::string_view path, std::size_t i ) noexcept
+    {
+      if ( path[i] == '%' ) return encodedUnreserved( path, i ) != 0;
+
+      // An empty, `.` or `..` segment
+      const auto segment = path.substr( i + 1, path.find( '/', i + 1 ) - ( i + 1 ) );
+      if ( segment.empty() ) return i + 1 < path.size();
+      return segment == "." || segment == "..";
+    }
+
+    /**
+     * The position of the first `/` or `%` that normalisation rewrites, or the
+     * size of the path if it is already normal.  Candidates (`//`, `/.` and `%`)
+     * are found 32 (AVX2) or 16 (SSE2) bytes at a time, comparing each block
+     * with the block one byte further on for the byte after a `/`.
+     */
+    inline std::size_t dirty( std::string_view path ) noexcept
+    {
+      const auto* data = path.data();
+      const auto size = path.size();
+      std::size_t i = 0;
+
+#if defined(__AVX2__)
+      for ( ; i + 33 <= size; i += 32 )
+      {
+        const auto block = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( data + i ) );
+        const auto next = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( data + i + 1 ) );
+        const auto follows = _mm256_or_si256( _mm256_cmpeq_epi8( next, _mm256_set1_epi8( '/' ) ),
+            _mm256_cmpeq_epi8( next, _mm256_set1_epi8( '.' ) ) );
+        const auto candidate = _mm256_or_si256( _mm256_and_si256( _mm256_cmpeq_epi8( block, _mm256_set1_epi8( '/' ) ), follows ),
+            _mm256_cmpeq_epi8( block, _mm256_set1_epi8( '%' ) ) );
+        auto mask = static_cast<std::uint32_t>( _mm256_movemask_epi8( candidate ) );
+        for ( ; mask != 0; mask &= mask - 1 )
+        {
+          const auto position = i + std::countr_zero( mask );
+          if ( changes( path, position ) ) return position;
+        }
+      }
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+      for ( ; i + 17 <= size; i += 16 )
+      {
+        const auto block = _mm_loadu_si128( reinterpret_cast<const __m128i*>( data + i ) );
+        const auto next = _mm_loadu_si128( reinterpret_cast<const __m128i*>( data + i + 1 ) );
+        const auto follows = _mm_or_si128( _mm_cmpeq_epi8( next, _mm_set1_epi8( '/' ) ),
+            _mm_cmpeq_epi8( next, _mm_set1_epi8( '.' ) ) );
+        const auto candidate = _mm_or_si128( _mm_and_si128( _mm_cmpeq_epi8( block, _mm_set1_epi8( '/' ) ), follows ),
+            _mm_cmpeq_epi8( block, _mm_set1_epi8( '%' ) ) );
+        auto mask = static_cast<std::uint32_t>( _mm_movemask_epi8( candidate ) );
+        for ( ; mask != 0; mask &= mask - 1 )
+        {
+          const auto position = i + std::countr_zero( mask );
+          if ( changes( path, position ) ) return position;
+        }
+      }
+#endif
+
+      for ( ; i < size; ++i )
+      {
+        const auto candidate = data[i] == '%' || ( data[i] == '/' && i + 1 < size && ( data[i + 1] == '/' || data[i + 1] == '.' ) );
+        if ( candidate && changes( path, i ) ) return i;
+      }
+      return size;
+    }
+
+    /**
+     * Rewrite the path into the output, copying the segments before the first
+     * change as they are.  Segments are decoded as they are copied, so that
+     * encoded dots (`%2E%2E`) are removed as well.
+     * @param path The path.
+     * @param first The position of the first change, as returned by `dirty`.
+     * @param out The output, at least as large as the path.
+     * @return The size of the normalised path.
+     */
+    inline std::size_t rewrite( std::string_view path, std::size_t first, char* out ) noexcept
+    {
+      // The start of the segment with the first change, the path starts with `/`
+      auto from = first;
+      while ( path[from] != '/' ) --from;
+      std::memcpy( out, path.data(), from );
+
+      auto n = from;
+      auto p = from;
+      while ( p < path.size() )
+      {
+        const auto end = std::min( path.find( '/', p + 1 ), path.size() );
+        const auto last = end == path.size();
+        if ( end == p + 1 )
+        {
+          // Empty segments are dropped, apart from a trailing slash
+          if ( last ) out[n++] = '/';
+          p = end;
+          continue;
+        }
+
+        const auto mark = n;
+        out[n++] = '/';
+        for ( auto i = p + 1; i < end; ++i )
+        {
+          const auto c = path[i] == '%' ? encodedUnreserved( path, i ) : 0;
+          if ( c != 0 )
+          {
+            out[n++] = c;
+            i += 2;
+          }
+          else out[n++] = path[i];
+        }
+
+        const auto segment = std::string_view{ out + mark + 1, n - mark - 1 };
+        if ( segment == "." || segment == ".." )
+        {
+          n = mark;
+          if ( segment == ".." ) while ( n > 0 && out[--n] != '/' ) {}
+          if ( last ) out[n++] = '/';
+        }
+        p = end;
+      }
+      return n;
+    }
+
+    /// Skip the scheme and authority of an absolute-form target (`http://host/path`).
+    constexpr std::string_view origin( std::string_view target ) noexcept
+    {
+      if ( target.starts_with( '/' ) ) return target;
+
+      const auto colon = target.find( "://" );
+      if ( colon == std::string_view::npos || colon == 0 ) return target;
+
+      for ( std::size_t i = 0; i < colon; ++i )
+      {
+        const auto c = target[i];
+        const auto alpha = ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' );
+        if ( !alpha && ( i == 0 || !( ( c >= '0' && c <= '9' ) || c == '+' || c == '-' || c == '.' ) ) ) return target;
+      }
+
+      const auto slash = target.find( '/', colon + 3 );
+      if ( slash == std::string_view::npos ) return "/";
+      return target.substr( slash );
+    }
+  }
+
+  /**
+   * Normalise a request path before it is matched, so that equivalent paths
+   * match the same route.
+   *   - The scheme and authority of an absolute-form target are skipped
+   *     (`http://host/a` is `/a`).
+   *   - Empty segments are removed (`//a//b` is `/a/b`), although a trailing
+   *     slash is kept.
+   *   - `.` and `..` segments are removed (`/a/./b/../c` is `/a/c`).
+   *   - Percent-encoded unreserved characters are decoded (`/%7Euser` is
+   *     `/~user`).  Other escapes, such as `%2F`, are left as they are, since
+   *     decoding them would change the segments of the path.
+   *
+   * A path that is already normal is checked 16 or 32 bytes at a time, and
+   * returned as is without copying.  Otherwise the path is rewritten from the
+   * first segment that changes, in a single pass into the buffer.  The result
+   * is never longer than the path.  Paths that do not start with `/` (such as
+   * `*`) are returned as is.
+   * @param path The path, without the query string.
+   * @param buffer Holds the normalised path if it needs rewriting.  Must be at
+   *   least as large as the path.
+   * @return The normalised path, a view of either the path or the buffer.
+   *   std::nullopt if the path needs rewriting and the buffer is too small.
+   */
+  inline std::optional<std::string_view> normalise( std::string_view path, std::span<char> buffer ) noexcept
+  {
+    path = detail::origin( path );
+    if ( !path.starts_with( '/' ) ) return path;
+
+    const auto first = detail::dirty( path );
+    if ( first == path.size() ) return path;
+    if ( buffer.size() < path.size() ) return std::nullopt;
+
+    return std::string_view{ buffer.data(), detail::rewrite( path, first, buffer.data() ) };
+  }
+
+  /**
+   * Normalise a request path, as for the overload taking a span.  The buffer is
+   * resized only if the path needs rewriting, so a buffer reused across requests
+   * does not allocate once it has grown to the size of the longest path.
+   * @param path The path, without the query string.
+   * @param buffer Holds the normalised path if it needs rewriting.
+   * @return The normalised path, a view of either the path or the buffer.
+   */
+  inline std::string_view normalise( std::string_view path, std::string& buffer )
+  {
+    path = detail::origin( path );
+    if ( !path.starts_with( '/' ) ) return path;
+
+    const auto first = detail::dirty( path );
+    if ( first == path.size() ) return path;
+
+    if ( buffer.size() < path.size() ) buffer.resize( path.size() );
+    return std::string_view{ buffer.data(), detail::rewrite( path, first, buffer.data() ) };
+  }
+}
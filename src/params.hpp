@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace spt::http::router
+{
+  /**
+   * Fixed capacity map of path parameters that does not allocate.  Keys and
+   * values are stored as `std::string_view` in an inline array, and looked up by
+   * linear scan, which for the handful of parameters in a typical path is faster
+   * than the ordered inserts of `std::map` or `boost::container::flat_map`.
+   *
+   * Interface compatible with the subset of `std::map` used by handlers, so
+   * may be specified as the *Map* template parameter of the router.  The router
+   * rejects routes with more parameters (including the wildcard) than the capacity.
+   * @tparam N The maximum number of parameters.
+   */
+  template <std::size_t N = 8>
+  class InlineParams
+  {
+  public:
+    using key_type = std::string_view;
+    using mapped_type = std::string_view;
+    using value_type = std::pair<key_type, mapped_type>;
+    using size_type = std::size_t;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+
+    InlineParams() = default;
+    ~InlineParams() = default;
+    InlineParams(const InlineParams&) = default;
+    InlineParams& operator=(const InlineParams&) = default;
+    InlineParams(InlineParams&&) noexcept = default;
+    InlineParams& operator=(InlineParams&&) noexcept = default;
+
+    [[nodiscard]] static constexpr size_type capacity() noexcept { return N; }
+    [[nodiscard]] static constexpr size_type max_size() noexcept { return N; }
+
+    [[nodiscard]] size_type size() const noexcept { return used; }
+    [[nodiscard]] bool empty() const noexcept { return used == 0; }
+    void clear() noexcept { used = 0; }
+
+    [[nodiscard]] iterator begin() noexcept { return items.data(); }
+    [[nodiscard]] iterator end() noexcept { return items.data() + used; }
+    [[nodiscard]] const_iterator begin() const noexcept { return items.data(); }
+    [[nodiscard]] const_iterator end() const noexcept { return items.data() + used; }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+    [[nodiscard]] iterator find( key_type key ) noexcept
+    {
+      for ( auto it = begin(); it != end(); ++it ) if ( it->first == key ) return it;
+      return end();
+    }
+
+    [[nodiscard]] const_iterator find( key_type key ) const noexcept
+    {
+      for ( auto it = begin(); it != end(); ++it ) if ( it->first == key ) return it;
+      return end();
+    }
+
+    [[nodiscard]] bool contains( key_type key ) const noexcept { return find( key ) != end(); }
+    [[nodiscard]] size_type count( key_type key ) const noexcept { return contains( key ) ? 1 : 0; }
+
+    /**
+     * Insert the key and value if the key does not exist.
+     * @return Iterator to the entry with the key, and whether the value was inserted.
+     * @throws std::length_error If the key does not exist and the map is full.
+     */
+    std::pair<iterator, bool> try_emplace( key_type key, mapped_type value )
+    {
+      if ( auto it = find( key ); it != end() ) return { it, false };
+      if ( used == N ) throw std::length_error{ "InlineParams capacity exceeded" };
+      items[used] = { key, value };
+      return { &items[used++], true };
+    }
+
+    /**
+     * Access the value for the key, inserting an empty value if the key does not exist.
+     * @throws std::length_error If the key does not exist and the map is full.
+     */
+    mapped_type& operator[]( key_type key ) { return try_emplace( key, {} ).first->second; }
+
+    /**
+     * Access the value for the key.
+     * @throws std::out_of_range If the key does not exist.
+     */
+    [[nodiscard]] const mapped_type& at( key_type key ) const
+    {
+      if ( auto it = find( key ); it != end() ) return it->second;
+      throw std::out_of_range{ "InlineParams key not found" };
+    }
+
+  private:
+    std::array<value_type, N> items{};
+    size_type used{ 0 };
+  };
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace spt::http::router
+{
+  /// A parameter in the query string, as it appears in the request target.
+  struct QueryParam
+  {
+    /// The key, still percent-encoded.
+    std::string_view key;
+    /// The value, still percent-encoded.  Empty if the parameter has no `=`.
+    std::string_view value;
+
+    bool operator==( const QueryParam& ) const = default;
+  };
+
+  namespace impl
+  {
+    constexpr int hexValue( char c ) noexcept
+    {
+      if ( c >= '0' && c <= '9' ) return c - '0';
+      if ( c >= 'a' && c <= 'f' ) return c - 'a' + 10;
+      if ( c >= 'A' && c <= 'F' ) return c - 'A' + 10;
+      return -1;
+    }
+
+    /// The decoded byte at `i` of the form encoded text, advancing `i` past it.
+    constexpr char decodeAt( std::string_view text, std::size_t& i ) noexcept
+    {
+      const auto c = text[i++];
+      if ( c == '+' ) return ' ';
+      if ( c != '%' || i + 2 > text.size() ) return c;
+
+      const auto hi = hexValue( text[i] );
+      const auto lo = hexValue( text[i + 1] );
+      if ( hi < 0 || lo < 0 ) return c;
+      i += 2;
+      return static_cast<char>( hi << 4 | lo );
+    }
+
+    /// Compare form encoded text with plain text, decoding on the fly.
+    constexpr bool decodedEquals( std::string_view encoded, std::string_view plain ) noexcept
+    {
+      std::size_t i = 0;
+      std::size_t j = 0;
+      while ( i < encoded.size() )
+      {
+        if ( j == plain.size() || decodeAt( encoded, i ) != plain[j++] ) return false;
+      }
+      return j == plain.size();
+    }
+  }
+
+  /**
+   * The parameters in the query string of a request target, such as `a=b&c=d`
+   * for `/search?a=b&c=d#top`.  A view over the text of the request target,
+   * which must outlive it.  Parameters are parsed as the view is iterated, and
+   * keys and values are left encoded, so constructing and passing the view does
+   * not allocate or copy.  Use `decode` to decode a value when it is needed,
+   * which copies only if the value contains an escape.
+   *
+   * Parameters are in the order of the query string, and duplicate keys are
+   * preserved.  `find` returns the first value for a key, `values` all of them.
+   * Keys are compared after decoding, so `find( "a[]" )` finds `a%5B%5D`.
+   */
+  class Query : public std::ranges::view_interface<Query>
+  {
+  public:
+    class Iterator
+    {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using iterator_concept = std::forward_iterator_tag;
+      using value_type = QueryParam;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const QueryParam*;
+      using reference = const QueryParam&;
+
+      constexpr Iterator() noexcept = default;
+      constexpr explicit Iterator( std::string_view text ) noexcept : rest{ text } { next(); }
+
+      constexpr reference operator*() const noexcept { return current; }
+      constexpr pointer operator->() const noexcept { return &current; }
+
+      constexpr Iterator& operator++() noexcept { next(); return *this; }
+      constexpr Iterator operator++( int ) noexcept { auto it = *this; next(); return it; }
+
+      constexpr bool operator==( const Iterator& other ) const noexcept
+      {
+        return done == other.done && rest.data() == other.rest.data() && rest.size() == other.rest.size();
+      }
+
+    private:
+      // Empty parameters (`a=b&&c=d`) are skipped
+      constexpr void next() noexcept
+      {
+        while ( !rest.empty() )
+        {
+          const auto end = rest.find( '&' );
+          const auto param = rest.substr( 0, end );
+          rest = end == std::string_view::npos ? std::string_view{} : rest.substr( end + 1 );
+          if ( param.empty() ) continue;
+
+          const auto eq = param.find( '=' );
+          current = eq == std::string_view::npos ? QueryParam{ param, {} } : QueryParam{ param.substr( 0, eq ), param.substr( eq + 1 ) };
+          return;
+        }
+        rest = {};
+        current = {};
+        done = true;
+      }
+
+      std::string_view rest{};
+      QueryParam current{};
+      bool done{ false };
+    };
+
+    constexpr Query() noexcept = default;
+
+    /// @param text The query string, without the leading `?` and any fragment.
+    constexpr explicit Query( std::string_view text ) noexcept : text{ text } {}
+
+    [[nodiscard]] constexpr Iterator begin() const noexcept { return Iterator{ text }; }
+    [[nodiscard]] constexpr Iterator end() const noexcept { return Iterator{ std::string_view{} }; }
+
+    /// @return The query string, as passed to the constructor.
+    [[nodiscard]] constexpr std::string_view raw() const noexcept { return text; }
+
+    /**
+     * The first value for the key.
+     * @param key The decoded key.
+     * @return The encoded value, or std::nullopt if the key is not present.
+     */
+    [[nodiscard]] constexpr std::optional<std::string_view> find( std::string_view key ) const noexcept
+    {
+      for ( const auto& p : *this ) if ( impl::decodedEquals( p.key, key ) ) return p.value;
+      return std::nullopt;
+    }
+
+    /// @return `true` if the key is present.
+    [[nodiscard]] constexpr bool contains( std::string_view key ) const noexcept { return find( key ).has_value(); }
+
+    /// @return The number of values for the key.
+    [[nodiscard]] constexpr std::size_t count( std::string_view key ) const noexcept
+    {
+      std::size_t n = 0;
+      for ( const auto& p : *this ) n += impl::decodedEquals( p.key, key );
+      return n;
+    }
+
+    /**
+     * All the parameters with the key, in order, for keys that may be repeated (`id=1&id=2`).
+     * @param key The decoded key.  The view refers to it, so it must outlive the view.
+     * @return A view of the matching parameters.
+     */
+    [[nodiscard]] auto values( std::string_view key ) const
+    {
+      return *this | std::views::filter( [key]( const QueryParam& p ) { return impl::decodedEquals( p.key, key ); } );
+    }
+
+    /// @return `true` if the text contains escapes (`%xx` or `+`) that need decoding.
+    [[nodiscard]] static constexpr bool encoded( std::string_view text ) noexcept
+    {
+      return text.find_first_of( "%+" ) != std::string_view::npos;
+    }
+
+    /**
+     * Decode a key or value of the query string.  Text without escapes is
+     * returned as is.  Otherwise it is decoded into the buffer, and the returned
+     * view refers to the buffer.  `+` decodes to a space, and invalid escapes are
+     * left as they are.
+     * @param text The encoded text.
+     * @param buffer Holds the decoded text if the text contains escapes.
+     * @return The decoded text.
+     */
+    static std::string_view decode( std::string_view text, std::string& buffer )
+    {
+      if ( !encoded( text ) ) return text;
+
+      buffer.clear();
+      buffer.reserve( text.size() );
+      for ( std::size_t i = 0; i < text.size(); ) buffer.push_back( impl::decodeAt( text, i ) );
+      return buffer;
+    }
+
+  private:
+    std::string_view text{};
+  };
+
+  namespace impl
+  {
+    /// A request target split into the path and query string.
+    struct Target
+    {
+      std::string_view path;
+      Query query;
+    };
+
+    /// Split the request target at the `?` and drop any `#` fragment.
+    constexpr Target target( std::string_view value ) noexcept
+    {
+      const auto end = value.find_first_of( "?#" );
+      if ( end == std::string_view::npos ) return { value, Query{} };
+
+      const auto path = value.substr( 0, end );
+      if ( value[end] == '#' ) return { path, Query{} };
+
+      const auto query = value.substr( end + 1 );
+      return { path, Query{ query.substr( 0, query.find( '#' ) ) } };
+    }
+
+    /// Invoke a handler, passing the query if the handler accepts it.
+    template <typename Handler, typename Request, typename Map>
+    decltype( auto ) call( const Handler& handler, Request&& request, Map&& params, const Query& query )
+    {
+      if constexpr ( std::is_invocable_v<const Handler&, Request, Map&&, const Query&> )
+      {
+        return std::invoke( handler, std::forward<Request>( request ), std::forward<Map>( params ), query );
+      }
+      else return std::invoke( handler, std::forward<Request>( request ), std::forward<Map>( params ) );
+    }
+  }
+}
@@ -0,0 +1,640 @@
+#pragma once
+
+#include "concat.hpp"
+#include "error.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace spt::http::router::impl
+{
+  /// Set of bytes, the label of a transition in a pattern.
+  struct CharSet
+  {
+    constexpr void add( unsigned char c ) noexcept { bits[c >> 6] |= std::uint64_t{ 1 } << ( c & 63 ); }
+
+    constexpr void add( unsigned char from, unsigned char to ) noexcept
+    {
+      for ( unsigned c = from; c <= to; ++c ) add( static_cast<unsigned char>( c ) );
+    }
+
+    constexpr void add( const CharSet& other ) noexcept
+    {
+      for ( std::size_t i = 0; i < bits.size(); ++i ) bits[i] |= other.bits[i];
+    }
+
+    constexpr void invert() noexcept { for ( auto& b : bits ) b = ~b; }
+
+    [[nodiscard]] constexpr bool has( unsigned char c ) const noexcept { return ( ( bits[c >> 6] >> ( c & 63 ) ) & 1 ) != 0; }
+
+    bool operator==( const CharSet& ) const = default;
+    auto operator<=>( const CharSet& ) const = default;
+
+    std::array<std::uint64_t, 4> bits{};
+  };
+
+  /**
+   * Recursive descent parser for the regular expressions used to constrain path
+   * parameters.  The syntax is the common subset of ECMAScript and POSIX extended
+   * expressions: literals, `.`, character classes (`[a-z]`, `[^/]`), the `\d`,
+   * `\w`, `\s` classes and their negations, groups (`(...)`, `(?:...)`),
+   * alternation and the `*`, `+`, `?` and `{n}`, `{n,}`, `{n,m}` quantifiers.
+   * Patterns always match the whole segment, a leading `^` and trailing `$` are
+   * ignored.  Backreferences, lookaround and other anchors are not supported, as
+   * they cannot be matched without backtracking.
+   *
+   * Nodes are created through the builder, so that the syntax can be checked at
+   * compile time with a builder that does not allocate.
+   * @tparam Builder Creates the nodes of the expression.
+   */
+  template <typename Builder>
+  class Parser
+  {
+  public:
+    using Node = typename Builder::Node;
+
+    /// The maximum count in a `{n,m}` quantifier.
+    static constexpr std::size_t MaxRepeat = 1000;
+    /// Marks a quantifier without an upper bound.
+    static constexpr std::size_t Unbounded = std::numeric_limits<std::size_t>::max();
+
+    constexpr Parser( std::string_view expression, Builder& builder ) noexcept : pattern{ expression }, builder{ builder }
+    {
+      if ( pattern.starts_with( '^' ) ) pattern.remove_prefix( 1 );
+      if ( pattern.ends_with( '$' ) )
+      {
+        std::size_t escapes = 0;
+        while ( escapes + 1 < pattern.size() && pattern[pattern.size() - 2 - escapes] == '\\' ) ++escapes;
+        if ( escapes % 2 == 0 ) pattern.remove_suffix( 1 );
+      }
+    }
+
+    /// Parse the pattern.  Check `error` before using the result.
+    constexpr Node parse()
+    {
+      auto node = alternation( 0 );
+      if ( error.empty() && pos < pattern.size() ) return fail( "Unbalanced )" );
+      return node;
+    }
+
+    /// The reason the pattern is invalid, empty if it is valid.
+    std::string_view error{};
+
+  private:
+    static constexpr std::size_t MaxDepth = 32;
+
+    constexpr Node fail( std::string_view reason )
+    {
+      if ( error.empty() ) error = reason;
+      return builder.empty();
+    }
+
+    [[nodiscard]] constexpr bool more() const noexcept { return error.empty() && pos < pattern.size(); }
+
+    constexpr Node alternation( std::size_t depth )
+    {
+      if ( depth > MaxDepth ) return fail( "Groups are nested too deeply" );
+
+      auto node = concatenation( depth );
+      while ( more() && pattern[pos] == '|' )
+      {
+        ++pos;
+        const auto rhs = concatenation( depth );
+        node = builder.alternate( node, rhs );
+      }
+      return node;
+    }
+
+    constexpr Node concatenation( std::size_t depth )
+    {
+      auto node = builder.empty();
+      auto first = true;
+      while ( more() && pattern[pos] != '|' && pattern[pos] != ')' )
+      {
+        const auto rhs = repetition( depth );
+        node = first ? rhs : builder.concat( node, rhs );
+        first = false;
+      }
+      return node;
+    }
+
+    constexpr Node repetition( std::size_t depth )
+    {
+      auto node = atom( depth );
+      while ( more() )
+      {
+        const auto c = pattern[pos];
+        if ( c == '*' ) node = builder.repeat( node, 0, Unbounded );
+        else if ( c == '+' ) node = builder.repeat( node, 1, Unbounded );
+        else if ( c == '?' ) node = builder.repeat( node, 0, 1 );
+        else if ( c == '{' )
+        {
+          std::size_t min = 0;
+          std::size_t max = 0;
+          if ( !bounds( min, max ) ) return fail( "Invalid {n,m} quantifier" );
+          node = builder.repeat( node, min, max );
+          continue;
+        }
+        else break;
+        ++pos;
+      }
+      return node;
+    }
+
+    // `{n}`, `{n,}` or `{n,m}`
+    constexpr bool bounds( std::size_t& min, std::size_t& max )
+    {
+      ++pos;
+      if ( !number( min ) ) return false;
+      max = min;
+      if ( pos < pattern.size() && pattern[pos] == ',' )
+      {
+        ++pos;
+        max = Unbounded;
+        if ( pos < pattern.size() && pattern[pos] != '}' && !number( max ) ) return false;
+      }
+      if ( pos >= pattern.size() || pattern[pos] != '}' ) return false;
+      ++pos;
+      return min <= max && ( max == Unbounded || max <= MaxRepeat );
+    }
+
+    constexpr bool number( std::size_t& value )
+    {
+      const auto start = pos;
+      value = 0;
+      for ( ; pos < pattern.size() && pattern[pos] >= '0' && pattern[pos] <= '9'; ++pos )
+      {
+        value = value * 10 + static_cast<std::size_t>( pattern[pos] - '0' );
+        if ( value > MaxRepeat ) return false;
+      }
+      return pos > start;
+    }
+
+    constexpr Node atom( std::size_t depth )
+    {
+      const auto c = pattern[pos++];
+      auto set = CharSet{};
+      switch ( c )
+      {
+      case '(':
+      {
+        if ( pattern.substr( pos ).starts_with( "?:" ) ) pos += 2;
+        else if ( pattern.substr( pos ).starts_with( '?' ) ) return fail( "Lookaround is not supported" );
+        const auto node = alternation( depth + 1 );
+        if ( !error.empty() ) return node;
+        if ( pos >= pattern.size() || pattern[pos] != ')' ) return fail( "Missing )" );
+        ++pos;
+        return node;
+      }
+      case '[':
+        return klass();
+      case '.':
+        set.invert();
+        return builder.set( set );
+      case '\\':
+        if ( escape( set ) < -1 ) return fail( "Unsupported escape" );
+        return builder.set( set );
+      case '*': case '+': case '?': case '{':
+        return fail( "Nothing to repeat" );
+      case '^': case '$':
+        return fail( "Anchors are only supported at the start and end of the pattern" );
+      default:
+        set.add( static_cast<unsigned char>( c ) );
+        return builder.set( set );
+      }
+    }
+
+    // Add the escaped class or character to the set.  Returns the character if
+    // a single character, -1 for a class, or less than -1 if invalid.
+    constexpr int escape( CharSet& set )
+    {
+      if ( pos >= pattern.size() ) return -2;
+
+      const auto c = pattern[pos++];
+      auto cls = CharSet{};
+      switch ( c )
+      {
+      case 'd': case 'D':
+        cls.add( '0', '9' );
+        break;
+      case 'w': case 'W':
+        cls.add( 'a', 'z' );
+        cls.add( 'A', 'Z' );
+        cls.add( '0', '9' );
+        cls.add( '_' );
+        break;
+      case 's': case 'S':
+        cls.add( ' ' );
+        cls.add( '\t', '\r' );
+        break;
+      case 't': set.add( '\t' ); return '\t';
+      case 'n': set.add( '\n' ); return '\n';
+      case 'r': set.add( '\r' ); return '\r';
+      case 'f': set.add( '\f' ); return '\f';
+      case 'v': set.add( '\v' ); return '\v';
+      default:
+        if ( ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) || ( c >= '0' && c <= '9' ) ) return -2;
+        set.add( static_cast<unsigned char>( c ) );
+        return static_cast<unsigned char>( c );
+      }
+
+      if ( c == 'D' || c == 'W' || c == 'S' ) cls.invert();
+      set.add( cls );
+      return -1;
+    }
+
+    // A single character in a class, returns -1 for an escaped class or less if invalid
+    constexpr int member( CharSet& set )
+    {
+      const auto c = pattern[pos++];
+      if ( c == '\\' ) return escape( set );
+      set.add( static_cast<unsigned char>( c ) );
+      return static_cast<unsigned char>( c );
+    }
+
+    constexpr Node klass()
+    {
+      auto set = CharSet{};
+      const auto negate = pos < pattern.size() && pattern[pos] == '^';
+      if ( negate ) ++pos;
+
+      for ( auto first = true; pos < pattern.size() && ( first || pattern[pos] != ']' ); first = false )
+      {
+        auto single = CharSet{};
+        const auto lo = member( single );
+        if ( lo < -1 ) return fail( "Unsupported escape" );
+
+        if ( lo >= 0 && pos + 1 < pattern.size() && pattern[pos] == '-' && pattern[pos + 1] != ']' )
+        {
+          ++pos;
+          auto ignored = CharSet{};
+          const auto hi = member( ignored );
+          if ( hi < 0 || hi < lo ) return fail( "Invalid range in character class" );
+          set.add( static_cast<unsigned char>( lo ), static_cast<unsigned char>( hi ) );
+        }
+        else set.add( single );
+      }
+
+      if ( pos >= pattern.size() ) return fail( "Missing ]" );
+      ++pos;
+      if ( negate ) set.invert();
+      return builder.set( set );
+    }
+
+    std::string_view pattern;
+    Builder& builder;
+    std::size_t pos{ 0 };
+  };
+
+  /// Builder that only checks the syntax of a pattern, so may be used at compile time.
+  struct Syntax
+  {
+    using Node = int;
+    constexpr Node empty() const noexcept { return 0; }
+    constexpr Node set( const CharSet& ) const noexcept { return 0; }
+    constexpr Node concat( Node, Node ) const noexcept { return 0; }
+    constexpr Node alternate( Node, Node ) const noexcept { return 0; }
+    constexpr Node repeat( Node, std::size_t, std::size_t ) const noexcept { return 0; }
+  };
+
+  /**
+   * Check the syntax of a pattern.
+   * @param pattern The regular expression.
+   * @return The reason the pattern is invalid, or an empty string if it is valid.
+   */
+  constexpr std::string_view check( std::string_view pattern )
+  {
+    auto syntax = Syntax{};
+    auto parser = Parser<Syntax>{ pattern, syntax };
+    parser.parse();
+    return parser.error;
+  }
+
+  /**
+   * Match the value against a compiled pattern.  One table lookup per byte, with
+   * no backtracking and no allocation.
+   * @param dfa The words of the automaton, as returned by `Dfa::data`.
+   * @param value The value to match.
+   * @return `true` if the whole value matches the pattern.
+   */
+  inline bool match( const std::uint16_t* dfa, std::string_view value ) noexcept
+  {
+    const auto width = std::size_t{ dfa[0] };
+    const auto* classes = dfa + 2;
+    const auto* accepting = classes + 256;
+    const auto* table = accepting + dfa[1];
+
+    std::size_t state = 1;
+    for ( const auto c : value )
+    {
+      state = table[state * width + classes[static_cast<unsigned char>( c )]];
+      if ( state == 0 ) return false;
+    }
+    return accepting[state] != 0;
+  }
+
+  /**
+   * Check that the words of an automaton not compiled by this build, such as
+   * one read from an image, can be used with `match`.
+   * @param dfa The words, starting with those of the automaton.
+   * @return `true` if the automaton fits in the words, and its byte classes and
+   *   transitions are in range.
+   */
+  inline bool wellFormed( std::span<const std::uint16_t> dfa ) noexcept
+  {
+    if ( dfa.size() < 2 ) return false;
+    const auto width = std::size_t{ dfa[0] };
+    const auto states = std::size_t{ dfa[1] };
+    if ( width == 0 || states < 2 || dfa.size() - 2 < 256 + states + states * width ) return false;
+
+    const auto classes = dfa.subspan( 2, 256 );
+    const auto table = dfa.subspan( 2 + 256 + states, states * width );
+    return std::ranges::all_of( classes, [width]( std::uint16_t c ) { return c < width; } ) &&
+        std::ranges::all_of( table, [states]( std::uint16_t s ) { return s < states; } );
+  }
+
+  /**
+   * Deterministic finite automaton compiled from a regular expression.  Bytes
+   * are mapped to the classes the pattern distinguishes between, and states to
+   * rows of a transition table indexed by class.  State `0` rejects, state `1`
+   * is the start.  The automaton is held in a single array of 16 bit words:
+   * the number of classes, the number of states, the class of each byte, a flag
+   * per state if it accepts, and the transition table.
+   */
+  class Dfa
+  {
+  public:
+    /// The maximum number of states of an automaton.
+    static constexpr std::size_t MaxStates = 4096;
+
+    /**
+     * Compile the pattern.
+     * @param pattern The regular expression, see Parser for the syntax.
+     * @return The automaton.
+     * @throws InvalidParameterError If the pattern is invalid, or too large.
+     */
+    static Dfa compile( std::string_view pattern )
+    {
+      using std::operator""sv;
+      auto nfa = Nfa{};
+      auto parser = Parser<Nfa>{ pattern, nfa };
+      const auto root = parser.parse();
+      if ( !parser.error.empty() )
+      {
+        throw InvalidParameterError{ util::concat( "Invalid pattern "sv, pattern, ". "sv, parser.error ) };
+      }
+
+      auto dfa = Dfa{};
+      if ( !nfa.build( root, dfa.words ) ) throw InvalidParameterError{ util::concat( "Pattern "sv, pattern, " is too large"sv ) };
+      return dfa;
+    }
+
+    /// @return `true` if the whole value matches the pattern.
+    [[nodiscard]] bool match( std::string_view value ) const noexcept { return impl::match( words.data(), value ); }
+
+    /// The words of the automaton.
+    [[nodiscard]] std::span<const std::uint16_t> data() const noexcept { return words; }
+
+  private:
+    // Expression tree built by the parser, converted to a Thompson NFA and then to the automaton
+    struct Nfa
+    {
+      using Node = std::uint32_t;
+
+      static constexpr auto npos = std::numeric_limits<std::uint32_t>::max();
+      static constexpr std::size_t MaxNfaStates = 1u << 16;
+
+      enum class Kind : std::uint8_t { Empty, Set, Concat, Alternate, Repeat };
+
+      struct Expression
+      {
+        Kind kind;
+        CharSet set;
+        std::uint32_t left;
+        std::uint32_t right;
+        std::size_t min;
+        std::size_t max;
+      };
+
+      // Either consumes a byte in the set and moves to `next`, or has up to two empty transitions
+      struct State
+      {
+        CharSet set{};
+        std::uint32_t next{ npos };
+        std::array<std::uint32_t, 2> empty{ npos, npos };
+      };
+
+      struct Fragment
+      {
+        std::uint32_t start;
+        std::uint32_t end;
+      };
+
+      Node add( Expression&& e ) { expressions.push_back( std::move( e ) ); return static_cast<Node>( expressions.size() - 1 ); }
+      Node empty() { return add( { Kind::Empty, {}, 0, 0, 0, 0 } ); }
+      Node set( const CharSet& s ) { return add( { Kind::Set, s, 0, 0, 0, 0 } ); }
+      Node concat( Node l, Node r ) { return add( { Kind::Concat, {}, l, r, 0, 0 } ); }
+      Node alternate( Node l, Node r ) { return add( { Kind::Alternate, {}, l, r, 0, 0 } ); }
+      Node repeat( Node n, std::size_t min, std::size_t max ) { return add( { Kind::Repeat, {}, n, 0, min, max } ); }
+
+      std::uint32_t state()
+      {
+        if ( states.size() >= MaxNfaStates ) throw TooLarge{};
+        states.emplace_back();
+        return static_cast<std::uint32_t>( states.size() - 1 );
+      }
+
+      // Link the end of a fragment, which has no transitions yet
+      void link( std::uint32_t from, std::uint32_t to ) { states[from].empty[states[from].empty[0] == npos ? 0 : 1] = to; }
+
+      Fragment emit( Node n )
+      {
+        const auto e = expressions[n];
+        switch ( e.kind )
+        {
+        case Kind::Empty:
+        {
+          const auto s = state();
+          return { s, s };
+        }
+        case Kind::Set:
+        {
+          const auto s = state();
+          const auto end = state();
+          states[s].set = e.set;
+          states[s].next = end;
+          return { s, end };
+        }
+        case Kind::Concat:
+        {
+          const auto l = emit( e.left );
+          const auto r = emit( e.right );
+          link( l.end, r.start );
+          return { l.start, r.end };
+        }
+        case Kind::Alternate:
+        {
+          const auto s = state();
+          const auto l = emit( e.left );
+          const auto r = emit( e.right );
+          const auto end = state();
+          link( s, l.start );
+          link( s, r.start );
+          link( l.end, end );
+          link( r.end, end );
+          return { s, end };
+        }
+        case Kind::Repeat:
+        {
+          const auto s = state();
+          auto current = s;
+          for ( std::size_t i = 0; i < e.min; ++i )
+          {
+            const auto f = emit( e.left );
+            link( current, f.start );
+            current = f.end;
+          }
+
+          const auto end = state();
+          if ( e.max == Parser<Nfa>::Unbounded )
+          {
+            const auto loop = state();
+            const auto f = emit( e.left );
+            link( current, loop );
+            link( loop, f.start );
+            link( loop, end );
+            link( f.end, loop );
+            return { s, end };
+          }
+
+          for ( auto i = e.min; i < e.max; ++i )
+          {
+            const auto optional = state();
+            const auto f = emit( e.left );
+            link( current, optional );
+            link( optional, f.start );
+            link( optional, end );
+            current = f.end;
+          }
+          link( current, end );
+          return { s, end };
+        }
+        }
+        return {};
+      }
+
+      // The states reachable through empty transitions that consume a byte, or accept
+      void closure( std::vector<std::uint32_t>& set, std::uint32_t accept )
+      {
+        ++stamp;
+        stack.assign( std::cbegin( set ), std::cend( set ) );
+        set.clear();
+        while ( !stack.empty() )
+        {
+          const auto s = stack.back();
+          stack.pop_back();
+          if ( marks[s] == stamp ) continue;
+          marks[s] = stamp;
+
+          const auto& st = states[s];
+          if ( st.next != npos || s == accept ) set.push_back( s );
+          for ( const auto next : st.empty ) if ( next != npos ) stack.push_back( next );
+        }
+        std::sort( std::begin( set ), std::end( set ) );
+      }
+
+      bool build( Node root, std::vector<std::uint16_t>& words )
+      {
+        auto fragment = Fragment{};
+        try { fragment = emit( root ); }
+        catch ( const TooLarge& ) { return false; }
+        marks.assign( states.size(), 0 );
+
+        // Bytes that every transition treats the same form a class
+        auto sets = std::vector<CharSet>{};
+        for ( const auto& s : states ) if ( s.next != npos ) sets.push_back( s.set );
+        std::sort( std::begin( sets ), std::end( sets ) );
+        sets.erase( std::unique( std::begin( sets ), std::end( sets ) ), std::end( sets ) );
+
+        auto classes = std::array<std::uint16_t, 256>{};
+        std::size_t width = 1;
+        for ( const auto& set : sets )
+        {
+          auto remap = std::vector<int>( 2 * width, -1 );
+          std::size_t count = 0;
+          for ( unsigned b = 0; b < 256; ++b )
+          {
+            auto& target = remap[2 * classes[b] + ( set.has( static_cast<unsigned char>( b ) ) ? 1 : 0 )];
+            if ( target < 0 ) target = static_cast<int>( count++ );
+            classes[b] = static_cast<std::uint16_t>( target );
+          }
+          width = count;
+        }
+
+        auto representative = std::vector<unsigned char>( width );
+        for ( unsigned b = 256; b-- > 0; ) representative[classes[b]] = static_cast<unsigned char>( b );
+
+        // Subset construction, state 0 is the empty set that rejects everything
+        auto subsets = std::vector<std::vector<std::uint32_t>>{ {} };
+        auto ids = std::map<std::vector<std::uint32_t>, std::uint16_t>{ { {}, 0 } };
+        auto start = std::vector<std::uint32_t>{ fragment.start };
+        closure( start, fragment.end );
+        ids.emplace( start, 1 );
+        subsets.push_back( std::move( start ) );
+
+        auto table = std::vector<std::uint16_t>{};
+        auto next = std::vector<std::uint32_t>{};
+        for ( std::size_t i = 0; i < subsets.size(); ++i )
+        {
+          const auto current = subsets[i];
+          for ( std::size_t k = 0; k < width; ++k )
+          {
+            next.clear();
+            for ( const auto s : current )
+            {
+              if ( states[s].next != npos && states[s].set.has( representative[k] ) ) next.push_back( states[s].next );
+            }
+            closure( next, fragment.end );
+
+            auto [it, inserted] = ids.try_emplace( next, static_cast<std::uint16_t>( subsets.size() ) );
+            if ( inserted )
+            {
+              if ( subsets.size() >= MaxStates ) return false;
+              subsets.push_back( next );
+            }
+            table.push_back( it->second );
+          }
+        }
+
+        words.clear();
+        words.reserve( 2 + classes.size() + subsets.size() + table.size() );
+        words.push_back( static_cast<std::uint16_t>( width ) );
+        words.push_back( static_cast<std::uint16_t>( subsets.size() ) );
+        words.insert( std::end( words ), std::cbegin( classes ), std::cend( classes ) );
+        for ( const auto& subset : subsets )
+        {
+          words.push_back( std::binary_search( std::cbegin( subset ), std::cend( subset ), fragment.end ) ? 1 : 0 );
+        }
+        words.insert( std::end( words ), std::cbegin( table ), std::cend( table ) );
+        return true;
+      }
+
+      struct TooLarge {};
+
+      std::vector<Expression> expressions;
+      std::vector<State> states;
+      std::vector<std::uint32_t> marks;
+      std::vector<std::uint32_t> stack;
+      std::uint32_t stamp{ 0 };
+    };
+
+    std::vector<std::uint16_t> words;
+  };
+}
@@ -4,13 +4,31 @@
 
 #pragma once
 
+#include "cache.hpp"
+#include "compiled.hpp"
 #include "concat.hpp"
+#include "constraint.hpp"
 #include "error.hpp"
+#include "fold.hpp"
+#include "function.hpp"
+#include "index.hpp"
+#include "method.hpp"
+#include "metrics.hpp"
+#include "normalise.hpp"
+#include "params.hpp"
+#include "query.hpp"
+#include "regex.hpp"
+#include "snapshot.hpp"
 #include "split.hpp"
+#include "trie.hpp"
 
+#include <array>
+#include <chrono>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <optional>
+#include <span>
 
 #if defined __has_include
   #if __has_include(<log/NanoLog.hpp>)
@@ -36,40 +54,91 @@
 
 namespace spt::http::router
 {
+  /// The method and path of a request routed as part of a batch.
+  struct RouteInput
+  {
+    std::string_view method;
+    std::string_view path;
+  };
+
   /**
    * Simple path based HTTP request router.  Configured paths are stored in
-   * a sorted vector, and request path matching is performed via binary search.
+   * a sorted vector.  Static paths are additionally indexed in a hash table for
+   * exact matches, and dynamic (parametrised and wildcard) paths are matched
+   * using a trie keyed on the path segments.  Requests are routed against an
+   * immutable snapshot of the routes, so routes may be added and removed while
+   * requests are being routed.  An optional match cache remembers the route and
+   * parameter positions for recently requested dynamic paths.  A case-insensitive
+   * router folds the static segments of configured paths to lower case, and
+   * compares request paths with them in any case.
    * @tparam Request User defined structure with the request context necessary for
    *   the handler function.
    * @tparam Response The response from the handler function.
    * @tparam Map The type of map to use to return the parsed path parameters.
-   *   If boost has been found defaults to boost::container::flat_map, else std::map
+   *   If boost has been found defaults to boost::container::flat_map, else std::map.
+   *   Use InlineParams for a map that does not allocate.
+   * @tparam Function The type used to hold handler functions.  Defaults to
+   *   std::function.  Use InlineFunction to hold handlers in an inline buffer
+   *   without allocating, or FunctionRef to reference callables owned by the caller.
+   *   Use a signature with a trailing `const Query&` to receive the query string
+   *   of requests routed with `routeTarget`.
+   * @tparam Memo The number of recent matches to remember per thread, checked
+   *   before the route table is searched.  Must be a power of two.  Defaults to
+   *   `0`, which disables the memo.
+   * @tparam Metrics If `true`, count requests, 404/405/500 outcomes and handler
+   *   latency per route, available from `stats()`.  Defaults to `false`, which
+   *   compiles the instrumentation out.
    */
 #ifdef HAS_BOOST
-  template <typename Request, typename Response, typename Map = boost::container::flat_map<std::string_view, std::string_view>>
+  template <typename Request, typename Response, typename Map = boost::container::flat_map<std::string_view, std::string_view>,
+      typename Function = std::function<Response( Request, Map&& )>, std::size_t Memo = 0,
+      bool Metrics = false>
 #else
-  template <typename Request, typename Response, typename Map = std::map<std::string_view, std::string_view>>
+  template <typename Request, typename Response, typename Map = std::map<std::string_view, std::string_view>,
+      typename Function = std::function<Response( Request, Map&& )>, std::size_t Memo = 0,
+      bool Metrics = false>
 #endif
-  requires (std::same_as<std::string, typename Map::key_type> && std::same_as<std::string, typename Map::mapped_type>) ||
-      (std::same_as<std::string_view, typename Map::key_type> && std::same_as<std::string_view, typename Map::mapped_type>)
+  requires ((std::same_as<std::string, typename Map::key_type> && std::same_as<std::string, typename Map::mapped_type>) ||
+      (std::same_as<std::string_view, typename Map::key_type> && std::same_as<std::string_view, typename Map::mapped_type>)) &&
+      (Memo == 0 || std::has_single_bit( Memo ))
   class HttpRouter
   {
+  public:
+    /**
+     * Request handler callback function.  Path parameters extracted are passed
+     * as either a std::map or boost::container::flat_map.
+     */
+    using Handler = Function;
+
+  private:
     struct Path
     {
-      Path( std::string&& p, std::string&& m, std::size_t h, std::string&& r = {} ) :
-        path{ std::move( p ) }, ref{ std::move( r ) }, parts{ util::split<std::string>( path ) }
+      Path( std::string&& p, impl::MethodId m, const Handler* h, std::string&& r = {} ) :
+        path{ std::move( p ) }, ref{ std::move( r ) }, parts{ segments( path ) }
       {
         using std::operator""sv;
 
         epath.reserve( path.size() );
-        for ( auto&& part : parts )
+        for ( std::size_t i = 0; i < parts.size(); ++i )
         {
+          const auto& part = parts[i];
           if ( ( part.starts_with( '{' ) && !part.ends_with( '}' ) ) || part.starts_with( ':' ) )
           {
             throw InvalidParameterError{ util::concat( "Path "sv, path, " has invalid parameter "sv, part ) };
           }
 
-          if ( part.starts_with( '{' ) ) epath.append( "/{}" );
+          if ( part.starts_with( '{' ) )
+          {
+            const auto c = impl::constraint( part );
+            if ( !c ) throw InvalidParameterError{ util::concat( "Path "sv, path, " has parameter with unknown type "sv, part ) };
+            if ( *c == Constraint::Regex )
+            {
+              if ( patterns.empty() ) patterns.resize( parts.size() );
+              patterns[i] = std::make_shared<const impl::Dfa>( impl::Dfa::compile( impl::type( part ) ) );
+            }
+            epath.append( "/{" ).append( impl::type( part ) ).append( "}" );
+            parametrised = true;
+          }
           else if ( part == "~" )
           {
             epath.append( "/" ).append( "*" );
@@ -78,8 +147,7 @@ namespace spt::http::router
           else epath.append( "/" ).append( part );
         }
 
-        methods.push_back( std::move( m ) );
-        handlers.push_back( h );
+        add( m, h );
       }
 
       ~Path() = default;
@@ -88,43 +156,112 @@ namespace spt::http::router
       Path(const Path&) = delete;
       Path& operator=(const Path&) = delete;
 
-      [[nodiscard]] std::optional<std::size_t> indexOf( const std::string& method ) const
+      void add( impl::MethodId method, const Handler* handler )
+      {
+        mask |= impl::bit( method );
+        methods.push_back( method );
+        if ( method < impl::StandardMethods ) slots[method] = handler;
+        else custom.emplace_back( method, handler );
+      }
+
+      void remove( impl::MethodId method )
+      {
+        if constexpr ( Metrics ) metrics.remove( method );
+        mask &= ~impl::bit( method );
+        std::erase( methods, method );
+        if ( method < impl::StandardMethods ) slots[method] = nullptr;
+        else std::erase_if( custom, [method]( const auto& c ) { return c.first == method; } );
+      }
+
+      [[nodiscard]] bool has( impl::MethodId method ) const { return ( mask & impl::bit( method ) ) != 0; }
+
+      static std::vector<std::string> segments( std::string_view path )
+      {
+        auto buffer = std::array<std::string_view, MaxSegments>{};
+        const auto count = util::segment( path, buffer );
+        if ( count > buffer.size() ) return util::split<std::string>( path );
+        return { buffer.begin(), buffer.begin() + count };
+      }
+
+      [[nodiscard]] const Handler* handler( impl::MethodId method ) const
       {
-        auto it = std::find( std::cbegin( methods ), std::cend( methods ), method );
-        if ( it == std::cend( methods ) ) return std::nullopt;
-        return std::distance( std::cbegin( methods ), it );
+        if ( !has( method ) ) return nullptr;
+        if ( method < impl::StandardMethods ) return slots[method];
+        for ( auto&& [m, h] : custom ) if ( m == method ) return h;
+        return nullptr;
       }
 
       std::string path;
       std::string epath;
       std::string ref;
       std::vector<std::string> parts;
-      std::vector<std::string> methods;
-      std::vector<std::size_t> handlers;
+      // Automata for the parts constrained by a regular expression, empty if there are none
+      std::vector<std::shared_ptr<const impl::Dfa>> patterns;
+      std::vector<impl::MethodId> methods;
+      std::vector<std::pair<impl::MethodId, const Handler*>> custom;
+      std::array<const Handler*, impl::StandardMethods> slots{};
+      std::uint64_t mask{ 0 };
+      [[no_unique_address]] std::conditional_t<Metrics, impl::PathMetrics, impl::NoMetrics> metrics{};
       bool wildcard{ false };
+      bool parametrised{ false };
+    };
+
+    // What was removed, so that the router can release the storage it owns
+    struct Removed
+    {
+      const Handler* handler{ nullptr };
+      const impl::RouteMetrics* metrics{ nullptr };
+      const impl::Counter* methodNotAllowed{ nullptr };
+    };
+
+    // A route being added by `addAll`, with the storage owned by the router
+    struct Pending
+    {
+      std::string_view method;
+      std::string_view path;
+      const Handler* handler{ nullptr };
+      std::string_view ref;
+      impl::RouteMetrics* metrics{ nullptr };
+      impl::Counter* methodNotAllowed{ nullptr };
+    };
+
+    // The routes as published to readers.  Handlers are owned by the router.
+    // Every modification assigns a new generation, invalidating cached and memoised matches.
+    struct Table
+    {
+      std::vector<Path> paths;
+      impl::Trie trie;
+      impl::StaticIndex statics;
+      impl::Methods methods;
+      std::uint64_t generation{ 0 };
     };
 
   public:
     using MapType [[maybe_unused]] = Map;
     struct Builder;
 
+    /// A route to configure with `addAll`.
+    struct RouteSpec
+    {
+      std::string_view method;
+      std::string_view path;
+      Handler handler;
+      std::string_view ref{};
+    };
+
     /**
      * The key in the path parameters map with the sub-path that matches a wildcard route.
      */
     static inline const auto WildcardKey = std::string{ "_wildcard_" };
 
-    /**
-     * Request handler callback function.  Path parameters extracted are passed
-     * as either a std::map or boost::container::flat_map.
-     */
-    using Handler = std::function<Response( Request, Map&& )>;
-
     /**
      * Add the specified path for the specified HTTP method/verb to the router.
-     * This is thread safe.
+     * This is thread safe, and may be invoked while requests are being routed.
+     * Must not be invoked from within a handler function of the same router.
      *
      * @param method The HTTP method/verb for which the route is configured.
      * @param path The path to configure.  Either a static (no parameters in curly braces) or parametrised value.
+     *   Parameters may be constrained to a type (`{id:int}`, `{id:hex24}`, `{id:uuid}`), see Constraint.
      * @param handler The callback function to invoke if a request path matches.
      * @param ref Optional reference to associate with the path when outputting
      *   the YAML that could be used in developing the OpenAPI Specification for the API.
@@ -133,17 +270,172 @@ namespace spt::http::router
      *   for the specified `method` already.
      * @throws InvalidParameterError If the specified `path` has parameters and
      *   use the `:<parameter>` form, or if the trailing `}` in the
-     *   `{parameter}` is missing.
+     *   `{parameter}` is missing, or if a parameter has an unknown constraint
+     *   type, or if the `Map` has a fixed capacity that is less than the number
+     *   of parameters in the `path`.
+     * @throws InvalidMethodError If `method` is a custom method and the router
+     *   has already been configured with the maximum number of distinct methods.
      */
     HttpRouter& add( std::string_view method, std::string_view path,
         Handler&& handler, std::string_view ref = {} )
     {
       auto lock = std::scoped_lock<std::mutex>{ mutex };
-      addParameter( method, path, ref );
-      handlers.push_back( std::move( handler ) );
+      auto h = std::make_unique<Handler>( std::move( handler ) );
+      auto metrics = std::unique_ptr<impl::RouteMetrics>{};
+      auto counter = std::unique_ptr<impl::Counter>{};
+      if constexpr ( Metrics )
+      {
+        metrics = std::make_unique<impl::RouteMetrics>();
+        counter = std::make_unique<impl::Counter>();
+      }
+
+      const auto key = configured( path );
+      const auto generation = impl::nextGeneration();
+      auto created = false;
+      snapshot.write( [&]( Table& table )
+      {
+        created = addParameter( table, method, key, h.get(), ref, metrics.get(), counter.get() );
+        table.generation = generation;
+      } );
+      handlers.push_back( std::move( h ) );
+      if constexpr ( Metrics )
+      {
+        routeMetrics.push_back( std::move( metrics ) );
+        if ( created ) pathMetrics.push_back( std::move( counter ) );
+      }
+      return *this;
+    }
+
+    /**
+     * Add the specified path for the specified HTTP method/verb to the router,
+     * with the handler bound at compile time.  The handler is invoked directly
+     * from the stored function, allowing the compiler to inline it.
+     *
+     * @code
+     * router.add<&listSensors>( "GET"sv, "/device/sensor/"sv );
+     * @endcode
+     * @tparam F The function (or other invocable constant) to invoke if a request path matches.
+     * @param method The HTTP method/verb for which the route is configured.
+     * @param path The path to configure.
+     * @param ref Optional reference to associate with the path.
+     * @return A reference to the router for chaining.
+     * @throws DuplicateRouteError, InvalidParameterError, InvalidMethodError as for
+     *   the overload taking a handler.
+     */
+    template <auto F>
+    requires std::is_invocable_r_v<Response, decltype( F ), Request, Map&&> ||
+        std::is_invocable_r_v<Response, decltype( F ), Request, Map&&, const Query&>
+    HttpRouter& add( std::string_view method, std::string_view path, std::string_view ref = {} )
+    {
+      if constexpr ( std::is_invocable_v<const Function&, Request, Map&&, const Query&> )
+      {
+        return add( method, path, []( Request request, Map&& params, const Query& query ) -> Response
+        {
+          return impl::call( F, std::forward<Request>( request ), std::move( params ), query );
+        }, ref );
+      }
+      else
+      {
+        return add( method, path, []( Request request, Map&& params ) -> Response
+        {
+          return std::invoke( F, std::forward<Request>( request ), std::move( params ) );
+        }, ref );
+      }
+    }
+
+    /**
+     * Add the specified routes to the router at once.  The routes are sorted
+     * once and merged into the configured routes, and duplicates and clashes are
+     * detected in a sorted pass, so configuring n routes costs O(n log n) instead
+     * of the O(n²) of adding them one at a time.  This is thread safe, and may be
+     * invoked while requests are being routed.  Must not be invoked from within a
+     * handler function of the same router.
+     *
+     * Either all the routes are added, or none are if any is invalid.  Paths with
+     * the same parameters and static segments (`/a/{id}` and `/a/{key}`) clash
+     * when configured for the same method, whether in `routes` or configured
+     * already, irrespective of the order the routes are specified in.
+     *
+     * @param routes The routes to configure.  The handlers are moved from.
+     * @return A reference to the router for chaining.
+     * @throws DuplicateRouteError, InvalidParameterError, InvalidWildcardError,
+     *   InvalidMethodError as for `add`.
+     */
+    HttpRouter& addAll( std::span<RouteSpec> routes )
+    {
+      if ( routes.empty() ) return *this;
+
+      auto lock = std::scoped_lock<std::mutex>{ mutex };
+      auto hs = std::vector<std::unique_ptr<Handler>>{};
+      auto metrics = std::vector<std::unique_ptr<impl::RouteMetrics>>{};
+      auto counters = std::vector<std::unique_ptr<impl::Counter>>{};
+      auto pending = std::vector<Pending>{};
+      auto keys = std::vector<std::string>{};
+      hs.reserve( routes.size() );
+      pending.reserve( routes.size() );
+      keys.reserve( routes.size() );
+      for ( auto& route : routes )
+      {
+        hs.push_back( std::make_unique<Handler>( std::move( route.handler ) ) );
+        const auto& key = keys.emplace_back( configured( route.path ) );
+        auto& p = pending.emplace_back( Pending{ route.method, key, hs.back().get(), route.ref, nullptr, nullptr } );
+        if constexpr ( Metrics )
+        {
+          p.metrics = metrics.emplace_back( std::make_unique<impl::RouteMetrics>() ).get();
+          p.methodNotAllowed = counters.emplace_back( std::make_unique<impl::Counter>() ).get();
+        }
+      }
+
+      const auto generation = impl::nextGeneration();
+      auto created = std::vector<bool>( routes.size() );
+      snapshot.write( [&]( Table& table )
+      {
+        addParameters( table, pending, created );
+        table.generation = generation;
+      } );
+
+      handlers.insert( std::end( handlers ), std::make_move_iterator( std::begin( hs ) ), std::make_move_iterator( std::end( hs ) ) );
+      if constexpr ( Metrics )
+      {
+        routeMetrics.insert( std::end( routeMetrics ), std::make_move_iterator( std::begin( metrics ) ), std::make_move_iterator( std::end( metrics ) ) );
+        for ( std::size_t i = 0; i < counters.size(); ++i )
+        {
+          if ( created[i] ) pathMetrics.push_back( std::move( counters[i] ) );
+        }
+      }
       return *this;
     }
 
+    /**
+     * Remove the handler configured for the specified path and HTTP method/verb.
+     * The path is removed from the router once it has no methods left.  This is
+     * thread safe, and may be invoked while requests are being routed.  Must not
+     * be invoked from within a handler function of the same router.
+     *
+     * @param method The HTTP method/verb for which the route was configured.
+     * @param path The path as configured.
+     * @return `true` if a route was removed, `false` if the path was not configured
+     *   for the method.
+     */
+    bool remove( std::string_view method, std::string_view path )
+    {
+      auto lock = std::scoped_lock<std::mutex>{ mutex };
+      auto removed = Removed{};
+      const auto key = configured( path );
+      const auto generation = impl::nextGeneration();
+      snapshot.write( [&]( Table& table )
+      {
+        removed = removeParameter( table, method, key );
+        if ( removed.handler != nullptr ) table.generation = generation;
+      } );
+      if ( removed.handler == nullptr ) return false;
+
+      std::erase_if( handlers, [&removed]( const auto& handler ) { return handler.get() == removed.handler; } );
+      std::erase_if( routeMetrics, [&removed]( const auto& metrics ) { return metrics.get() == removed.metrics; } );
+      std::erase_if( pathMetrics, [&removed]( const auto& counter ) { return counter.get() == removed.methodNotAllowed; } );
+      return true;
+    }
+
     /**
      * Attempt to route the request for specified path and method.
      * @param method The HTTP method/verb from the client.
@@ -157,29 +449,34 @@ namespace spt::http::router
     std::optional<Response> route( std::string_view method, std::string_view path,
         Request request, bool checkWithoutTrailingSlash = false ) const
     {
-      if ( method.empty() || path.empty() ) return std::nullopt;
-      try
+      return normalised( path, [&]( std::string_view p )
       {
-        auto resp = routeParameters( method, path, request );
-        if ( !resp && checkWithoutTrailingSlash && path.ends_with( '/' ) )
-        {
-          return routeParameters( method, path.substr( 0, path.size() - 1 ), request );
-        }
+        return routePath( method, p, Query{}, request, checkWithoutTrailingSlash );
+      } );
+    }
 
-        return resp;
-      }
-      catch ( const std::exception& e )
+    /**
+     * Attempt to route the request for the specified request target, the path
+     * followed by an optional query string and fragment as received from the
+     * client (`/device/sensor/?limit=10#top`).  The path is matched up to the
+     * `?` or `#`, and the query string is passed to handlers that accept a
+     * `const Query&` after the path parameters (the *Function* is a
+     * `std::function<Response( Request, Map&&, const Query& )>` or similar).
+     * The query is a view over the target, parsed lazily and without allocating.
+     * @param method The HTTP method/verb from the client.
+     * @param target The request target.
+     * @param request The custom data used by the handler callback function.
+     * @param checkWithoutTrailingSlash As for `route`, applied to the path.
+     * @return Returns std::nullopt if no configured route matches.
+     */
+    std::optional<Response> routeTarget( std::string_view method, std::string_view target,
+        Request request, bool checkWithoutTrailingSlash = false ) const
+    {
+      const auto t = impl::target( target );
+      return normalised( t.path, [&]( std::string_view p )
       {
-        if ( errorHandler )
-        {
-#ifdef HAS_LOGGER
-          LOG_WARN << "Error handling " << method << " request to " << path <<
-            ". " << e.what();
-#endif
-          return (*errorHandler)( request, {} );
-        }
-        throw;
-      }
+        return routePath( method, p, t.query, request, checkWithoutTrailingSlash );
+      } );
     }
 
     /// Check if a handler has been registered for the specified resource using the specified method/verb.
@@ -189,81 +486,223 @@ namespace spt::http::router
     ///   second indicates if the method has been configured for the resource.
     [[nodiscard]] std::tuple<bool, bool> canRoute( std::string_view method, std::string_view path ) const
     {
-      using std::operator""sv;
       if ( method.empty() || path.empty() ) return { false, false };
+      return normalised( path, [&]( std::string_view p ) { return canRoutePath( method, p ); } );
+    }
 
-      auto full = std::string{ path };
-      auto m = std::string{ method };
-      auto iter = std::lower_bound( std::cbegin( paths ), std::cend( paths ), full,
-          []( const Path& p, const std::string& pth )
-          {
-            return p.path < pth;
-          } );
-
-      if ( iter == std::cend( paths ) ) return { false, false };
-
-      if ( full == iter->path && !iter->wildcard )
-      {
-        if ( auto midx = iter->indexOf( m ); midx ) return { true, true };
-        return { true, false };
-      }
-
-      const auto parts = util::split<std::string_view>( full );
-      auto handler = -1;
-      for ( ; iter != std::cend( paths ); ++iter )
+    /**
+     * Route a batch of requests, such as those read together from a pipelined
+     * HTTP/1.1 or multiplexed HTTP/2 connection.  All the paths are resolved
+     * against the same snapshot of the routes first, in path order so that
+     * requests that share leading segments are matched one after the other, and
+     * the handlers are then invoked in input order.
+     * @param inputs The method and path of each request.
+     * @param responses Receives the response for each request, in the same order
+     *   as `inputs`.  The value is as `route` would return for the request.
+     * @param request Function invoked with the index of each input, returning the
+     *   custom data used by the handler callback function for that input.
+     * @param checkWithoutTrailingSlash As for `route`.
+     * @return The number of requests routed, the smaller of the sizes of `inputs`
+     *   and `responses`.
+     */
+    template <typename Fn>
+    requires std::is_invocable_r_v<Request, Fn&, std::size_t>
+    std::size_t routeBatch( std::span<const RouteInput> inputs, std::span<std::optional<Response>> responses,
+        Fn&& request, bool checkWithoutTrailingSlash = false ) const
+    {
+      const auto size = std::min( inputs.size(), responses.size() );
+      snapshot.read( [&]( const Table& table )
       {
-        if ( parts.size() != iter->parts.size() )
+        for ( std::size_t offset = 0; offset < size; offset += BatchSize )
         {
-          if ( !iter->wildcard ) continue;
-          if ( parts.size() < iter->parts.size() ) continue;
+          const auto count = std::min( BatchSize, size - offset );
+          auto resolved = std::array<Resolved, BatchSize>{};
+          resolveBatch( table, inputs.subspan( offset, count ), std::span{ resolved.data(), count }, foldCase );
 
-          for ( std::size_t i = 0; i < iter->parts.size(); ++i )
+          for ( std::size_t i = 0; i < count; ++i )
           {
-            auto iview = std::string_view{ iter->parts[i] };
-            if ( parts[i] == iview ) continue;
-            if ( iview != "~"sv ) break;
-
-            if ( auto midx = iter->indexOf( m ); midx ) return { true, true };
-            return { true, false };
+            const auto& input = inputs[offset + i];
+            responses[offset + i] = dispatch( table, resolved[i], input.method, input.path,
+                request( offset + i ), checkWithoutTrailingSlash );
           }
         }
+      } );
+      return size;
+    }
+
+    /**
+     * Route a batch of requests that share the same custom data.
+     * @param inputs The method and path of each request.
+     * @param responses Receives the response for each request, in the same order as `inputs`.
+     * @param request The custom data used by the handler callback function.
+     * @param checkWithoutTrailingSlash As for `route`.
+     * @return The number of requests routed, the smaller of the sizes of `inputs`
+     *   and `responses`.
+     */
+    std::size_t routeBatch( std::span<const RouteInput> inputs, std::span<std::optional<Response>> responses,
+        Request request, bool checkWithoutTrailingSlash = false ) const
+    {
+      return routeBatch( inputs, responses, [&request]( std::size_t ) -> Request { return request; },
+          checkWithoutTrailingSlash );
+    }
+
+    /**
+     * Hit and miss counters for the match cache, to help size the cache.
+     * @return The counters, all zero if the router was created without a match cache.
+     */
+    [[nodiscard]] CacheStats cacheStats() const
+    {
+      return cache ? cache->stats() : CacheStats{};
+    }
 
-        auto midx = iter->indexOf( m );
+    /**
+     * Counters for each configured path and method, aggregated across threads.
+     * Only available when the router is instrumented (`Metrics` is `true`).
+     * Counters start from zero when a route is added, and are discarded when it is removed.
+     * @return The counters for the router.
+     */
+    [[nodiscard]] RouterStats stats() const requires Metrics
+    {
+      return snapshot.read( [this]( const Table& table )
+      {
+        auto result = RouterStats{ notFoundCount.load(), {} };
+        result.paths.reserve( table.paths.size() );
+        for ( const auto& p : table.paths ) result.paths.push_back( stats( table, p ) );
+        return result;
+      } );
+    }
 
-        for ( std::size_t i = 0; i < parts.size(); ++i )
+    /**
+     * Append the counters in the Prometheus text exposition format to the output.
+     * Series are labelled with the configured path (`path`) and method (`method`).
+     * Nothing is allocated other than by growing `out`, so reuse the same string
+     * across scrapes.  Only available when the router is instrumented.
+     * <ul>
+     *   <li>`http_router_request_duration_seconds` Histogram of handler latency.
+     *     The `_count` series is the number of requests handled.</li>
+     *   <li>`http_router_errors_total` Requests for which the handler threw an exception.</li>
+     *   <li>`http_router_method_not_allowed_total` Requests for a path with a method that is not configured.</li>
+     *   <li>`http_router_not_found_total` Requests that did not match any path.</li>
+     * </ul>
+     * @param out The buffer to append to.
+     */
+    void prometheus( std::string& out ) const requires Metrics
+    {
+      snapshot.read( [this, &out]( const Table& table )
+      {
+        namespace prom = impl::prometheus;
+        using std::operator""sv;
+
+        const auto labels = [&out, &table]( const Path& p, impl::MethodId m )
         {
-          auto iview = std::string_view{ iter->parts[i] };
-          if ( parts[i] == iview )
+          out.append( "{path=\"" );
+          prom::label( out, p.path );
+          out.append( "\",method=\"" );
+          prom::label( out, table.methods.name( m ) );
+          out.push_back( '"' );
+        };
+
+        constexpr auto duration = "http_router_request_duration_seconds"sv;
+        prom::family( out, duration, "histogram"sv, "Latency of the route handler."sv );
+        auto stats = MethodStats{};
+        for ( const auto& p : table.paths )
+        {
+          for ( const auto m : p.methods )
           {
-            if ( i == parts.size() - 1 )
+            const auto* metrics = p.metrics.find( m );
+            stats.latency = LatencyHistogram{};
+            metrics->read( stats );
+
+            std::uint64_t cumulative = 0;
+            std::size_t bucket = 0;
+            for ( std::size_t i = 0; i < prom::Bounds.size(); ++i )
             {
-              if ( midx ) handler = static_cast<int>( iter->handlers[*midx] );
-              else return { true, false };
+              for ( ; bucket <= prom::FirstBucket + i * prom::BucketStep; ++bucket ) cumulative += stats.latency.counts[bucket];
+              out.append( duration ).append( "_bucket"sv );
+              labels( p, m );
+              out.append( ",le=\""sv ).append( prom::Bounds[i] ).append( "\"} "sv );
+              prom::number( out, cumulative );
+              out.push_back( '\n' );
             }
-            else continue;
+
+            const auto count = stats.latency.count();
+            out.append( duration ).append( "_bucket"sv );
+            labels( p, m );
+            out.append( ",le=\"+Inf\"} "sv );
+            prom::number( out, count );
+            out.append( "\n"sv ).append( duration ).append( "_sum"sv );
+            labels( p, m );
+            out.append( "} "sv );
+            prom::seconds( out, stats.latency.sum );
+            out.append( "\n"sv ).append( duration ).append( "_count"sv );
+            labels( p, m );
+            out.append( "} "sv );
+            prom::number( out, count );
+            out.push_back( '\n' );
           }
-          if ( iview == "~" && iter->wildcard )
+        }
+
+        prom::family( out, "http_router_errors_total"sv, "counter"sv, "Requests for which the route handler threw an exception."sv );
+        for ( const auto& p : table.paths )
+        {
+          for ( const auto m : p.methods )
           {
-            if ( midx )
-            {
-              handler = static_cast<int>( iter->handlers[*midx] );
-            }
-            else return { true, false };
+            out.append( "http_router_errors_total"sv );
+            labels( p, m );
+            out.append( "} "sv );
+            prom::number( out, p.metrics.find( m )->errors() );
+            out.push_back( '\n' );
           }
-          if ( iview[0] != '{' ) break;
+        }
+
+        prom::family( out, "http_router_method_not_allowed_total"sv, "counter"sv,
+            "Requests for a path with a method that is not configured."sv );
+        for ( const auto& p : table.paths )
+        {
+          out.append( "http_router_method_not_allowed_total{path=\""sv );
+          prom::label( out, p.path );
+          out.append( "\"} "sv );
+          prom::number( out, p.metrics.methodNotAllowed->load() );
+          out.push_back( '\n' );
+        }
+
+        prom::family( out, "http_router_not_found_total"sv, "counter"sv, "Requests that did not match any path."sv );
+        out.append( "http_router_not_found_total "sv );
+        prom::number( out, notFoundCount.load() );
+        out.push_back( '\n' );
+      } );
+    }
 
-          if ( i == parts.size() - 1 )
+    /**
+     * Compile the configured routes into a read-only router with a flat memory
+     * layout, for use once all routes have been configured.  Handlers (including
+     * the error handlers) are copied, so the compiled router does not depend on
+     * this router, and does not see routes added or removed after compiling.
+     * The compiled router matches paths as they are, so routes of a
+     * case-insensitive router only match request paths in lower case.
+     * @return The compiled router.
+     */
+    [[nodiscard]] CompiledRouter<Request, Response, Map, Function> compile() const
+    {
+      auto lock = std::scoped_lock<std::mutex>{ mutex };
+      return snapshot.read( [this]( const Table& table )
+      {
+        auto routes = std::vector<impl::CompiledRoute>{};
+        auto compiled = std::vector<Handler>{};
+        routes.reserve( table.paths.size() );
+        for ( const auto& p : table.paths )
+        {
+          auto& route = routes.emplace_back( impl::CompiledRoute{ p.path, p.parts, p.patterns, {}, p.wildcard } );
+          for ( const auto m : p.methods )
           {
-            if ( midx ) handler = static_cast<int>( iter->handlers[*midx] );
-            else return { true, false };
+            route.handlers.emplace_back( m, static_cast<std::uint32_t>( compiled.size() ) );
+            compiled.push_back( *p.handler( m ) );
           }
         }
 
-        if ( handler != -1 ) break;
-      }
-
-      using O = std::tuple<bool, bool>;
-      return handler == -1 ? O{ false, false } : O{ true, true };
+        return CompiledRouter<Request, Response, Map, Function>{ routes, table.methods, std::move( compiled ),
+            notFound, methodNotAllowed, errorHandler };
+      } );
     }
 
 #ifdef HAS_BOOST
@@ -272,16 +711,74 @@ namespace spt::http::router
      * @return JSON representation with some additional metadata about the configured routes.
      */
     [[nodiscard]] boost::json::value json() const
+    {
+      return snapshot.read( [this]( const Table& table ) { return json( table ); } );
+    }
+
+    /**
+     * Output a string representation of the configured routes.
+     * @return String representation of the routes.
+     */
+    [[nodiscard]] std::string str() const
+    {
+      return boost::json::serialize( json() );
+    }
+#endif
+
+    [[nodiscard]] std::string yaml() const
+    {
+      return snapshot.read( []( const Table& table ) { return yaml( table ); } );
+    }
+
+    /**
+     * Create a new instance of the router.
+     * @param error404 Optional handler function to handle path not found condition.
+     * @param error405  Optional handler function to handle path not configured for method condition.
+     * @param error500 Optional handler function to handle exception caught while despatching the request to handler.
+     * @param cacheCapacity Optional maximum number of dynamic paths to hold in the
+     *   match cache.  The default of `0` disables the cache.
+     * @param normalise If `true`, request paths are normalised with `util::normalise`
+     *   before they are matched, so that `//a/./b/../c`, `/%7Euser` and
+     *   `http://host/a` match the routes for `/a/c`, `/~user` and `/a`.  Paths
+     *   that are already normal are not copied.  Defaults to `false`.
+     * @param caseInsensitive If `true`, the static segments of request paths are
+     *   matched in any ASCII case, so that `/Device/SENSOR/id/AbC` matches the
+     *   route for `/device/sensor/id/{id}` with `id` of `AbC`.  Static segments
+     *   of configured paths are folded to lower case when they are added, and
+     *   request paths are compared with them without being copied.  Parameter
+     *   values are passed to constraints and handlers as they are.  Defaults to `false`.
+     */
+    HttpRouter( std::optional<Handler>&& error404 = std::nullopt,
+        std::optional<Handler>&& error405 = std::nullopt,
+        std::optional<Handler>&& error500 = std::nullopt,
+        std::size_t cacheCapacity = 0, bool normalise = false, bool caseInsensitive = false ) :
+        notFound{ std::move( error404 ) }, methodNotAllowed{ std::move( error405 ) },
+        errorHandler{ std::move( error500 ) },
+        cache{ cacheCapacity > 0 ? std::make_unique<impl::MatchCache>( cacheCapacity ) : nullptr },
+        normalisePaths{ normalise }, foldCase{ caseInsensitive }
+    {
+      handlers.reserve( 32 );
+    }
+
+    ~HttpRouter() = default;
+
+    HttpRouter(const HttpRouter&) = delete;
+    HttpRouter& operator=(const HttpRouter&) = delete;
+
+  private:
+#ifdef HAS_BOOST
+    boost::json::value json( const Table& table ) const
     {
       using std::operator""sv;
 
+      const auto& paths = table.paths;
       auto arr = boost::json::array{};
       int s = 0;
       int d = 0;
       for ( auto&& p : paths )
       {
         auto m = boost::json::array{};
-        for ( const auto& method : p.methods ) m.push_back( boost::json::value{ method } );
+        for ( const auto method : p.methods ) m.push_back( boost::json::value{ table.methods.name( method ) } );
 
         if ( p.path.ends_with( '~' ) )
         {
@@ -293,37 +790,63 @@ namespace spt::http::router
           arr.push_back( boost::json::object{ { "path", p.path }, { "methods", m } } );
         }
 
+        if constexpr ( Metrics )
+        {
+          const auto ps = stats( table, p );
+          auto ms = boost::json::object{};
+          for ( const auto& method : ps.methods )
+          {
+            auto latency = boost::json::array{};
+            for ( const auto count : method.latency.counts ) latency.push_back( count );
+            ms[method.method] = boost::json::object{
+                { "requests", method.requests },
+                { "errors", method.errors },
+                { "latency", latency }
+            };
+          }
+          arr.back().as_object()["stats"] = boost::json::object{
+              { "methodNotAllowed", ps.methodNotAllowed },
+              { "methods", ms }
+          };
+        }
+
         if ( p.path.find( "{" ) != std::string::npos ) ++d;
         else if ( p.path.ends_with( '~' ) ) ++d;
         else ++s;
       }
 
-      return boost::json::object{
+      auto result = boost::json::object{
           { "paths", arr },
           { "total", paths.size() },
           { "static", s },
           { "dynamic", d }
       };
+      if constexpr ( Metrics ) result["notFound"] = notFoundCount.load();
+      return result;
     }
+#endif
 
-    /**
-     * Output a string representation of the configured routes.
-     * @return String representation of the routes.
-     */
-    [[nodiscard]] std::string str() const
+    static PathStats stats( const Table& table, const Path& p ) requires Metrics
     {
-      return boost::json::serialize( json() );
+      auto result = PathStats{ p.path, p.metrics.methodNotAllowed->load(), {} };
+      if ( p.wildcard ) result.path.back() = '*';
+      result.methods.reserve( p.methods.size() );
+      for ( const auto m : p.methods )
+      {
+        auto& ms = result.methods.emplace_back( MethodStats{ std::string{ table.methods.name( m ) }, 0, 0, {} } );
+        if ( const auto* metrics = p.metrics.find( m ); metrics ) metrics->read( ms );
+      }
+      return result;
     }
-#endif
 
-    [[nodiscard]] std::string yaml() const
+    static std::string yaml( const Table& table )
     {
       using std::operator""sv;
 
       std::string out;
       out.reserve( 1024 );
       out.append( "paths:\n" );
-      for ( auto&& path : paths )
+      for ( auto&& path : table.paths )
       {
         if ( path.path.ends_with( '~' ) )
         {
@@ -340,35 +863,25 @@ namespace spt::http::router
       return out;
     }
 
-    /**
-     * Create a new instance of the router.
-     * @param error404 Optional handler function to handle path not found condition.
-     * @param error405  Optional handler function to handle path not configured for method condition.
-     * @param error500 Optional handler function to handle exception caught while despatching the request to handler.
-     */
-    HttpRouter( std::optional<Handler>&& error404 = std::nullopt,
-        std::optional<Handler>&& error405 = std::nullopt,
-        std::optional<Handler>&& error500 = std::nullopt ) :
-        notFound{ std::move( error404 ) }, methodNotAllowed{ std::move( error405 ) },
-        errorHandler{ std::move( error500 ) }
+    // Returns `true` if a new path was created, which then references the `methodNotAllowed` counter
+    static bool addParameter( Table& table, std::string_view method, std::string_view path,
+        const Handler* handler, std::string_view ref,
+        [[maybe_unused]] impl::RouteMetrics* metrics, [[maybe_unused]] impl::Counter* methodNotAllowed )
     {
-      handlers.reserve( 32 );
-      paths.reserve( 32 );
-    }
-
-    ~HttpRouter() = default;
-
-    HttpRouter(const HttpRouter&) = delete;
-    HttpRouter& operator=(const HttpRouter&) = delete;
-
-  private:
-    void addParameter( std::string_view method, std::string_view path, std::string_view ref )
-    {
-      using std::operator""s;
-      using std::operator""sv;
+      using std::operator""s;
+      using std::operator""sv;
 
+      auto& paths = table.paths;
       auto full = std::string{ path };
-      auto m = std::string{ method };
+      if ( const auto idx = impl::wildcard( full ); idx != std::string::npos )
+      {
+        if ( idx != full.size() - 1 ) throw InvalidWildcardError( "Wildcard character at invalid position"s );
+        if ( idx > 0 && full[idx-1] != '/' ) throw InvalidWildcardError( "Wildcard character not preceded by /"s );
+        full[idx] = '~';
+      }
+
+      // Custom methods are interned only once the route is valid, so that a rejected route leaves the table unchanged
+      const auto m = table.methods.resolve( method );
       auto iter = std::lower_bound( std::begin( paths ), std::end( paths ), full,
           []( const Path& p, const std::string& pth )
           {
@@ -376,187 +889,711 @@ namespace spt::http::router
           } );
       if ( iter != std::cend( paths ) && full == iter->path )
       {
-        if ( iter->indexOf( m ) )
+        if ( iter->has( m ) )
         {
-          throw DuplicateRouteError{ util::concat( "Duplicate path "sv, path, " for method "sv, m ) };
+          throw DuplicateRouteError{ util::concat( "Duplicate path "sv, path, " for method "sv, method ) };
         }
-        iter->methods.push_back( std::move( m ) );
-        iter->handlers.push_back( handlers.size() );
-        return;
+        table.methods.intern( method );
+        iter->add( m, handler );
+        if constexpr ( Metrics ) iter->metrics.add( m, metrics );
+        return false;
       }
 
-      if ( const auto idx = full.find( '*' ); idx != std::string::npos )
+      auto ps = Path{ std::move( full ), m, handler, std::string{ ref } };
+      if constexpr ( Metrics )
       {
-        if ( idx != full.size() - 1 ) throw InvalidWildcardError( "Wildcard character at invalid position"s );
-        if ( idx > 0 && full[idx-1] != '/' ) throw InvalidWildcardError( "Wildcard character not preceded by /"s );
+        ps.metrics.methodNotAllowed = methodNotAllowed;
+        ps.metrics.add( m, metrics );
+      }
+      if constexpr ( requires { { Map::capacity() } -> std::convertible_to<std::size_t>; } )
+      {
+        const auto required = static_cast<std::size_t>( std::count_if( std::cbegin( ps.parts ), std::cend( ps.parts ),
+            []( const std::string& part ) { return part.starts_with( '{' ) || part == "~"; } ) );
+        if ( required > Map::capacity() )
+        {
+          throw InvalidParameterError{ util::concat( "Path "sv, ps.path, " has more parameters than the parameter map can hold"sv ) };
+        }
       }
 
-      if ( full.ends_with( '*' ) ) full[full.size() - 1] = '~';
-      auto ps = Path{ std::move( full ), std::move( m ), handlers.size(), std::string{ ref } };
       for ( auto&& p : paths )
       {
         if ( p.epath == ps.epath )
         {
-          if ( auto it = std::find( std::cbegin( iter->methods ), std::cend( iter->methods ), ps.methods[0] );
-              it != std::cend( iter->methods ) )
+          if ( p.has( m ) )
           {
             throw DuplicateRouteError{ util::concat( "Duplicate path "sv, ps.path, " clashes with "sv, p.path ) };
           }
         }
       }
 
-      paths.push_back( std::move( ps ) );
-
-      std::sort( std::begin( paths ), std::end( paths ), []( const Path& p1, const Path& p2 )
-      {
-        return p1.path < p2.path;
-      } );
+      auto pos = std::upper_bound( std::begin( paths ), std::end( paths ), ps.path,
+          []( const std::string& pth, const Path& p )
+          {
+            return pth < p.path;
+          } );
+      const auto idx = static_cast<std::size_t>( std::distance( std::begin( paths ), pos ) );
+      table.methods.intern( method );
+      table.trie.shift( idx );
+      table.statics.shift( idx );
+
+      const auto& inserted = *paths.insert( pos, std::move( ps ) );
+      table.trie.insert( inserted.parts, idx, inserted.patterns );
+      if ( !inserted.wildcard && !inserted.parametrised ) table.statics.insert( inserted.path, idx );
+      return true;
     }
 
-    std::optional<Response> routeParameters( std::string_view method,
-        std::string_view path, Request request ) const
+    // Everything is validated before the table is modified, so that a route that
+    // is rejected leaves the table unchanged.  `created` is set for the routes
+    // that created a path, which then reference their `methodNotAllowed` counter.
+    static void addParameters( Table& table, std::span<const Pending> routes, std::vector<bool>& created )
     {
+      using std::operator""s;
       using std::operator""sv;
-      Map params{};
 
-      auto full = std::string{ path };
-      auto m = std::string{ method };
-      auto iter = std::lower_bound( std::cbegin( paths ), std::cend( paths ), full,
-          []( const Path& p, const std::string& pth )
-          {
-            return p.path < pth;
-          } );
+      struct Entry
+      {
+        std::string path;
+        impl::MethodId method;
+        std::size_t route;
+      };
 
-      if ( iter == std::cend( paths ) ) return std::nullopt;
-      if ( full == iter->path && !iter->wildcard )
+      // New custom methods are numbered in order of first use, as interning them will
+      auto customs = std::vector<std::string_view>{};
+      auto entries = std::vector<Entry>{};
+      entries.reserve( routes.size() );
+      for ( std::size_t i = 0; i < routes.size(); ++i )
       {
-        if ( auto midx = iter->indexOf( m ); midx )
+        auto m = table.methods.find( routes[i].method );
+        if ( m == impl::UnknownMethod )
+        {
+          auto it = std::find( std::begin( customs ), std::end( customs ), routes[i].method );
+          if ( it == std::end( customs ) ) it = customs.insert( it, routes[i].method );
+          const auto id = table.methods.size() + static_cast<std::size_t>( std::distance( std::begin( customs ), it ) );
+          if ( id >= impl::MaxMethods )
+          {
+            throw InvalidMethodError{ util::concat( "Too many distinct methods configured, cannot add "sv, routes[i].method ) };
+          }
+          m = static_cast<impl::MethodId>( id );
+        }
+
+        auto full = std::string{ routes[i].path };
+        if ( const auto idx = impl::wildcard( full ); idx != std::string::npos )
         {
-          return handlers[iter->handlers[*midx]]( request, std::move( params ) );
+          if ( idx != full.size() - 1 ) throw InvalidWildcardError( "Wildcard character at invalid position"s );
+          if ( idx > 0 && full[idx-1] != '/' ) throw InvalidWildcardError( "Wildcard character not preceded by /"s );
+          full[idx] = '~';
         }
-#ifdef HAS_LOGGER
-        LOG_INFO << "Method " << method << " not configured for path " << path;
-#endif
-        if ( methodNotAllowed ) return (*methodNotAllowed)( request, std::move( params ) );
-        return std::nullopt;
+        entries.push_back( { std::move( full ), m, i } );
       }
 
-      const auto parts = util::split<std::string_view>( full );
-      auto handler = -1;
-      for ( ; iter != std::cend( paths ); ++iter )
+      std::sort( std::begin( entries ), std::end( entries ), []( const Entry& a, const Entry& b )
       {
-        if ( parts.size() != iter->parts.size() )
-        {
-          if ( !iter->wildcard ) continue;
-          if ( parts.size() < iter->parts.size() ) continue;
+        if ( const auto c = a.path.compare( b.path ); c != 0 ) return c < 0;
+        return a.method < b.method;
+      } );
 
-          for ( std::size_t i = 0; i < iter->parts.size(); ++i )
+      // The entries [first, last) for a path, and the index of the configured or new path
+      struct Group
+      {
+        std::size_t first;
+        std::size_t last;
+        std::size_t path;
+        std::uint64_t mask;
+      };
+
+      // Methods added to configured paths, and the new paths in sorted order
+      auto& paths = table.paths;
+      auto added = std::vector<Group>{};
+      auto groups = std::vector<Group>{};
+      auto fresh = std::vector<Path>{};
+      for ( std::size_t first = 0, last = 0; first < entries.size(); first = last )
+      {
+        const auto& path = entries[first].path;
+        auto mask = std::uint64_t{ 0 };
+        for ( last = first; last < entries.size() && entries[last].path == path; ++last )
+        {
+          if ( last > first && entries[last].method == entries[last - 1].method )
           {
-            auto iview = std::string_view{ iter->parts[i] };
-            if ( parts[i] == iview ) continue;
-            if ( iview[0] == '{' )
-            {
-              auto key = iview.substr( 1, iview.size() - 2 );
-              params.try_emplace( { key.data(), key.size() }, parts[i] );
-            }
-            if ( iview != "~"sv ) break;
+            throw DuplicateRouteError{ util::concat( "Duplicate path "sv, routes[entries[last].route].path,
+                " for method "sv, routes[entries[last].route].method ) };
+          }
+          mask |= impl::bit( entries[last].method );
+        }
 
-            if ( auto midx = iter->indexOf( m ); midx )
-            {
-              std::size_t idx = 0;
-              for ( std::size_t j = 0; j < iter->parts.size() - 1; ++j )
-              {
-                idx += ( 1 + parts[j].size() );
-              }
-              params.try_emplace( WildcardKey, path.substr( ++idx ) );
-              return handlers[iter->handlers[*midx]]( request, std::move( params ) );
-            }
-#ifdef HAS_LOGGER
-            LOG_INFO << "Method " << method << " not configured for path " << path;
-#endif
-            if ( methodNotAllowed ) return (*methodNotAllowed)( request, std::move( params ) );
-            return std::nullopt;
+        if ( auto iter = lowerBound( paths, path ); iter != std::cend( paths ) && iter->path == path )
+        {
+          if ( ( iter->mask & mask ) != 0 )
+          {
+            const auto& e = *std::find_if( std::begin( entries ) + first, std::begin( entries ) + last,
+                [&iter]( const Entry& en ) { return iter->has( en.method ); } );
+            throw DuplicateRouteError{ util::concat( "Duplicate path "sv, routes[e.route].path,
+                " for method "sv, routes[e.route].method ) };
           }
+          added.push_back( { first, last, static_cast<std::size_t>( std::distance( std::cbegin( paths ), iter ) ), mask } );
+          continue;
         }
 
-        auto midx = iter->indexOf( m );
+        groups.push_back( { first, last, fresh.size(), mask } );
 
-        for ( std::size_t i = 0; i < parts.size(); ++i )
+        const auto& r = routes[entries[first].route];
+        auto& ps = fresh.emplace_back( std::string{ path }, entries[first].method, r.handler, std::string{ r.ref } );
+        for ( auto i = first + 1; i < last; ++i ) ps.add( entries[i].method, routes[entries[i].route].handler );
+        if constexpr ( requires { { Map::capacity() } -> std::convertible_to<std::size_t>; } )
         {
-          auto iview = std::string_view{ iter->parts[i] };
-          if ( parts[i] == iview )
+          const auto required = static_cast<std::size_t>( std::count_if( std::cbegin( ps.parts ), std::cend( ps.parts ),
+              []( const std::string& part ) { return part.starts_with( '{' ) || part == "~"; } ) );
+          if ( required > Map::capacity() )
           {
-            if ( i == parts.size() - 1 )
-            {
-              if ( midx ) handler = static_cast<int>( iter->handlers[*midx] );
-              else
-              {
-#ifdef HAS_LOGGER
-                LOG_INFO << "Method " << method << " not configured for path " << path;
-#endif
-                if ( methodNotAllowed ) return (*methodNotAllowed)( request, std::move( params ) );
-                return std::nullopt;
-              }
-            }
-            else continue;
+            throw InvalidParameterError{ util::concat( "Path "sv, ps.path, " has more parameters than the parameter map can hold"sv ) };
           }
-          if ( iview == "~" && iter->wildcard )
+        }
+      }
+
+      // Paths with the same effective path clash if configured for the same
+      // method, and at least one of them is being configured now
+      struct Key
+      {
+        std::string_view epath;
+        std::string_view path;
+        std::uint64_t mask;
+        std::uint64_t added;
+      };
+
+      auto keys = std::vector<Key>{};
+      keys.reserve( paths.size() + fresh.size() );
+      for ( const auto& p : paths ) keys.push_back( { p.epath, p.path, p.mask, 0 } );
+      for ( const auto& g : added )
+      {
+        keys[g.path].mask |= g.mask;
+        keys[g.path].added = g.mask;
+      }
+      for ( const auto& p : fresh ) keys.push_back( { p.epath, p.path, p.mask, p.mask } );
+      std::sort( std::begin( keys ), std::end( keys ), []( const Key& a, const Key& b ) { return a.epath < b.epath; } );
+
+      for ( std::size_t first = 0, last = 0; first < keys.size(); first = last )
+      {
+        for ( last = first + 1; last < keys.size() && keys[last].epath == keys[first].epath; ++last );
+        for ( auto i = first; i < last; ++i )
+        {
+          for ( auto j = i + 1; j < last; ++j )
           {
-            if ( midx )
+            if ( ( keys[i].added & keys[j].mask ) != 0 )
             {
-              handler = static_cast<int>( iter->handlers[*midx] );
-              std::size_t idx = 0;
-              for ( std::size_t j = 0; j < iter->parts.size() - 1; ++j )
-              {
-                idx += ( 1 + parts[j].size() );
-              }
-              params.try_emplace( WildcardKey, path.substr( ++idx ) );
+              throw DuplicateRouteError{ util::concat( "Duplicate path "sv, keys[i].path, " clashes with "sv, keys[j].path ) };
             }
-            else
+            if ( ( keys[j].added & keys[i].mask ) != 0 )
             {
-#ifdef HAS_LOGGER
-              LOG_INFO << "Method " << method << " not configured for path " << path;
-#endif
-              if ( methodNotAllowed ) return (*methodNotAllowed)( request, std::move( params ) );
-              return std::nullopt;
+              throw DuplicateRouteError{ util::concat( "Duplicate path "sv, keys[j].path, " clashes with "sv, keys[i].path ) };
             }
           }
-          if ( iview[0] != '{' ) break;
+        }
+      }
+
+      // Validated, modify the table
+      for ( const auto method : customs ) table.methods.intern( method );
+
+      for ( const auto& g : added )
+      {
+        for ( auto i = g.first; i < g.last; ++i )
+        {
+          paths[g.path].add( entries[i].method, routes[entries[i].route].handler );
+          if constexpr ( Metrics ) paths[g.path].metrics.add( entries[i].method, routes[entries[i].route].metrics );
+        }
+      }
+
+      for ( std::size_t f = 0; f < fresh.size(); ++f )
+      {
+        const auto& g = groups[f];
+        created[entries[g.first].route] = true;
+        if constexpr ( Metrics )
+        {
+          fresh[f].metrics.methodNotAllowed = routes[entries[g.first].route].methodNotAllowed;
+          for ( auto i = g.first; i < g.last; ++i ) fresh[f].metrics.add( entries[i].method, routes[entries[i].route].metrics );
+        }
+      }
+
+      auto merged = std::vector<Path>{};
+      merged.reserve( paths.size() + fresh.size() );
+      std::merge( std::make_move_iterator( std::begin( paths ) ), std::make_move_iterator( std::end( paths ) ),
+          std::make_move_iterator( std::begin( fresh ) ), std::make_move_iterator( std::end( fresh ) ),
+          std::back_inserter( merged ), []( const Path& a, const Path& b ) { return a.path < b.path; } );
+      paths = std::move( merged );
+
+      // Indices of all paths after the first new one have moved, rebuild the indices in one pass
+      table.trie = impl::Trie{};
+      table.statics = impl::StaticIndex{};
+      for ( std::size_t i = 0; i < paths.size(); ++i )
+      {
+        table.trie.insert( paths[i].parts, i, paths[i].patterns );
+        if ( !paths[i].wildcard && !paths[i].parametrised ) table.statics.insert( paths[i].path, i );
+      }
+    }
+
+    static Removed removeParameter( Table& table, std::string_view method, std::string_view path )
+    {
+      auto& paths = table.paths;
+      auto full = std::string{ path };
+      if ( full.ends_with( '*' ) ) full[full.size() - 1] = '~';
+
+      auto iter = lowerBound( paths, full );
+      if ( iter == std::cend( paths ) || iter->path != full ) return {};
+
+      const auto m = table.methods.find( method );
+      auto removed = Removed{ iter->handler( m ) };
+      if ( removed.handler == nullptr ) return {};
+      if constexpr ( Metrics ) removed.metrics = iter->metrics.find( m );
+
+      auto it = std::begin( paths ) + std::distance( std::cbegin( paths ), iter );
+      it->remove( m );
+      if ( it->mask != 0 ) return removed;
+
+      if constexpr ( Metrics ) removed.methodNotAllowed = it->metrics.methodNotAllowed;
+      const auto idx = static_cast<std::size_t>( std::distance( std::begin( paths ), it ) );
+      table.trie.erase( it->parts, idx );
+      table.statics.erase( it->path, idx );
+      paths.erase( it );
+      return removed;
+    }
+
+    // Paths that need rewriting are normalised on the stack, or on the heap if very long
+    template <typename Fn>
+    decltype( auto ) normalised( std::string_view path, Fn&& fn ) const
+    {
+      if ( !normalisePaths ) return fn( path );
+
+      std::array<char, MaxNormalised> buffer;
+      if ( const auto p = util::normalise( path, buffer ); p ) return fn( *p );
+      auto heap = std::string{};
+      return fn( util::normalise( path, heap ) );
+    }
+
+    std::tuple<bool, bool> canRoutePath( std::string_view method, std::string_view path ) const
+    {
+      return snapshot.read( [this, method, path]( const Table& table ) -> std::tuple<bool, bool>
+      {
+        const auto& paths = table.paths;
+        const auto m = table.methods.find( method );
+        const auto idx = foldCase ? table.statics.findFolded( path, impl::foldedHash( path ) ) : table.statics.find( path );
+        if ( idx != impl::StaticIndex::npos ) return { true, paths[idx].has( m ) };
+
+        auto iter = lowerBound( paths, path, foldCase );
+        if ( iter == std::cend( paths ) ) return { false, false };
 
-          auto key = iview.substr( 1, iview.size() - 2 );
-          params.try_emplace( { key.data(), key.size() }, parts[i] );
-          if ( i == parts.size() - 1 )
+        if ( same( iter->path, path, foldCase ) && !iter->wildcard )
+        {
+          return { true, iter->has( m ) };
+        }
+
+        const auto from = static_cast<std::size_t>( std::distance( std::cbegin( paths ), iter ) );
+        auto buffer = std::array<std::string_view, MaxSegments>{};
+        const auto count = util::segment( path, buffer );
+        const auto route = count > buffer.size() ?
+            table.trie.match( util::split<std::string_view>( path ), from, foldCase ) :
+            table.trie.match( std::span{ buffer.data(), count }, from, foldCase );
+        if ( route == impl::Trie::npos ) return { false, false };
+        return { true, paths[route].has( m ) };
+      } );
+    }
+
+    std::optional<Response> routePath( std::string_view method, std::string_view path, const Query& query,
+        Request request, bool checkWithoutTrailingSlash ) const
+    {
+      if ( method.empty() || path.empty() ) return std::nullopt;
+      try
+      {
+        return snapshot.read( [&]( const Table& table )
+        {
+          const auto m = table.methods.find( method );
+          auto resp = routeParameters( table, m, method, path, request, query );
+          if ( !resp && checkWithoutTrailingSlash && path.ends_with( '/' ) )
           {
-            if ( midx ) handler = static_cast<int>( iter->handlers[*midx] );
-            else
+            return routeParameters( table, m, method, path.substr( 0, path.size() - 1 ), request, query );
+          }
+
+          return resp;
+        } );
+      }
+      catch ( const std::exception& e )
+      {
+        if ( errorHandler )
+        {
+#ifdef HAS_LOGGER
+          LOG_WARN << "Error handling " << method << " request to " << path <<
+            ". " << e.what();
+#endif
+          return impl::call( *errorHandler, request, Map{}, query );
+        }
+        throw;
+      }
+    }
+
+    std::optional<Response> routeExact( const Path& p, impl::MethodId m,
+        [[maybe_unused]] std::string_view method, [[maybe_unused]] std::string_view path, Request request, const Query& query ) const
+    {
+      if ( auto h = p.handler( m ); h ) return invoke( p, m, *h, request, Map{}, query );
+#ifdef HAS_LOGGER
+      LOG_INFO << "Method " << method << " not configured for path " << path;
+#endif
+      if constexpr ( Metrics ) p.metrics.methodNotAllowed->increment();
+      if ( methodNotAllowed ) return impl::call( *methodNotAllowed, request, Map{}, query );
+      return std::nullopt;
+    }
+
+    Response invoke( [[maybe_unused]] const Path& p, [[maybe_unused]] impl::MethodId m, const Handler& h,
+        Request request, Map&& params, const Query& query ) const
+    {
+      if constexpr ( Metrics )
+      {
+        auto* metrics = p.metrics.find( m );
+        const auto start = std::chrono::steady_clock::now();
+        try
+        {
+          auto resp = impl::call( h, request, std::move( params ), query );
+          metrics->record( std::chrono::steady_clock::now() - start, false );
+          return resp;
+        }
+        catch ( ... )
+        {
+          metrics->record( std::chrono::steady_clock::now() - start, true );
+          throw;
+        }
+      }
+      else return impl::call( h, request, std::move( params ), query );
+    }
+
+    std::optional<Response> routeNotFound( Request request, const Query& query ) const
+    {
+      if constexpr ( Metrics ) notFoundCount.increment();
+      if ( notFound ) return impl::call( *notFound, request, Map{}, query );
+      return std::nullopt;
+    }
+
+    static typename std::vector<Path>::const_iterator lowerBound( const std::vector<Path>& paths, std::string_view path,
+        bool folded = false )
+    {
+      if ( folded )
+      {
+        return std::lower_bound( std::cbegin( paths ), std::cend( paths ), path,
+            []( const Path& p, std::string_view pth )
             {
+              return util::compareFolded( p.path, pth ) < 0;
+            } );
+      }
+
+      return std::lower_bound( std::cbegin( paths ), std::cend( paths ), path,
+          []( const Path& p, std::string_view pth )
+          {
+            return std::string_view{ p.path } < pth;
+          } );
+    }
+
+    // Compare a configured path with a request path, in any case if the configured paths are folded
+    static bool same( std::string_view configured, std::string_view path, bool folded )
+    {
+      return folded ? util::equalsFolded( configured, path ) : configured == path;
+    }
+
+    // The configured path with its static segments folded to lower case if the router is case-insensitive.
+    // Parameter segments keep their case, so that names and regular expressions are as configured.
+    [[nodiscard]] std::string configured( std::string_view path ) const
+    {
+      auto out = std::string{ path };
+      if ( !foldCase ) return out;
+
+      auto parameter = false;
+      for ( std::size_t i = 0; i < out.size(); ++i )
+      {
+        if ( i == 0 || out[i - 1] == '/' ) parameter = out[i] == '{';
+        if ( !parameter ) out[i] = util::detail::lower( out[i] );
+      }
+      return out;
+    }
+
+    std::optional<Response> routeParameters( const Table& table, impl::MethodId m, std::string_view method,
+        std::string_view path, Request request, const Query& query ) const
+    {
+      const auto& paths = table.paths;
+      std::uint64_t hash = 0;
+      if constexpr ( Memo > 0 )
+      {
+        hash = impl::hash( path );
+        if ( const auto* hit = memo().find( path, hash, table.generation ); hit )
+        {
+          return routeCached( table, *hit, m, method, path, request, query );
+        }
+      }
+
+      const auto idx = foldCase ? table.statics.findFolded( path, impl::foldedHash( path ) ) :
+          Memo > 0 ? table.statics.find( path, hash ) : table.statics.find( path );
+      if ( idx != impl::StaticIndex::npos ) return routeExact( paths[idx], m, method, path, request, query );
+
+      auto iter = lowerBound( paths, path, foldCase );
+      if ( iter == std::cend( paths ) )
+      {
+        if constexpr ( Metrics ) notFoundCount.increment();
+        return std::nullopt;
+      }
+      if ( same( iter->path, path, foldCase ) && !iter->wildcard ) return routeExact( *iter, m, method, path, request, query );
+
+      if ( cache )
+      {
+        if constexpr ( Memo == 0 ) hash = impl::hash( path );
+        if ( const auto hit = cache->find( path, hash, table.generation ); hit )
+        {
+          if constexpr ( Memo > 0 ) memo().insert( path, hash, table.generation, *hit );
+          return routeCached( table, *hit, m, method, path, request, query );
+        }
+      }
+
+      // Segments are held on the stack, only pathologically deep paths need the heap
+      const auto from = static_cast<std::size_t>( std::distance( std::cbegin( paths ), iter ) );
+      auto buffer = std::array<std::string_view, MaxSegments>{};
+      const auto count = util::segment( path, buffer );
+      if ( count > buffer.size() )
+      {
+        return routeDynamic( table, util::split<std::string_view>( path ), from, m, method, path, hash, request, query );
+      }
+      return routeDynamic( table, std::span{ buffer.data(), count }, from, m, method, path, hash, request, query );
+    }
+
+    template <typename Parts>
+    std::optional<Response> routeDynamic( const Table& table, const Parts& parts, std::size_t from, impl::MethodId m,
+        std::string_view method, std::string_view path, std::uint64_t hash, Request request, const Query& query ) const
+    {
+      const auto idx = table.trie.match( parts, from, foldCase );
+      if ( idx == impl::Trie::npos ) return routeNotFound( request, query );
+
+      const auto match = resolve( table.paths[idx], idx, parts, path );
+      if ( cache ) cache->insert( path, hash, table.generation, match );
+      if constexpr ( Memo > 0 ) memo().insert( path, hash, table.generation, match );
+      if ( match.count <= match.params.size() ) return routeCached( table, match, m, method, path, request, query );
+
+      // Routes with more parameters than a match holds
+      Map params{};
+      const auto& matched = table.paths[idx];
+      for ( std::size_t i = 0; i < matched.parts.size(); ++i )
+      {
+        auto iview = std::string_view{ matched.parts[i] };
+        if ( iview[0] != '{' ) continue;
+        auto key = impl::parameter( iview );
+        params.try_emplace( { key.data(), key.size() }, parts[i] );
+      }
+      return routeMatched( matched, std::move( params ), match.wildcard, m, method, path, request, query );
+    }
+
+    // The positions of the parameter values in the path for the matched route
+    template <typename Parts>
+    static impl::MatchCache::Match resolve( const Path& matched, std::size_t idx, const Parts& parts, std::string_view path )
+    {
+      auto match = impl::MatchCache::Match{ static_cast<std::uint32_t>( idx ) };
+      for ( std::size_t i = 0; i < matched.parts.size(); ++i )
+      {
+        if ( matched.parts[i][0] != '{' ) continue;
+        if ( match.count < match.params.size() )
+        {
+          match.params[match.count] = util::Segment{ static_cast<std::uint32_t>( parts[i].data() - path.data() ),
+              static_cast<std::uint32_t>( parts[i].size() ) };
+        }
+        ++match.count;
+      }
+
+      if ( matched.wildcard )
+      {
+        std::size_t offset = 0;
+        for ( std::size_t j = 0; j < matched.parts.size() - 1; ++j )
+        {
+          offset += ( 1 + parts[j].size() );
+        }
+        match.wildcard = static_cast<std::uint32_t>( ++offset );
+      }
+
+      return match;
+    }
+
+    // How a request in a batch was resolved
+    struct Resolved
+    {
+      enum class Kind : std::uint8_t { End, NotFound, Exact, Dynamic, Fallback };
+
+      impl::MatchCache::Match match{};
+      impl::MethodId method{ 0 };
+      Kind kind{ Kind::End };
+    };
+
+    // Resolve in path order, prefetching the static index slot for the next path
+    static void resolveBatch( const Table& table, std::span<const RouteInput> inputs, std::span<Resolved> resolved, bool folded )
+    {
+      auto order = std::array<std::uint8_t, BatchSize>{};
+      auto hashes = std::array<std::uint64_t, BatchSize>{};
+      for ( std::size_t i = 0; i < inputs.size(); ++i )
+      {
+        order[i] = static_cast<std::uint8_t>( i );
+        hashes[i] = folded ? impl::foldedHash( inputs[i].path ) : impl::hash( inputs[i].path );
+      }
+      std::stable_sort( order.begin(), order.begin() + inputs.size(),
+          [&inputs]( std::uint8_t lhs, std::uint8_t rhs ) { return inputs[lhs].path < inputs[rhs].path; } );
+
+      const auto& paths = table.paths;
+      for ( std::size_t n = 0; n < inputs.size(); ++n )
+      {
+        const auto i = order[n];
+        if ( n + 1 < inputs.size() ) table.statics.prefetch( hashes[order[n + 1]] );
+
+        const auto& input = inputs[i];
+        auto& result = resolved[i];
+        if ( input.method.empty() || input.path.empty() ) continue;
+        result.method = table.methods.find( input.method );
+
+        const auto idx = folded ? table.statics.findFolded( input.path, hashes[i] ) : table.statics.find( input.path, hashes[i] );
+        if ( idx != impl::StaticIndex::npos )
+        {
+          result.kind = Resolved::Kind::Exact;
+          result.match.route = static_cast<std::uint32_t>( idx );
+          continue;
+        }
+
+        auto iter = lowerBound( paths, input.path, folded );
+        if ( iter == std::cend( paths ) ) continue;
+
+        const auto from = static_cast<std::size_t>( std::distance( std::cbegin( paths ), iter ) );
+        if ( same( iter->path, input.path, folded ) && !iter->wildcard )
+        {
+          result.kind = Resolved::Kind::Exact;
+          result.match.route = static_cast<std::uint32_t>( from );
+          continue;
+        }
+
+        auto buffer = std::array<std::string_view, MaxSegments>{};
+        const auto count = util::segment( input.path, buffer );
+        if ( count > buffer.size() )
+        {
+          result.kind = Resolved::Kind::Fallback;
+          continue;
+        }
+
+        const auto parts = std::span{ buffer.data(), count };
+        const auto route = table.trie.match( parts, from, folded );
+        if ( route == impl::Trie::npos )
+        {
+          result.kind = Resolved::Kind::NotFound;
+          continue;
+        }
+
+        result.match = resolve( paths[route], route, parts, input.path );
+        result.kind = result.match.count > result.match.params.size() ? Resolved::Kind::Fallback : Resolved::Kind::Dynamic;
+      }
+    }
+
+    std::optional<Response> dispatch( const Table& table, const Resolved& resolved, std::string_view method,
+        std::string_view path, Request request, bool checkWithoutTrailingSlash ) const
+    {
+      if ( method.empty() || path.empty() ) return std::nullopt;
+
+      // Batches are routed by path, handlers receive an empty query
+      const auto query = Query{};
+      try
+      {
+        auto resp = std::optional<Response>{};
+        switch ( resolved.kind )
+        {
+        case Resolved::Kind::End:
+          if constexpr ( Metrics ) notFoundCount.increment();
+          break;
+        case Resolved::Kind::NotFound:
+          resp = routeNotFound( request, query );
+          break;
+        case Resolved::Kind::Exact:
+          resp = routeExact( table.paths[resolved.match.route], resolved.method, method, path, request, query );
+          break;
+        case Resolved::Kind::Dynamic:
+          resp = routeCached( table, resolved.match, resolved.method, method, path, request, query );
+          break;
+        case Resolved::Kind::Fallback:
+          resp = routeParameters( table, resolved.method, method, path, request, query );
+          break;
+        }
+
+        if ( !resp && checkWithoutTrailingSlash && path.ends_with( '/' ) )
+        {
+          return routeParameters( table, resolved.method, method, path.substr( 0, path.size() - 1 ), request, query );
+        }
+        return resp;
+      }
+      catch ( const std::exception& e )
+      {
+        if ( errorHandler )
+        {
 #ifdef HAS_LOGGER
-              LOG_INFO << "Method " << method << " not configured for path " << path;
+          LOG_WARN << "Error handling " << method << " request to " << path <<
+            ". " << e.what();
 #endif
-              if ( methodNotAllowed ) return (*methodNotAllowed)( request, std::move( params ) );
-              return std::nullopt;
-            }
-          }
+          return impl::call( *errorHandler, request, Map{}, query );
         }
+        throw;
+      }
+    }
+
+    std::optional<Response> routeCached( const Table& table, const impl::MatchCache::Match& match, impl::MethodId m,
+        std::string_view method, std::string_view path, Request request, const Query& query ) const
+    {
+      Map params{};
 
-        if ( handler != -1 ) break;
-        params.clear();
+      const auto& matched = table.paths[match.route];
+      std::size_t param = 0;
+      for ( auto&& part : matched.parts )
+      {
+        auto iview = std::string_view{ part };
+        if ( iview[0] != '{' ) continue;
+        auto key = impl::parameter( iview );
+        const auto& segment = match.params[param++];
+        params.try_emplace( { key.data(), key.size() }, path.substr( segment.offset, segment.size ) );
       }
 
-      if ( handler == -1 )
+      return routeMatched( matched, std::move( params ), match.wildcard, m, method, path, request, query );
+    }
+
+    std::optional<Response> routeMatched( const Path& matched, Map&& params, std::uint32_t wildcard, impl::MethodId m,
+        [[maybe_unused]] std::string_view method, std::string_view path, Request request, const Query& query ) const
+    {
+      auto h = matched.handler( m );
+      if ( !h )
       {
-        if ( notFound ) return (*notFound)( request, std::move( params ) );
+#ifdef HAS_LOGGER
+        LOG_INFO << "Method " << method << " not configured for path " << path;
+#endif
+        if constexpr ( Metrics ) matched.metrics.methodNotAllowed->increment();
+        if ( methodNotAllowed ) return impl::call( *methodNotAllowed, request, std::move( params ), query );
         return std::nullopt;
       }
-      return handlers[handler]( request, std::move( params ) );
+
+      if ( matched.wildcard ) params.try_emplace( WildcardKey, path.substr( wildcard ) );
+      return invoke( matched, m, *h, request, std::move( params ), query );
     }
 
-    std::vector<Handler> handlers{};
-    std::vector<Path> paths;
+    // One memo per thread, shared by all routers of the same type.  Generations
+    // are unique across routers, so entries never match another router's table.
+    static auto& memo() requires ( Memo > 0 )
+    {
+      static thread_local impl::RouteMemo<Memo> value{};
+      return value;
+    }
+
+    static constexpr std::size_t MaxSegments = 32;
+    static constexpr std::size_t MaxNormalised = 1024;
+    static constexpr std::size_t BatchSize = 32;
+
+    impl::Snapshot<Table> snapshot;
+    std::vector<std::unique_ptr<Handler>> handlers{};
     std::optional<Handler> notFound{ std::nullopt };
     std::optional<Handler> methodNotAllowed{ std::nullopt };
     std::optional<Handler> errorHandler{ std::nullopt };
-    std::mutex mutex;
+    std::unique_ptr<impl::MatchCache> cache{ nullptr };
+    std::vector<std::unique_ptr<impl::RouteMetrics>> routeMetrics{};
+    std::vector<std::unique_ptr<impl::Counter>> pathMetrics{};
+    [[no_unique_address]] mutable std::conditional_t<Metrics, impl::Counter, impl::NoMetrics> notFoundCount{};
+    mutable std::mutex mutex;
+    bool normalisePaths{ false };
+    bool foldCase{ false };
   };
 
 #ifdef HAS_BOOST
@@ -575,10 +1612,11 @@ namespace spt::http::router
    *   the router handler function.
    * @tparam Response The response from the handler function.
    */
-  template <typename Request, typename Response, typename Map>
-  requires (std::same_as<std::string, typename Map::key_type> && std::same_as<std::string, typename Map::mapped_type>) ||
-      (std::same_as<std::string_view, typename Map::key_type> && std::same_as<std::string_view, typename Map::mapped_type>)
-  struct HttpRouter<Request, Response, Map>::Builder
+  template <typename Request, typename Response, typename Map, typename Function, std::size_t Memo, bool Metrics>
+  requires ((std::same_as<std::string, typename Map::key_type> && std::same_as<std::string, typename Map::mapped_type>) ||
+      (std::same_as<std::string_view, typename Map::key_type> && std::same_as<std::string_view, typename Map::mapped_type>)) &&
+      (Memo == 0 || std::has_single_bit( Memo ))
+  struct HttpRouter<Request, Response, Map, Function, Memo, Metrics>::Builder
   {
     Builder() = default;
     ~Builder() = default;
@@ -590,7 +1628,7 @@ namespace spt::http::router
      * @param h The handler function.
      * @return Reference to this builder for chaining.
      */
-    Builder& withNotFound( typename HttpRouter<Request, Response>::Handler&& h )
+    Builder& withNotFound( Handler&& h )
     {
       notFound = std::move( h );
       return *this;
@@ -601,7 +1639,7 @@ namespace spt::http::router
      * @param h The handler function.
      * @return Reference to this builder for chaining.
      */
-    Builder& withMethodNotAllowed( typename HttpRouter<Request, Response>::Handler&& h )
+    Builder& withMethodNotAllowed( Handler&& h )
     {
       methodNotAllowed = std::move( h );
       return *this;
@@ -612,25 +1650,59 @@ namespace spt::http::router
      * @param h The handler function.
      * @return Reference to this builder for chaining.
      */
-    Builder& withErrorHandler( typename HttpRouter<Request, Response>::Handler&& h )
+    Builder& withErrorHandler( Handler&& h )
     {
       errorHandler = std::move( h );
       return *this;
     }
 
+    /**
+     * Enable the match cache for dynamic paths with the router.
+     * @param capacity The maximum number of paths to cache.
+     * @return Reference to this builder for chaining.
+     */
+    Builder& withMatchCache( std::size_t capacity )
+    {
+      cacheCapacity = capacity;
+      return *this;
+    }
+
+    /**
+     * Normalise request paths before they are matched.
+     * @return Reference to this builder for chaining.
+     */
+    Builder& withNormalisation()
+    {
+      normalise = true;
+      return *this;
+    }
+
+    /**
+     * Match the static segments of request paths in any case.
+     * @return Reference to this builder for chaining.
+     */
+    Builder& withCaseInsensitivity()
+    {
+      caseInsensitive = true;
+      return *this;
+    }
+
     /**
      * Build the router with the error handlers provided.  The handlers are
      * moved, so no further use of the builder is possible.
      * @return The properly initialised router.
      */
-    [[nodiscard]] HttpRouter<Request, Response> build()
+    [[nodiscard]] HttpRouter<Request, Response, Map, Function, Memo, Metrics> build()
     {
-      return { std::move( notFound ), std::move( methodNotAllowed ), std::move( errorHandler ) };
+      return { std::move( notFound ), std::move( methodNotAllowed ), std::move( errorHandler ), cacheCapacity, normalise, caseInsensitive };
     }
 
   private:
     std::optional<Handler> notFound{ std::nullopt };
     std::optional<Handler> methodNotAllowed{ std::nullopt };
     std::optional<Handler> errorHandler{ std::nullopt };
+    std::size_t cacheCapacity{ 0 };
+    bool normalise{ false };
+    bool caseInsensitive{ false };
   };
 }
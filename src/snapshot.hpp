@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace spt::http::router::impl
+{
+  /**
+   * Immutable snapshot of a value that may be updated while being read, using the
+   * left-right technique.  Two copies of the value are kept.  Readers see the
+   * published copy, which is never modified while published.  The writer applies
+   * each modification to the other copy, publishes it with a single atomic store,
+   * waits for readers of the previous copy to leave, and then applies the same
+   * modification to that copy.
+   *
+   * Readers take no locks and never wait.  Readers are counted in a striped read
+   * indicator, one cache line per stripe with threads spread over the stripes, so
+   * readers on different cores do not contend on a shared counter.
+   *
+   * Modifications must be deterministic, and must throw (if at all) before changing
+   * the copy, so that both copies stay identical.  Writers must be serialised by the
+   * caller, and must not write from within a read on the same thread (the writer
+   * would wait for itself).
+   * @tparam T The type of value.  Must be default constructible.
+   */
+  template <typename T>
+  class Snapshot
+  {
+  public:
+    Snapshot() = default;
+    ~Snapshot() = default;
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    /**
+     * Invoke the function with the published copy of the value.  The copy is
+     * guaranteed to not change until the function returns.
+     * @param fn The function to invoke with a const reference to the value.
+     * @return The value returned by the function.
+     */
+    template <typename Fn>
+    decltype(auto) read( Fn&& fn ) const
+    {
+      auto& counter = indicators[version.load()][stripe()].count;
+      counter.fetch_add( 1 );
+      const auto departure = Departure{ counter };
+      return fn( *current.load() );
+    }
+
+    /**
+     * Apply the modification to both copies of the value, publishing the modified
+     * copy before modifying the other.  If the first application throws, nothing is
+     * published.
+     * @param fn The function to invoke with a mutable reference to each copy.
+     */
+    template <typename Fn>
+    void write( Fn&& fn )
+    {
+      auto* active = current.load( std::memory_order_relaxed );
+      auto* standby = active == &left ? &right : &left;
+      fn( *standby );
+      current.store( standby );
+      toggle();
+      fn( *active );
+    }
+
+  private:
+    static constexpr std::size_t Stripes = 32;
+
+    // Assumes 64 byte cache lines, std::hardware_destructive_interference_size is not ABI stable
+    struct alignas( 64 ) Counter
+    {
+      std::atomic<std::size_t> count{ 0 };
+    };
+
+    struct Departure
+    {
+      ~Departure() { counter.fetch_sub( 1, std::memory_order_release ); }
+      std::atomic<std::size_t>& counter;
+    };
+
+    static std::size_t stripe() noexcept
+    {
+      static std::atomic<std::size_t> next{ 0 };
+      thread_local const auto value = next.fetch_add( 1, std::memory_order_relaxed ) % Stripes;
+      return value;
+    }
+
+    // Readers that loaded the previous copy are counted against either version,
+    // depending on when they read the version, so both have to drain.
+    void toggle()
+    {
+      const auto previous = version.load( std::memory_order_relaxed );
+      const auto next = previous ^ 1;
+      drain( next );
+      version.store( next );
+      drain( previous );
+    }
+
+    void drain( std::size_t v ) const
+    {
+      for ( const auto& counter : indicators[v] )
+      {
+        while ( counter.count.load() != 0 ) std::this_thread::yield();
+      }
+    }
+
+    T left{};
+    T right{};
+    alignas( 64 ) std::atomic<T*> current{ &left };
+    std::atomic<std::size_t> version{ 0 };
+    mutable std::array<std::array<Counter, Stripes>, 2> indicators{};
+  };
+}
@@ -5,9 +5,17 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
 #include <string_view>
 #include <vector>
 
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#include <immintrin.h>
+#endif
+
 namespace spt::util
 {
   template <typename String>
@@ -39,4 +47,149 @@ constexpr
 
     return output;
   }
+
+  /**
+   * Split the input into a caller provided buffer without allocating.  Empty
+   * parts are skipped, as with the `std::vector` returning overload.
+   * @param csv The input to split.
+   * @param output The buffer to hold the parts.
+   * @param delims The delimiter characters.
+   * @return The total number of parts in the input.  If this is larger than the
+   *   size of `output`, only the leading parts that fit have been written.
+   */
+  constexpr std::size_t split( std::string_view csv, std::span<std::string_view> output,
+      std::string_view delims = "/" )
+  {
+    std::size_t count = 0;
+    auto first = csv.cbegin();
+
+    while ( first != csv.cend() )
+    {
+      const auto second = std::find_first_of( first, std::cend( csv ),
+          std::cbegin( delims ), std::cend( delims ) );
+
+      if ( first != second )
+      {
+        if ( count < output.size() )
+        {
+          output[count] = csv.substr( std::distance( csv.begin(), first ),
+              std::distance( first, second ) );
+        }
+        ++count;
+      }
+
+      if ( second == csv.cend() ) break;
+      first = std::next( second );
+    }
+
+    return count;
+  }
+
+  /// Offset and size of a segment in a path.
+  struct Segment
+  {
+    std::uint32_t offset{ 0 };
+    std::uint32_t size{ 0 };
+  };
+
+  namespace detail
+  {
+    /**
+     * Scan the path for `/` and invoke `emit( index, offset, size )` for each non
+     * empty segment.  Scans 32 (AVX2) or 16 (SSE2) bytes at a time, and 8 bytes at
+     * a time using SWAR (SIMD within a register) on other little endian targets.
+     */
+    template <typename Emit>
+    inline std::size_t scan( std::string_view path, Emit&& emit ) noexcept
+    {
+      const auto* data = path.data();
+      const auto size = path.size();
+      std::size_t count = 0;
+      std::size_t start = 0;
+      std::size_t i = 0;
+
+      const auto slash = [&]( std::size_t position )
+      {
+        if ( position > start ) emit( count++, start, position - start );
+        start = position + 1;
+      };
+
+#if defined(__AVX2__)
+      const auto wide = _mm256_set1_epi8( '/' );
+      for ( ; i + 32 <= size; i += 32 )
+      {
+        const auto block = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( data + i ) );
+        auto mask = static_cast<std::uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( block, wide ) ) );
+        for ( ; mask != 0; mask &= mask - 1 ) slash( i + std::countr_zero( mask ) );
+      }
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+      const auto narrow = _mm_set1_epi8( '/' );
+      for ( ; i + 16 <= size; i += 16 )
+      {
+        const auto block = _mm_loadu_si128( reinterpret_cast<const __m128i*>( data + i ) );
+        auto mask = static_cast<std::uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( block, narrow ) ) );
+        for ( ; mask != 0; mask &= mask - 1 ) slash( i + std::countr_zero( mask ) );
+      }
+#else
+      if constexpr ( std::endian::native == std::endian::little )
+      {
+        constexpr std::uint64_t ones = 0x0101010101010101ull;
+        constexpr std::uint64_t low = 0x7f7f7f7f7f7f7f7full;
+        for ( ; i + 8 <= size; i += 8 )
+        {
+          std::uint64_t word;
+          std::memcpy( &word, data + i, sizeof( word ) );
+          // High bit set exactly for the bytes that are zero after the xor
+          const auto x = word ^ ( ones * '/' );
+          auto mask = ~( ( ( x & low ) + low ) | x | low );
+          for ( ; mask != 0; mask &= mask - 1 ) slash( i + std::countr_zero( mask ) / 8 );
+        }
+      }
+#endif
+
+      for ( ; i < size; ++i )
+      {
+        if ( data[i] == '/' ) slash( i );
+      }
+      if ( size > start ) emit( count++, start, size - start );
+      return count;
+    }
+  }
+
+  /**
+   * Split a path on `/` into a caller provided buffer of segment offsets without
+   * allocating.  Empty segments are skipped, as with `split`.
+   * @param path The path to split.  Must be less than 4GB.
+   * @param output The buffer to hold the segment offsets.
+   * @return The total number of segments in the path.  If this is larger than the
+   *   size of `output`, only the leading segments that fit have been written.
+   */
+  inline std::size_t segment( std::string_view path, std::span<Segment> output ) noexcept
+  {
+    return detail::scan( path, [output]( std::size_t index, std::size_t offset, std::size_t size )
+    {
+      if ( index < output.size() )
+      {
+        output[index] = Segment{ static_cast<std::uint32_t>( offset ), static_cast<std::uint32_t>( size ) };
+      }
+    } );
+  }
+
+  /**
+   * Split a path on `/` into a caller provided buffer of views into the path.
+   * Vectorised equivalent of `split( path, output )`.
+   * @param path The path to split.
+   * @param output The buffer to hold the segments.
+   * @return The total number of segments in the path.  If this is larger than the
+   *   size of `output`, only the leading segments that fit have been written.
+   */
+  inline std::size_t segment( std::string_view path, std::span<std::string_view> output ) noexcept
+  {
+    return detail::scan( path, [path, output]( std::size_t index, std::size_t offset, std::size_t size )
+    {
+      if ( index < output.size() ) output[index] = path.substr( offset, size );
+    } );
+  }
 }
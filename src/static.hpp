@@ -0,0 +1,663 @@
+#pragma once
+
+#include "constraint.hpp"
+#include "regex.hpp"
+#include "split.hpp"
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+namespace spt::http::router
+{
+  /**
+   * String literal that may be used as a template argument.
+   * @tparam N The size of the literal, including the terminating null character.
+   */
+  template <std::size_t N>
+  struct Literal
+  {
+    constexpr Literal( const char (&s)[N] ) { std::copy_n( s, N, value ); }
+    [[nodiscard]] constexpr std::string_view view() const { return { value, N - 1 }; }
+    char value[N]{};
+  };
+
+  namespace impl
+  {
+    /// The maximum number of segments in a path configured in a StaticRouter.
+    constexpr std::size_t MaxStaticSegments = 32;
+
+    /// Path parsed into segments at compile time.
+    struct Pattern
+    {
+      std::array<std::string_view, MaxStaticSegments> parts{};
+      std::size_t count{ 0 };
+      std::size_t params{ 0 };
+      bool wildcard{ false };
+    };
+
+    constexpr Pattern pattern( std::string_view path )
+    {
+      auto p = Pattern{};
+      p.count = util::split( path, p.parts );
+      for ( std::size_t i = 0; i < p.count && i < p.parts.size(); ++i )
+      {
+        if ( p.parts[i].starts_with( '{' ) ) ++p.params;
+        else if ( p.parts[i] == "*" ) p.wildcard = true;
+      }
+      return p;
+    }
+
+    /// Same rules as `HttpRouter::add`, which throws `InvalidParameterError` if violated.
+    constexpr bool validParameters( std::string_view path )
+    {
+      const auto p = pattern( path );
+      for ( std::size_t i = 0; i < p.count; ++i )
+      {
+        const auto part = p.parts[i];
+        if ( ( part.starts_with( '{' ) && !part.ends_with( '}' ) ) || part.starts_with( ':' ) ) return false;
+        if ( part.starts_with( '{' ) && !constraint( part ) ) return false;
+        if ( part.starts_with( '{' ) && constraint( part ) == Constraint::Regex && !check( type( part ) ).empty() ) return false;
+      }
+      return true;
+    }
+
+    /// Same rules as `HttpRouter::add`, which throws `InvalidWildcardError` if violated.
+    constexpr bool validWildcard( std::string_view path )
+    {
+      const auto idx = wildcard( path );
+      if ( idx == std::string_view::npos ) return true;
+      return idx == path.size() - 1 && ( idx == 0 || path[idx - 1] == '/' );
+    }
+
+    /// Paths are equivalent if they differ only in the names of the parameters, not their constraints.
+    constexpr bool equivalent( std::string_view lhs, std::string_view rhs )
+    {
+      const auto l = pattern( lhs );
+      const auto r = pattern( rhs );
+      if ( l.count != r.count ) return false;
+      for ( std::size_t i = 0; i < l.count; ++i )
+      {
+        if ( l.parts[i].starts_with( '{' ) && r.parts[i].starts_with( '{' ) &&
+            type( l.parts[i] ) == type( r.parts[i] ) ) continue;
+        if ( l.parts[i] != r.parts[i] ) return false;
+      }
+      return true;
+    }
+
+    /// Order of paths in the HttpRouter sorted table, where the wildcard is stored as `~`.
+    constexpr bool before( std::string_view lhs, std::string_view rhs )
+    {
+      const auto key = []( std::string_view path, std::size_t i )
+      {
+        const auto c = path[i];
+        return static_cast<unsigned char>( c == '*' && i == path.size() - 1 ? '~' : c );
+      };
+
+      const auto size = std::min( lhs.size(), rhs.size() );
+      for ( std::size_t i = 0; i < size; ++i )
+      {
+        if ( key( lhs, i ) != key( rhs, i ) ) return key( lhs, i ) < key( rhs, i );
+      }
+      return lhs.size() < rhs.size();
+    }
+
+    /// If the configured path sorts before the request path in the HttpRouter sorted table, which never matches it.
+    constexpr bool below( std::string_view configured, std::string_view path )
+    {
+      const auto size = std::min( configured.size(), path.size() );
+      for ( std::size_t i = 0; i < size; ++i )
+      {
+        const auto c = configured[i] == '*' && i == configured.size() - 1 ? '~' : configured[i];
+        if ( c != path[i] ) return static_cast<unsigned char>( c ) < static_cast<unsigned char>( path[i] );
+      }
+      return configured.size() < path.size();
+    }
+  }
+
+  /**
+   * A route in a StaticRouter.  The path uses the same grammar as `HttpRouter::add`
+   * and is validated at compile time.
+   * @tparam Method The HTTP method/verb for which the route is configured.
+   * @tparam Path The path to configure.
+   * @tparam Handler The function (or captureless lambda) to invoke if a request matches.
+   */
+  template <Literal Method, Literal Path, auto Handler>
+  struct Route
+  {
+    static constexpr std::string_view method = Method.view();
+    static constexpr std::string_view path = Path.view();
+    static constexpr auto handler = Handler;
+
+    static_assert( !method.empty(), "Method must not be empty" );
+    static_assert( impl::pattern( path ).count <= impl::MaxStaticSegments, "Path has too many segments" );
+    static_assert( impl::validParameters( path ), "Path has invalid parameter, use the {parameter} or {parameter:type} form" );
+    static_assert( impl::validWildcard( path ), "Wildcard must be the last character and preceded by /" );
+  };
+
+  /**
+   * Router for a route table that is fully known at compile time.  Routes are
+   * parsed, validated and checked for conflicts at compile time, and dispatch is
+   * generated as a decision tree over the path segments with the handlers at the
+   * leaves, which the compiler can inline completely.
+   *
+   * Routing results are the same as a HttpRouter configured with the same routes:
+   * static paths take precedence, then parameters and wildcards in the byte order
+   * of the paths, considering only the paths that sort at or after the request
+   * path as the sorted table does.  A request for a configured parametrised path
+   * as is (`/a/{id}`) is routed to that path without parameters, as HttpRouter does.
+   * @tparam Request User defined structure with the request context necessary for
+   *   the handler function.
+   * @tparam Response The response from the handler function.
+   * @tparam Map The type of map to use to return the parsed path parameters.
+   * @tparam Routes The routes, each a specialisation of Route.
+   */
+  template <typename Request, typename Response, typename Map, typename... Routes>
+  requires (std::same_as<std::string, typename Map::key_type> && std::same_as<std::string, typename Map::mapped_type>) ||
+      (std::same_as<std::string_view, typename Map::key_type> && std::same_as<std::string_view, typename Map::mapped_type>)
+  class StaticRouter
+  {
+    static constexpr auto npos = std::numeric_limits<std::size_t>::max();
+    static constexpr std::size_t Count = sizeof...( Routes );
+
+    static constexpr std::array<std::string_view, Count> methods{ Routes::method... };
+    static constexpr std::array<std::string_view, Count> paths{ Routes::path... };
+
+    template <std::size_t R>
+    using RouteAt = std::tuple_element_t<R, std::tuple<Routes...>>;
+
+    static_assert( ( std::is_invocable_r_v<Response, decltype( Routes::handler ), Request, Map&&> && ... ),
+        "Route handler cannot be invoked with the Request and Map, or does not return the Response" );
+
+    static constexpr bool unique()
+    {
+      for ( std::size_t i = 0; i < Count; ++i )
+      {
+        for ( std::size_t j = i + 1; j < Count; ++j )
+        {
+          if ( methods[i] == methods[j] && paths[i] == paths[j] ) return false;
+        }
+      }
+      return true;
+    }
+
+    static constexpr bool distinct()
+    {
+      for ( std::size_t i = 0; i < Count; ++i )
+      {
+        for ( std::size_t j = i + 1; j < Count; ++j )
+        {
+          if ( methods[i] == methods[j] && impl::equivalent( paths[i], paths[j] ) ) return false;
+        }
+      }
+      return true;
+    }
+
+    static constexpr bool fits()
+    {
+      if constexpr ( requires { { Map::capacity() } -> std::convertible_to<std::size_t>; } )
+      {
+        for ( const auto path : paths )
+        {
+          const auto p = impl::pattern( path );
+          if ( p.params + ( p.wildcard ? 1 : 0 ) > Map::capacity() ) return false;
+        }
+      }
+      return true;
+    }
+
+    static_assert( unique(), "Duplicate path for method" );
+    static_assert( distinct(), "Path clashes with another path for method" );
+    static_assert( fits(), "Path has more parameters than the parameter map can hold" );
+
+    // Routes with the same path form a group, groups are in the order of the sorted table
+    struct Groups
+    {
+      std::array<std::size_t, Count> route{};
+      std::array<std::size_t, Count> group{};
+      std::size_t count{ 0 };
+    };
+
+    static constexpr Groups groups = []
+    {
+      auto order = std::array<std::size_t, Count>{};
+      for ( std::size_t i = 0; i < Count; ++i ) order[i] = i;
+      std::sort( std::begin( order ), std::end( order ),
+          []( std::size_t l, std::size_t r ) { return impl::before( paths[l], paths[r] ); } );
+
+      auto gs = Groups{};
+      for ( std::size_t i = 0; i < Count; ++i )
+      {
+        const auto r = order[i];
+        if ( gs.count == 0 || paths[gs.route[gs.count - 1]] != paths[r] ) gs.route[gs.count++] = r;
+        gs.group[r] = gs.count - 1;
+      }
+      return gs;
+    }();
+
+    // The groups ending at a node are a range of the terminals, in the order of the sorted table
+    struct Node
+    {
+      std::size_t first{ 0 };
+      std::size_t count{ 0 };
+      std::size_t statics{ npos };
+      std::size_t params{ npos };
+      std::size_t wildcard{ npos };
+    };
+
+    // Children of a node are a linked list of edges sorted by segment
+    struct Edge
+    {
+      std::string_view text{};
+      std::size_t child{ npos };
+      std::size_t next{ npos };
+    };
+
+    static constexpr std::size_t Segments = ( impl::pattern( Routes::path ).count + ... + 0 );
+
+    struct Tree
+    {
+      std::array<Node, Segments + 1> nodes{};
+      std::array<Edge, Segments + 1> edges{};
+      std::array<std::size_t, Count> terminals{};
+      std::size_t nodeCount{ 1 };
+      std::size_t edgeCount{ 0 };
+    };
+
+    static constexpr Tree tree = []
+    {
+      auto t = Tree{};
+      const auto child = [&t]( std::size_t& head, std::string_view part )
+      {
+        auto* link = &head;
+        while ( *link != npos && t.edges[*link].text < part ) link = &t.edges[*link].next;
+        if ( *link != npos && t.edges[*link].text == part ) return t.edges[*link].child;
+
+        const auto node = t.nodeCount++;
+        t.edges[t.edgeCount] = Edge{ part, node, *link };
+        *link = t.edgeCount++;
+        return node;
+      };
+
+      // Paths such as `/a/{id}` and `/a/{id}/` end at the same node
+      auto owner = std::array<std::size_t, Count>{};
+      for ( std::size_t g = 0; g < groups.count; ++g )
+      {
+        const auto p = impl::pattern( paths[groups.route[g]] );
+        std::size_t node = 0;
+        for ( std::size_t i = 0; i < p.count; ++i )
+        {
+          const auto part = p.parts[i];
+          if ( part == "*" )
+          {
+            if ( t.nodes[node].wildcard == npos ) t.nodes[node].wildcard = t.nodeCount++;
+            node = t.nodes[node].wildcard;
+          }
+          else if ( part.starts_with( '{' ) ) node = child( t.nodes[node].params, part );
+          else node = child( t.nodes[node].statics, part );
+        }
+        owner[g] = node;
+      }
+
+      std::size_t terminal = 0;
+      for ( std::size_t n = 0; n < t.nodeCount; ++n )
+      {
+        t.nodes[n].first = terminal;
+        for ( std::size_t g = 0; g < groups.count; ++g )
+        {
+          if ( owner[g] == n ) t.terminals[terminal++] = g;
+        }
+        t.nodes[n].count = terminal - t.nodes[n].first;
+      }
+      return t;
+    }();
+
+    // Static segments sorting after `{` are visited after parameters, so exact
+    // matches for static paths are then looked up before the decision tree.
+    static constexpr bool lateStatics = []
+    {
+      for ( std::size_t e = 0; e < tree.edgeCount; ++e )
+      {
+        const auto& edge = tree.edges[e];
+        if ( !edge.text.starts_with( '{' ) && static_cast<unsigned char>( edge.text.front() ) >= '{' ) return true;
+      }
+      return false;
+    }();
+
+    enum class Band : std::uint8_t { Low, Middle, High };
+
+    static constexpr Band band( std::string_view text )
+    {
+      const auto lead = static_cast<unsigned char>( text.front() );
+      if ( lead < '{' ) return Band::Low;
+      if ( lead < '~' ) return Band::Middle;
+      return Band::High;
+    }
+
+  public:
+    using MapType [[maybe_unused]] = Map;
+
+    /**
+     * The key in the path parameters map with the sub-path that matches a wildcard
+     * route.  Same as HttpRouter::WildcardKey.
+     */
+    static inline const auto WildcardKey = std::string{ "_wildcard_" };
+
+    /**
+     * Error handler callback function.
+     */
+    using Handler = std::function<Response( Request, Map&& )>;
+
+    /**
+     * Create a new instance of the router.
+     * @param error404 Optional handler function to handle path not found condition.
+     * @param error405  Optional handler function to handle path not configured for method condition.
+     * @param error500 Optional handler function to handle exception caught while despatching the request to handler.
+     */
+    explicit StaticRouter( std::optional<Handler>&& error404 = std::nullopt,
+        std::optional<Handler>&& error405 = std::nullopt,
+        std::optional<Handler>&& error500 = std::nullopt ) :
+        notFound{ std::move( error404 ) }, methodNotAllowed{ std::move( error405 ) },
+        errorHandler{ std::move( error500 ) } {}
+
+    /**
+     * Attempt to route the request for specified path and method.
+     * @param method The HTTP method/verb from the client.
+     * @param path The request URI path.
+     * @param request The custom data used by the handler callback function.
+     * @param checkWithoutTrailingSlash If `true` and if the `path` ends with
+     *   a trailing slash ('/'), attempt to find a match after trimming the
+     *   trailing slash in case the original path does not match.
+     * @return Returns std::nullopt if no configured route matches.
+     */
+    std::optional<Response> route( std::string_view method, std::string_view path,
+        Request request, bool checkWithoutTrailingSlash = false ) const
+    {
+      if ( method.empty() || path.empty() ) return std::nullopt;
+      try
+      {
+        auto resp = routeParameters( method, path, request );
+        if ( !resp && checkWithoutTrailingSlash && path.ends_with( '/' ) )
+        {
+          return routeParameters( method, path.substr( 0, path.size() - 1 ), request );
+        }
+
+        return resp;
+      }
+      catch ( const std::exception& )
+      {
+        if ( errorHandler ) return (*errorHandler)( request, {} );
+        throw;
+      }
+    }
+
+    /// Check if a handler has been registered for the specified resource using the specified method/verb.
+    /// @param method The HTTP method/verb configured for the resourse
+    /// @param path The path to check if a handler has been configured
+    /// @return A tuple of two booleans.  The first value indicates the resource has a handler, while the
+    ///   second indicates if the method has been configured for the resource.
+    [[nodiscard]] std::tuple<bool, bool> canRoute( std::string_view method, std::string_view path ) const
+    {
+      if ( method.empty() || path.empty() ) return { false, false };
+
+      auto result = std::tuple<bool, bool>{ false, false };
+      auto visit = [&result, method]<std::size_t G, bool Literal = false>()
+      {
+        result = { true, allows<G>( method ) };
+      };
+
+      if ( beyond( path ) ) return result;
+      if ( literal( path, visit ) ) return result;
+
+      auto buffer = std::array<std::string_view, impl::MaxStaticSegments>{};
+      const auto count = util::segment( path, buffer );
+      if ( count > buffer.size() ) return result;
+      match( std::span{ buffer.data(), count }, path, visit );
+      return result;
+    }
+
+  private:
+    template <std::size_t G>
+    static bool allows( std::string_view method )
+    {
+      return [method]<std::size_t... R>( std::index_sequence<R...> )
+      {
+        return ( ( groups.group[R] == G && methods[R] == method ) || ... );
+      }( std::make_index_sequence<Count>{} );
+    }
+
+    // If every path sorts before the request path, HttpRouter does not route it, not even to the not found handler
+    static bool beyond( std::string_view path )
+    {
+      if constexpr ( Count == 0 ) return true;
+      else return impl::below( paths[groups.route[groups.count - 1]], path );
+    }
+
+    template <std::size_t G>
+    static constexpr bool parametrised()
+    {
+      constexpr auto p = impl::pattern( paths[groups.route[G]] );
+      return p.params > 0 && !p.wildcard;
+    }
+
+    // A request for a configured parametrised path as is, such as `/a/{id}`, is routed to it without parameters
+    template <typename Visit>
+    static bool literal( std::string_view path, Visit& visit )
+    {
+      return [&]<std::size_t... G>( std::index_sequence<G...> )
+      {
+        return ( literalAt<G>( path, visit ) || ... );
+      }( std::make_index_sequence<groups.count>{} );
+    }
+
+    template <std::size_t G, typename Visit>
+    static bool literalAt( std::string_view path, Visit& visit )
+    {
+      if constexpr ( !parametrised<G>() ) return false;
+      else
+      {
+        if ( path != paths[groups.route[G]] ) return false;
+        visit.template operator()<G, true>();
+        return true;
+      }
+    }
+
+    template <typename Visit>
+    static bool match( std::span<const std::string_view> parts, std::string_view path, Visit& visit )
+    {
+      if constexpr ( lateStatics )
+      {
+        if ( exact<0>( parts, path, 0, visit ) ) return true;
+      }
+      return find<0>( parts, path, 0, visit );
+    }
+
+    template <std::size_t N, typename Visit>
+    static bool exact( std::span<const std::string_view> parts, std::string_view path, std::size_t depth, Visit& visit )
+    {
+      if ( depth == parts.size() ) return terminal<N, true>( path, visit );
+      else return exactEdge<tree.nodes[N].statics>( parts, path, depth, visit );
+    }
+
+    template <std::size_t E, typename Visit>
+    static bool exactEdge( std::span<const std::string_view> parts, std::string_view path, std::size_t depth, Visit& visit )
+    {
+      if constexpr ( E == npos ) return false;
+      else
+      {
+        constexpr auto edge = tree.edges[E];
+        if ( parts[depth] == edge.text ) return exact<edge.child>( parts, path, depth + 1, visit );
+        return exactEdge<edge.next>( parts, path, depth, visit );
+      }
+    }
+
+    // Visit the first group of the node that does not sort before the request path, as impl::Trie::terminal.
+    // If `Exact`, only a static path that is the request path is visited.
+    template <std::size_t N, bool Exact, std::size_t I = 0, typename Visit>
+    static bool terminal( std::string_view path, Visit& visit )
+    {
+      if constexpr ( I == tree.nodes[N].count ) return false;
+      else
+      {
+        constexpr auto group = tree.terminals[tree.nodes[N].first + I];
+        constexpr auto configured = paths[groups.route[group]];
+        if constexpr ( Exact )
+        {
+          constexpr auto p = impl::pattern( configured );
+          if ( p.params == 0 && !p.wildcard && configured == path )
+          {
+            visit.template operator()<group>();
+            return true;
+          }
+        }
+        else if ( !impl::below( configured, path ) )
+        {
+          visit.template operator()<group>();
+          return true;
+        }
+        return terminal<N, Exact, I + 1>( path, visit );
+      }
+    }
+
+    // Same visiting order and lower bound as impl::Trie::find
+    template <std::size_t N, typename Visit>
+    static bool find( std::span<const std::string_view> parts, std::string_view path, std::size_t depth, Visit& visit )
+    {
+      constexpr auto node = tree.nodes[N];
+      if ( depth == parts.size() ) return terminal<N, false>( path, visit );
+
+      if ( statics<node.statics, Band::Low>( parts, path, depth, visit ) ) return true;
+      if ( params<node.params>( parts, path, depth, visit ) ) return true;
+      if ( statics<node.statics, Band::Middle>( parts, path, depth, visit ) ) return true;
+      if constexpr ( node.wildcard != npos )
+      {
+        if ( terminal<node.wildcard, false>( path, visit ) ) return true;
+      }
+      return statics<node.statics, Band::High>( parts, path, depth, visit );
+    }
+
+    template <std::size_t E, Band B, typename Visit>
+    static bool statics( std::span<const std::string_view> parts, std::string_view path, std::size_t depth, Visit& visit )
+    {
+      if constexpr ( E == npos ) return false;
+      else
+      {
+        constexpr auto edge = tree.edges[E];
+        if constexpr ( band( edge.text ) == B )
+        {
+          // At most one static segment can match, no need to check the others
+          if ( parts[depth] == edge.text ) return find<edge.child>( parts, path, depth + 1, visit );
+        }
+        return statics<edge.next, B>( parts, path, depth, visit );
+      }
+    }
+
+    template <std::size_t E>
+    static bool accepts( std::string_view part )
+    {
+      constexpr auto edge = tree.edges[E];
+      constexpr auto c = impl::constraint( edge.text ).value_or( Constraint::None );
+      if constexpr ( c == Constraint::Regex )
+      {
+        // Compiled once on first use, the automaton cannot be built at compile time
+        static const auto dfa = impl::Dfa::compile( impl::type( edge.text ) );
+        return dfa.match( part );
+      }
+      else return impl::valid( c, part );
+    }
+
+    template <std::size_t E, typename Visit>
+    static bool params( std::span<const std::string_view> parts, std::string_view path, std::size_t depth, Visit& visit )
+    {
+      if constexpr ( E == npos ) return false;
+      else
+      {
+        constexpr auto edge = tree.edges[E];
+        if ( accepts<E>( parts[depth] ) && find<edge.child>( parts, path, depth + 1, visit ) ) return true;
+        return params<edge.next>( parts, path, depth, visit );
+      }
+    }
+
+    std::optional<Response> routeParameters( std::string_view method, std::string_view path, Request request ) const
+    {
+      if ( beyond( path ) ) return std::nullopt;
+
+      auto buffer = std::array<std::string_view, impl::MaxStaticSegments>{};
+      const auto count = util::segment( path, buffer );
+
+      auto resp = std::optional<Response>{};
+      auto visit = [&]<std::size_t G, bool Literal = false>()
+      {
+        resp = dispatch<G, Literal>( method, std::span{ buffer.data(), count }, path, request );
+      };
+
+      if ( literal( path, visit ) ) return resp;
+      if ( count <= buffer.size() && match( std::span{ buffer.data(), count }, path, visit ) ) return resp;
+      if ( notFound ) return (*notFound)( request, Map{} );
+      return std::nullopt;
+    }
+
+    // The parameters are not extracted from a `Literal` request for the configured path, as HttpRouter::routeExact
+    template <std::size_t G, bool Literal>
+    std::optional<Response> dispatch( std::string_view method, std::span<const std::string_view> parts,
+        std::string_view path, Request request ) const
+    {
+      static constexpr auto p = impl::pattern( paths[groups.route[G]] );
+
+      Map params{};
+      if constexpr ( !Literal )
+      {
+        for ( std::size_t i = 0; i < p.count; ++i )
+        {
+          if ( !p.parts[i].starts_with( '{' ) ) continue;
+          const auto key = impl::parameter( p.parts[i] );
+          params.try_emplace( { key.data(), key.size() }, parts[i] );
+        }
+      }
+
+      auto resp = std::optional<Response>{};
+      const auto found = [&]<std::size_t... R>( std::index_sequence<R...> )
+      {
+        return ( invoke<G, R>( method, params, parts, path, request, resp ) || ... );
+      }( std::make_index_sequence<Count>{} );
+      if ( found ) return resp;
+
+      if ( methodNotAllowed ) return (*methodNotAllowed)( request, std::move( params ) );
+      return std::nullopt;
+    }
+
+    template <std::size_t G, std::size_t R>
+    static bool invoke( std::string_view method, Map& params, std::span<const std::string_view> parts,
+        std::string_view path, Request request, std::optional<Response>& resp )
+    {
+      if constexpr ( groups.group[R] != G ) return false;
+      else
+      {
+        if ( method != methods[R] ) return false;
+
+        if constexpr ( impl::pattern( paths[R] ).wildcard )
+        {
+          std::size_t offset = 0;
+          for ( std::size_t j = 0; j < impl::pattern( paths[R] ).count - 1; ++j ) offset += ( 1 + parts[j].size() );
+          params.try_emplace( WildcardKey, path.substr( ++offset ) );
+        }
+
+        resp = std::invoke( RouteAt<R>::handler, request, std::move( params ) );
+        return true;
+      }
+    }
+
+    std::optional<Handler> notFound{ std::nullopt };
+    std::optional<Handler> methodNotAllowed{ std::nullopt };
+    std::optional<Handler> errorHandler{ std::nullopt };
+  };
+}
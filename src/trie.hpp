@@ -0,0 +1,240 @@
+#pragma once
+
+#include "constraint.hpp"
+#include "fold.hpp"
+#include "regex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace spt::http::router::impl
+{
+  /**
+   * Trie keyed on path segments used to resolve dynamic routes.  Each node has
+   * sorted static children, parameter children (sorted by their `{name}` or
+   * `{name:type}` text, almost always just one), and at most one wildcard child.
+   * Terminal nodes hold indices into the sorted route table maintained by the router.
+   * A parameter child with a constraint is only visited if the segment satisfies
+   * the constraint, otherwise matching continues with the next child.  The
+   * static children of a case-insensitive router are folded to lower case.
+   *
+   * Lookup cost depends on the depth of the request path and the number of
+   * parameter branches that need to be backtracked, not on the number of routes.
+   * Children are visited in the same byte order as the sorted route table, so the
+   * first match found is the same route a scan of the sorted table would find.
+   */
+  struct Trie
+  {
+    static constexpr auto npos = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * Add the route with the specified parsed parts.
+     * @param parts The segments of the configured path.  Parameters are in the
+     *   `{name}` or `{name:type}` form and the wildcard is represented by `~`.
+     *   Constraint types must be valid.
+     * @param route The index of the route in the sorted route table.
+     * @param patterns The automata compiled for the parts that are constrained by
+     *   a regular expression, indexed as `parts`.  Compiled here if not specified.
+     */
+    void insert( const std::vector<std::string>& parts, std::size_t route,
+        std::span<const std::shared_ptr<const Dfa>> patterns = {} )
+    {
+      std::size_t node = 0;
+      for ( std::size_t i = 0; i < parts.size(); ++i )
+      {
+        const auto& part = parts[i];
+        if ( part == "~" ) node = wildcard( node );
+        else if ( part.starts_with( '{' ) )
+        {
+          node = child( node, part, &Node::params );
+          auto& n = nodes[node];
+          n.constraint = constraint( part ).value_or( Constraint::None );
+          if ( n.constraint == Constraint::Regex && !n.pattern )
+          {
+            n.pattern = i < patterns.size() && patterns[i] ? patterns[i] : std::make_shared<const Dfa>( Dfa::compile( type( part ) ) );
+          }
+        }
+        else node = child( node, part, &Node::statics );
+      }
+
+      auto& routes = nodes[node].routes;
+      routes.insert( std::upper_bound( std::begin( routes ), std::end( routes ), route ), route );
+    }
+
+    /**
+     * Adjust route indices after a route has been inserted into the sorted table.
+     * @param from The position at which the new route was inserted.  All indices
+     *   at or after this position are incremented.
+     */
+    void shift( std::size_t from )
+    {
+      for ( auto&& node : nodes )
+      {
+        for ( auto&& route : node.routes ) if ( route >= from ) ++route;
+      }
+    }
+
+    /**
+     * Remove the route with the specified parsed parts, and adjust the indices
+     * of the routes after it in the sorted table.  Nodes are left in place, a
+     * node without routes or children never matches.
+     * @param parts The segments of the configured path.
+     * @param route The index of the route in the sorted route table.
+     */
+    void erase( const std::vector<std::string>& parts, std::size_t route )
+    {
+      std::size_t node = 0;
+      for ( const auto& part : parts )
+      {
+        if ( part == "~" ) node = nodes[node].wildcard;
+        else if ( part.starts_with( '{' ) ) node = existing( node, part, &Node::params );
+        else node = existing( node, part, &Node::statics );
+        if ( node == npos ) return;
+      }
+
+      std::erase( nodes[node].routes, route );
+      for ( auto&& n : nodes )
+      {
+        for ( auto&& r : n.routes ) if ( r > route ) --r;
+      }
+    }
+
+    /**
+     * Find the first route that matches the specified request path segments.
+     * @param parts The non-empty segments of the request path.
+     * @param from Only routes at or after this position in the sorted table are
+     *   considered, mirroring the binary search performed on the table.
+     * @param folded If `true`, the static segments were folded to lower case when
+     *   the routes were inserted, and are compared with the request segments in
+     *   any case.  Parameter segments are passed to constraints as they are.
+     * @return The index of the matching route or `npos`.
+     */
+    template <typename Parts>
+    [[nodiscard]] std::size_t match( const Parts& parts, std::size_t from, bool folded = false ) const
+    {
+      if ( parts.empty() ) return npos;
+      return find( 0, 0, parts, from, folded );
+    }
+
+  private:
+    struct Node
+    {
+      std::vector<std::pair<std::string, std::size_t>> statics;
+      std::vector<std::pair<std::string, std::size_t>> params;
+      std::vector<std::size_t> routes;
+      std::size_t wildcard{ npos };
+      // Constraint on the parameter segment leading to this node
+      std::shared_ptr<const Dfa> pattern;
+      Constraint constraint{ Constraint::None };
+    };
+
+    using Children = std::vector<std::pair<std::string, std::size_t>> Node::*;
+
+    static bool less( const std::pair<std::string, std::size_t>& c, std::string_view part )
+    {
+      return std::string_view{ c.first } < part;
+    }
+
+    static bool lessFolded( const std::pair<std::string, std::size_t>& c, std::string_view part )
+    {
+      return util::compareFolded( c.first, part ) < 0;
+    }
+
+    std::size_t child( std::size_t node, const std::string& part, Children children )
+    {
+      auto& cs = nodes[node].*children;
+      auto it = std::lower_bound( std::begin( cs ), std::end( cs ), std::string_view{ part }, &Trie::less );
+      if ( it != std::end( cs ) && it->first == part ) return it->second;
+
+      const auto idx = nodes.size();
+      cs.emplace( it, part, idx );
+      nodes.emplace_back();
+      return idx;
+    }
+
+    [[nodiscard]] std::size_t existing( std::size_t node, const std::string& part, Children children ) const
+    {
+      const auto& cs = nodes[node].*children;
+      auto it = std::lower_bound( std::cbegin( cs ), std::cend( cs ), std::string_view{ part }, &Trie::less );
+      return it != std::cend( cs ) && it->first == part ? it->second : npos;
+    }
+
+    std::size_t wildcard( std::size_t node )
+    {
+      if ( nodes[node].wildcard != npos ) return nodes[node].wildcard;
+
+      const auto idx = nodes.size();
+      nodes[node].wildcard = idx;
+      nodes.emplace_back();
+      return idx;
+    }
+
+    [[nodiscard]] static bool accepts( const Node& node, std::string_view part ) noexcept
+    {
+      if ( node.constraint == Constraint::Regex ) return node.pattern->match( part );
+      return valid( node.constraint, part );
+    }
+
+    [[nodiscard]] std::size_t terminal( std::size_t node, std::size_t from ) const
+    {
+      const auto& routes = nodes[node].routes;
+      auto it = std::lower_bound( std::cbegin( routes ), std::cend( routes ), from );
+      return it == std::cend( routes ) ? npos : *it;
+    }
+
+    template <typename Parts>
+    [[nodiscard]] std::size_t find( std::size_t idx, std::size_t depth, const Parts& parts, std::size_t from, bool folded ) const
+    {
+      if ( depth == parts.size() ) return terminal( idx, from );
+
+      const auto& node = nodes[idx];
+      const auto part = std::string_view{ parts[depth] };
+
+      auto st = npos;
+      auto lead = std::numeric_limits<unsigned char>::max();
+      if ( !node.statics.empty() )
+      {
+        // Fold the segment once for the search, unless it is too long for the stack
+        std::array<char, MaxFolded> buffer;
+        const auto fold = folded && part.size() <= buffer.size();
+        const auto key = fold ? util::fold( part, buffer ) : part;
+        const auto caseless = folded && !fold;
+
+        auto it = std::lower_bound( std::cbegin( node.statics ), std::cend( node.statics ), key,
+            caseless ? &Trie::lessFolded : &Trie::less );
+        if ( it != std::cend( node.statics ) && ( caseless ? util::equalsFolded( it->first, key ) : it->first == key ) )
+        {
+          st = it->second;
+          lead = static_cast<unsigned char>( it->first.front() );
+        }
+      }
+
+      // Visit children in the byte order of the sorted table: `{` sorts before `~`
+      auto result = npos;
+      if ( st != npos && lead < '{' && ( result = find( st, depth + 1, parts, from, folded ) ) != npos ) return result;
+
+      for ( const auto& [_, p] : node.params )
+      {
+        if ( !accepts( nodes[p], part ) ) continue;
+        if ( ( result = find( p, depth + 1, parts, from, folded ) ) != npos ) return result;
+      }
+
+      if ( st != npos && lead >= '{' && lead < '~' && ( result = find( st, depth + 1, parts, from, folded ) ) != npos ) return result;
+      if ( node.wildcard != npos && ( result = terminal( node.wildcard, from ) ) != npos ) return result;
+      if ( st != npos && lead >= '~' ) return find( st, depth + 1, parts, from, folded );
+      return npos;
+    }
+
+    static constexpr std::size_t MaxFolded = 64;
+
+    std::vector<Node> nodes{ 1 };
+  };
+}
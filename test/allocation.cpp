@@ -0,0 +1,153 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include <cstdlib>
+#include <new>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+  thread_local bool tracking{ false };
+  thread_local std::size_t allocations{ 0 };
+
+  struct Tracker
+  {
+    Tracker() { allocations = 0; tracking = true; }
+    ~Tracker() { tracking = false; }
+    Tracker(const Tracker&) = delete;
+    Tracker& operator=(const Tracker&) = delete;
+  };
+}
+
+// GCC sees the inlined replacements as a malloc/free mismatch when optimising
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new( std::size_t size )
+{
+  if ( tracking ) ++allocations;
+  if ( auto p = std::malloc( size == 0 ? 1 : size ) ) return p;
+  throw std::bad_alloc{};
+}
+
+void operator delete( void* p ) noexcept { std::free( p ); }
+void operator delete( void* p, std::size_t ) noexcept { std::free( p ); }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+SCENARIO( "Allocation free routing test suite" )
+{
+  struct Request {} request;
+  using Params = spt::http::router::InlineParams<4>;
+  using Router = spt::http::router::HttpRouter<const Request&, std::size_t, Params>;
+
+  GIVEN( "Router with static, parametrised and wildcard paths" )
+  {
+    Router r{ []( const Request&, Params&& ) -> std::size_t { return 404; },
+        []( const Request&, Params&& ) -> std::size_t { return 405; } };
+    r.add( "GET"sv, "/device/sensor/"sv, []( const Request&, Params&& args ) { return args.size(); } );
+    r.add( "GET"sv, "/device/sensor/id/{id}"sv, []( const Request&, Params&& args )
+    {
+      return args["id"sv].size();
+    } );
+    r.add( "GET"sv, "/device/sensor/{property}/between/{start}/{end}"sv, []( const Request&, Params&& args )
+    {
+      return args.size();
+    } );
+    r.add( "GET"sv, "/device/file/*"sv, [&r]( const Request&, Params&& args )
+    {
+      return args[r.WildcardKey].size();
+    } );
+
+    WHEN( "Routing a static path" )
+    {
+      auto tracker = Tracker{};
+      auto resp = r.route( "GET"sv, "/device/sensor/"sv, request );
+      auto [p, m] = r.canRoute( "GET"sv, "/device/sensor/"sv );
+      CHECK( allocations == 0 );
+      REQUIRE( resp );
+      CHECK( *resp == 0 );
+      CHECK( p );
+      CHECK( m );
+    }
+
+    AND_WHEN( "Routing parametrised paths" )
+    {
+      auto tracker = Tracker{};
+      auto resp = r.route( "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv, request );
+      auto between = r.route( "GET"sv, "/device/sensor/created/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z"sv, request );
+      auto [p, m] = r.canRoute( "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv );
+      CHECK( allocations == 0 );
+      REQUIRE( resp );
+      CHECK( *resp == 24 );
+      REQUIRE( between );
+      CHECK( *between == 3 );
+      CHECK( p );
+      CHECK( m );
+    }
+
+    AND_WHEN( "Routing a wildcard path" )
+    {
+      auto tracker = Tracker{};
+      auto resp = r.route( "GET"sv, "/device/file/path/to/file.txt"sv, request );
+      auto [p, m] = r.canRoute( "GET"sv, "/device/file/path/to/file.txt"sv );
+      CHECK( allocations == 0 );
+      REQUIRE( resp );
+      CHECK( *resp == 16 );
+      CHECK( p );
+      CHECK( m );
+    }
+
+    AND_WHEN( "Routing paths that are not found or not allowed" )
+    {
+      auto tracker = Tracker{};
+      auto notFound = r.route( "GET"sv, "/device/other/id/6230f3069e7c9be9ff4b78a1"sv, request );
+      auto notAllowed = r.route( "PUT"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv, request );
+      CHECK( allocations == 0 );
+      REQUIRE( notFound );
+      CHECK( *notFound == 404 );
+      REQUIRE( notAllowed );
+      CHECK( *notAllowed == 405 );
+    }
+
+    AND_WHEN( "Routing with the compiled router" )
+    {
+      const auto compiled = r.compile();
+      auto tracker = Tracker{};
+      auto exact = compiled.route( "GET"sv, "/device/sensor/"sv, request );
+      auto param = compiled.route( "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv, request );
+      auto wildcard = compiled.route( "GET"sv, "/device/file/path/to/file.txt"sv, request );
+      auto notFound = compiled.route( "GET"sv, "/device/other/id/6230f3069e7c9be9ff4b78a1"sv, request );
+      auto [p, m] = compiled.canRoute( "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv );
+      CHECK( allocations == 0 );
+      REQUIRE( exact );
+      CHECK( *exact == 0 );
+      REQUIRE( param );
+      CHECK( *param == 24 );
+      REQUIRE( wildcard );
+      CHECK( *wildcard == 16 );
+      REQUIRE( notFound );
+      CHECK( *notFound == 404 );
+      CHECK( p );
+      CHECK( m );
+    }
+
+    AND_WHEN( "Routing a path with more segments than fit on the stack" )
+    {
+      auto path = "/device/file"s;
+      for ( auto i = 0; i < 40; ++i ) path.append( "/segment" );
+      auto resp = r.route( "GET"sv, path, request );
+      REQUIRE( resp );
+      CHECK( *resp == 40 * 8 - 1 );
+    }
+  }
+}
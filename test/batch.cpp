@@ -0,0 +1,150 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+SCENARIO( "Batch routing test suite" )
+{
+  struct Request
+  {
+    std::size_t index{ 0 };
+    mutable std::vector<std::size_t>* calls{ nullptr };
+  };
+  using Router = spt::http::router::HttpRouter<const Request&, std::string>;
+  using spt::http::router::RouteInput;
+
+  GIVEN( "Router with static, parametrised and wildcard paths" )
+  {
+    auto calls = std::vector<std::size_t>{};
+    auto r = Router::Builder{}.
+        withNotFound( []( const Request&, Router::MapType&& ) { return "404"s; } ).
+        withMethodNotAllowed( []( const Request&, Router::MapType&& ) { return "405"s; } ).
+        withErrorHandler( []( const Request&, Router::MapType&& ) { return "500"s; } ).build();
+    r.add( "GET"sv, "/device/sensor/"sv, []( const Request& req, auto&& )
+    {
+      req.calls->push_back( req.index );
+      return "root"s;
+    } );
+    r.add( "GET"sv, "/device/sensor/id/{id}"sv, []( const Request& req, Router::MapType&& args )
+    {
+      req.calls->push_back( req.index );
+      return "id|"s.append( args["id"] );
+    } );
+    r.add( "GET"sv, "/device/sensor/{property}/between/{start}/{end}"sv, []( const Request& req, Router::MapType&& args )
+    {
+      req.calls->push_back( req.index );
+      return "between|"s.append( args["property"] ).append( "|" ).append( args["start"] ).append( "|" ).append( args["end"] );
+    } );
+    r.add( "GET"sv, "/device/file/*"sv, []( const Request& req, Router::MapType&& args )
+    {
+      req.calls->push_back( req.index );
+      return "file|"s.append( args[Router::WildcardKey] );
+    } );
+    r.add( "GET"sv, "/device/error/"sv, []( const Request&, auto&& ) -> std::string
+    {
+      throw std::runtime_error{ "error" };
+    } );
+
+    WHEN( "Routing a batch of requests" )
+    {
+      const auto inputs = std::vector<RouteInput>{
+          { "GET"sv, "/device/sensor/id/abc"sv },
+          { "GET"sv, "/device/file/a/b/c.txt"sv },
+          { "GET"sv, "/device/sensor/"sv },
+          { "PUT"sv, "/device/sensor/id/abc"sv },
+          { "GET"sv, "/device/sensor/count/between/1/2"sv },
+          { "GET"sv, "/device/abc/x"sv },
+          { "GET"sv, "/zzz"sv },
+          { "GET"sv, "/device/error/"sv },
+          { ""sv, "/device/sensor/"sv },
+          { "GET"sv, "/device/sensor/id/{id}"sv }
+      };
+      auto requests = std::vector<Request>( inputs.size() );
+      for ( std::size_t i = 0; i < requests.size(); ++i ) requests[i] = Request{ i, &calls };
+
+      auto responses = std::vector<std::optional<std::string>>( inputs.size() );
+      const auto count = r.routeBatch( inputs, responses, [&requests]( std::size_t i ) -> const Request&
+      {
+        return requests[i];
+      } );
+      REQUIRE( count == inputs.size() );
+
+      CHECK( responses[0] == "id|abc"s );
+      CHECK( responses[1] == "file|a/b/c.txt"s );
+      CHECK( responses[2] == "root"s );
+      CHECK( responses[3] == "405"s );
+      CHECK( responses[4] == "between|count|1|2"s );
+      CHECK( responses[5] == "404"s );
+      CHECK_FALSE( responses[6] );
+      CHECK( responses[7] == "500"s );
+      CHECK_FALSE( responses[8] );
+      CHECK( responses[9] == "id|"s );
+
+      // Handlers are invoked in input order
+      CHECK( calls == std::vector<std::size_t>{ 0, 1, 2, 4, 9 } );
+
+      for ( std::size_t i = 0; i < inputs.size(); ++i )
+      {
+        CHECK( r.route( inputs[i].method, inputs[i].path, requests[i] ) == responses[i] );
+      }
+    }
+
+    AND_WHEN( "Routing a batch larger than the internal chunk size" )
+    {
+      auto paths = std::vector<std::string>{};
+      for ( auto i = 0; i < 100; ++i ) paths.push_back( "/device/sensor/id/"s.append( std::to_string( 99 - i ) ) );
+      auto inputs = std::vector<RouteInput>{};
+      for ( const auto& path : paths ) inputs.push_back( { "GET"sv, path } );
+
+      auto responses = std::vector<std::optional<std::string>>( inputs.size() );
+      const auto request = Request{ 0, &calls };
+      REQUIRE( r.routeBatch( inputs, responses, request ) == inputs.size() );
+      for ( std::size_t i = 0; i < inputs.size(); ++i )
+      {
+        REQUIRE( responses[i] );
+        CHECK( *responses[i] == "id|"s.append( std::to_string( 99 - i ) ) );
+      }
+      CHECK( calls.size() == inputs.size() );
+    }
+
+    AND_WHEN( "Routing a batch with fewer responses than inputs" )
+    {
+      const auto inputs = std::vector<RouteInput>{
+          { "GET"sv, "/device/sensor/id/abc"sv },
+          { "GET"sv, "/device/sensor/"sv }
+      };
+      auto responses = std::vector<std::optional<std::string>>( 1 );
+      CHECK( r.routeBatch( inputs, responses, Request{ 0, &calls } ) == 1 );
+      CHECK( responses[0] == "id|abc"s );
+      CHECK( calls.size() == 1 );
+    }
+
+    AND_WHEN( "Routing a batch with trailing slashes" )
+    {
+      Router plain;
+      plain.add( "GET"sv, "/device/sensor"sv, []( const Request&, auto&& ) { return "sensor"s; } );
+      plain.add( "GET"sv, "/device/sensor/id/{id}"sv, []( const Request&, Router::MapType&& args )
+      {
+        return "id|"s.append( args["id"] );
+      } );
+
+      const auto inputs = std::vector<RouteInput>{ { "GET"sv, "/device/sensor/"sv }, { "GET"sv, "/device/sensor/id/abc/"sv } };
+      auto responses = std::vector<std::optional<std::string>>( inputs.size() );
+      plain.routeBatch( inputs, responses, Request{}, true );
+      CHECK( responses[0] == "sensor"s );
+      CHECK( responses[1] == "id|abc"s );
+
+      plain.routeBatch( inputs, responses, Request{} );
+      CHECK_FALSE( responses[0] );
+      CHECK( responses[1] == plain.route( "GET"sv, "/device/sensor/id/abc/"sv, Request{} ) );
+    }
+  }
+}
@@ -0,0 +1,272 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include <string>
+#include <vector>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+SCENARIO( "Bulk route registration test suite" )
+{
+  struct Request {} request;
+  using Router = spt::http::router::HttpRouter<const Request&, std::string>;
+  using Map = Router::MapType;
+
+  auto echo = []( std::string prefix )
+  {
+    return [prefix]( const Request&, Map&& args )
+    {
+      auto out = prefix;
+      for ( auto&& [k, v] : args ) out.append( "|" ).append( k ).append( "=" ).append( v );
+      return out;
+    };
+  };
+
+  GIVEN( "Router configured with addAll" )
+  {
+    auto r = Router::Builder{}.
+        withNotFound( []( const Request&, Map&& ) { return "404"s; } ).
+        withMethodNotAllowed( []( const Request&, Map&& ) { return "405"s; } ).build();
+
+    auto routes = std::vector<Router::RouteSpec>{
+        { "GET"sv, "/device/sensor/id/{id}"sv, echo( "get-id" ) },
+        { "GET"sv, "/device/sensor/"sv, echo( "list" ) },
+        { "PUT"sv, "/device/sensor/id/{id}"sv, echo( "put-id" ) },
+        { "PURGE"sv, "/device/sensor/"sv, echo( "purge" ) },
+        { "GET"sv, "/device/file/*"sv, echo( "file" ) },
+        { "GET"sv, "/device/sensor/{property}/between/{start}/{end}"sv, echo( "between" ) },
+        { "POST"sv, "/device/sensor/"sv, echo( "create" ) },
+    };
+    r.addAll( routes );
+
+    WHEN( "Routing requests" )
+    {
+      auto resp = r.route( "GET"sv, "/device/sensor/"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "list"s );
+
+      resp = r.route( "POST"sv, "/device/sensor/"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "create"s );
+
+      resp = r.route( "PURGE"sv, "/device/sensor/"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "purge"s );
+
+      resp = r.route( "PUT"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "put-id|id=abc"s );
+
+      resp = r.route( "GET"sv, "/device/sensor/count/between/1/2"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "between|end=2|property=count|start=1"s );
+
+      resp = r.route( "GET"sv, "/device/file/a/b.txt"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "file|_wildcard_=a/b.txt"s );
+
+      resp = r.route( "DELETE"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "405"s );
+
+      resp = r.route( "GET"sv, "/device/abc/x"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "404"s );
+    }
+
+    AND_WHEN( "Adding more routes in bulk and individually" )
+    {
+      auto more = std::vector<Router::RouteSpec>{
+          { "DELETE"sv, "/device/sensor/id/{id}"sv, echo( "delete-id" ) },
+          { "GET"sv, "/device/a/"sv, echo( "a" ) },
+          { "GET"sv, "/device/z/"sv, echo( "z" ) },
+      };
+      r.addAll( more );
+      r.add( "GET"sv, "/device/m/"sv, echo( "m" ) );
+
+      auto resp = r.route( "DELETE"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "delete-id|id=abc"s );
+
+      for ( auto&& p : { "a"s, "m"s, "z"s } )
+      {
+        resp = r.route( "GET"sv, "/device/"s + p + "/", request );
+        REQUIRE( resp );
+        CHECK( *resp == p );
+      }
+
+      resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "get-id|id=abc"s );
+    }
+
+    AND_WHEN( "Removing routes added in bulk" )
+    {
+      CHECK( r.remove( "GET"sv, "/device/file/*"sv ) );
+      auto resp = r.route( "GET"sv, "/device/file/a/b.txt"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "404"s );
+
+      CHECK( r.remove( "PUT"sv, "/device/sensor/id/{id}"sv ) );
+      resp = r.route( "PUT"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "405"s );
+
+      resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "get-id|id=abc"s );
+    }
+
+    AND_WHEN( "Adding a route that duplicates one already configured" )
+    {
+      auto duplicate = std::vector<Router::RouteSpec>{
+          { "GET"sv, "/device/other/"sv, echo( "other" ) },
+          { "GET"sv, "/device/sensor/"sv, echo( "again" ) },
+      };
+      CHECK_THROWS_AS( r.addAll( duplicate ), spt::http::router::DuplicateRouteError );
+
+      AND_THEN( "No route was added" )
+      {
+        const auto [path, method] = r.canRoute( "GET"sv, "/device/other/"sv );
+        CHECK_FALSE( path );
+        CHECK_FALSE( method );
+
+        auto resp = r.route( "GET"sv, "/device/sensor/"sv, request );
+        REQUIRE( resp );
+        CHECK( *resp == "list"s );
+      }
+    }
+
+    AND_WHEN( "Adding a parametrised route that clashes with one already configured" )
+    {
+      auto clash = std::vector<Router::RouteSpec>{
+          { "GET"sv, "/device/sensor/id/{key}"sv, echo( "key" ) },
+      };
+      CHECK_THROWS_AS( r.addAll( clash ), spt::http::router::DuplicateRouteError );
+
+      auto method = std::vector<Router::RouteSpec>{
+          { "DELETE"sv, "/device/sensor/id/{key}"sv, echo( "key" ) },
+      };
+      CHECK_NOTHROW( r.addAll( method ) );
+    }
+  }
+
+  GIVEN( "Invalid sets of routes" )
+  {
+    Router r;
+    r.add( "GET"sv, "/device/sensor/"sv, echo( "list" ) );
+
+    WHEN( "The same route is specified twice" )
+    {
+      auto routes = std::vector<Router::RouteSpec>{
+          { "GET"sv, "/device/sensor/id/{id}"sv, echo( "one" ) },
+          { "GET"sv, "/device/sensor/id/{id}"sv, echo( "two" ) },
+      };
+      CHECK_THROWS_AS( r.addAll( routes ), spt::http::router::DuplicateRouteError );
+    }
+
+    AND_WHEN( "Parametrised routes clash with each other" )
+    {
+      auto routes = std::vector<Router::RouteSpec>{
+          { "GET"sv, "/device/sensor/id/{key}"sv, echo( "one" ) },
+          { "POST"sv, "/device/sensor/id/{id}"sv, echo( "two" ) },
+          { "GET"sv, "/device/sensor/id/{id}"sv, echo( "three" ) },
+      };
+      CHECK_THROWS_AS( r.addAll( routes ), spt::http::router::DuplicateRouteError );
+    }
+
+    AND_WHEN( "A wildcard is not the last character" )
+    {
+      auto routes = std::vector<Router::RouteSpec>{
+          { "GET"sv, "/device/file/*/x"sv, echo( "file" ) },
+      };
+      CHECK_THROWS_AS( r.addAll( routes ), spt::http::router::InvalidWildcardError );
+    }
+
+    AND_WHEN( "A parameter is not closed" )
+    {
+      auto routes = std::vector<Router::RouteSpec>{
+          { "GET"sv, "/device/a/"sv, echo( "a" ) },
+          { "GET"sv, "/device/sensor/id/{id"sv, echo( "id" ) },
+      };
+      CHECK_THROWS_AS( r.addAll( routes ), spt::http::router::InvalidParameterError );
+
+      AND_THEN( "No route was added" )
+      {
+        const auto [path, method] = r.canRoute( "GET"sv, "/device/a/"sv );
+        CHECK_FALSE( path );
+        CHECK_FALSE( method );
+      }
+    }
+  }
+
+  GIVEN( "Routers configured individually and in bulk with the same routes" )
+  {
+    Router single;
+    Router bulk;
+    auto routes = std::vector<Router::RouteSpec>{};
+    auto requests = std::vector<std::pair<std::string, std::string>>{};
+    auto paths = std::vector<std::string>{};
+    paths.reserve( 1000 );
+    for ( auto i = 999; i >= 0; --i )
+    {
+      auto base = "/api/entity"s + std::to_string( i % 250 );
+      const auto kind = i % 4;
+      const auto method = i % 8 < 4 ? "GET"sv : "PATCH"sv;
+      paths.push_back( base + ( kind == 0 ? "/" : kind == 1 ? "/id/{id}" : kind == 2 ? "/{p}/between/{s}/{e}" : "/files/*" ) );
+      single.add( method, paths.back(), echo( paths.back() ) );
+      routes.push_back( { method, paths.back(), echo( paths.back() ) } );
+
+      requests.emplace_back( method, base + ( kind == 0 ? "/" : kind == 1 ? "/id/x" : kind == 2 ? "/a/between/1/2" : "/files/a/b" ) );
+      requests.emplace_back( "DELETE"s, requests.back().second );
+      requests.emplace_back( method, base + "/unknown/path" );
+    }
+    bulk.addAll( routes );
+
+    THEN( "Both route requests identically" )
+    {
+      for ( auto&& [method, path] : requests )
+      {
+        CHECK( single.canRoute( method, path ) == bulk.canRoute( method, path ) );
+        CHECK( single.route( method, path, request ) == bulk.route( method, path, request ) );
+      }
+    }
+  }
+
+  GIVEN( "Instrumented router configured with addAll" )
+  {
+    using Instrumented = spt::http::router::HttpRouter<const Request&, std::string, Map,
+        std::function<std::string( const Request&, Map&& )>, 0, true>;
+    Instrumented r;
+    auto routes = std::vector<Instrumented::RouteSpec>{
+        { "GET"sv, "/device/sensor/id/{id}"sv, echo( "get" ) },
+        { "PUT"sv, "/device/sensor/id/{id}"sv, echo( "put" ) },
+        { "GET"sv, "/device/sensor/"sv, echo( "list" ) },
+    };
+    r.addAll( routes );
+
+    WHEN( "Routing requests" )
+    {
+      r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      r.route( "PUT"sv, "/device/sensor/id/abc"sv, request );
+      r.route( "PUT"sv, "/device/sensor/id/abc"sv, request );
+      r.route( "POST"sv, "/device/sensor/"sv, request );
+
+      const auto stats = r.stats();
+      REQUIRE( stats.paths.size() == 2 );
+      CHECK( stats.paths[0].path == "/device/sensor/"s );
+      CHECK( stats.paths[0].methodNotAllowed == 1 );
+      CHECK( stats.paths[1].path == "/device/sensor/id/{id}"s );
+      REQUIRE( stats.paths[1].methods.size() == 2 );
+      for ( auto&& m : stats.paths[1].methods )
+      {
+        if ( m.method == "GET"s ) CHECK( m.requests == 1 );
+        else CHECK( m.requests == 2 );
+      }
+    }
+  }
+}
@@ -0,0 +1,191 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+SCENARIO( "Match cache test suite" )
+{
+  struct Request {} request;
+  using Router = spt::http::router::HttpRouter<const Request&, std::string>;
+
+  GIVEN( "Router with a match cache" )
+  {
+    auto r = Router::Builder{}.
+        withNotFound( []( const Request&, Router::MapType&& ) { return "404"s; } ).
+        withMethodNotAllowed( []( const Request&, Router::MapType&& ) { return "405"s; } ).
+        withMatchCache( 64 ).build();
+    r.add( "GET"sv, "/device/sensor/"sv, []( const Request&, auto&& ) { return "root"s; } );
+    r.add( "GET"sv, "/device/sensor/id/{id}"sv, []( const Request&, Router::MapType&& args )
+    {
+      return "id|"s.append( args["id"] );
+    } );
+    r.add( "GET"sv, "/device/sensor/{property}/between/{start}/{end}"sv, []( const Request&, Router::MapType&& args )
+    {
+      return "between|"s.append( args["property"] ).append( "|" ).append( args["start"] ).append( "|" ).append( args["end"] );
+    } );
+    r.add( "GET"sv, "/device/file/*"sv, []( const Request&, Router::MapType&& args )
+    {
+      return "file|"s.append( args[Router::WildcardKey] );
+    } );
+
+    WHEN( "Routing the same dynamic paths repeatedly" )
+    {
+      for ( auto i = 0; i < 3; ++i )
+      {
+        auto resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+        REQUIRE( resp );
+        CHECK( *resp == "id|abc"s );
+
+        resp = r.route( "GET"sv, "/device/sensor/count/between/1/2"sv, request );
+        REQUIRE( resp );
+        CHECK( *resp == "between|count|1|2"s );
+
+        resp = r.route( "GET"sv, "/device/file/a/b/c.txt"sv, request );
+        REQUIRE( resp );
+        CHECK( *resp == "file|a/b/c.txt"s );
+      }
+
+      const auto stats = r.cacheStats();
+      CHECK( stats.misses == 3 );
+      CHECK( stats.hits == 6 );
+      CHECK( stats.size == 3 );
+      CHECK( stats.capacity >= 64 );
+    }
+
+    AND_WHEN( "Routing a cached path with a method that is not configured" )
+    {
+      auto resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "id|abc"s );
+
+      resp = r.route( "PUT"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "405"s );
+      CHECK( r.cacheStats().hits == 1 );
+    }
+
+    AND_WHEN( "Static and unmatched paths are not cached" )
+    {
+      auto resp = r.route( "GET"sv, "/device/sensor/"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "root"s );
+      resp = r.route( "GET"sv, "/device/abc/x"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "404"s );
+      resp = r.route( "GET"sv, "/device/abc/x"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "404"s );
+
+      const auto stats = r.cacheStats();
+      CHECK( stats.hits == 0 );
+      CHECK( stats.size == 0 );
+    }
+
+    AND_WHEN( "Adding a route that matches a cached path" )
+    {
+      auto resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "id|abc"s );
+
+      r.add( "GET"sv, "/device/sensor/id/abc"sv, []( const Request&, auto&& ) { return "static"s; } );
+      r.add( "GET"sv, "/device/sensor/{property}/between/{start}/now"sv, []( const Request&, auto&& ) { return "now"s; } );
+      resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "static"s );
+
+      resp = r.route( "GET"sv, "/device/sensor/count/between/1/now"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "now"s );
+    }
+
+    AND_WHEN( "Removing a route that matches a cached path" )
+    {
+      auto resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "id|abc"s );
+      resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( r.cacheStats().hits == 1 );
+
+      CHECK( r.remove( "GET"sv, "/device/sensor/id/{id}"sv ) );
+      resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "404"s );
+      CHECK( r.cacheStats().hits == 1 );
+    }
+
+    AND_WHEN( "Routing more distinct paths than the capacity" )
+    {
+      for ( auto i = 0; i < 1000; ++i )
+      {
+        const auto id = std::to_string( i );
+        auto resp = r.route( "GET"sv, "/device/sensor/id/"s.append( id ), request );
+        REQUIRE( resp );
+        CHECK( *resp == "id|"s.append( id ) );
+      }
+
+      auto stats = r.cacheStats();
+      CHECK( stats.size <= stats.capacity );
+      CHECK( stats.misses == 1000 );
+
+      auto resp = r.route( "GET"sv, "/device/sensor/id/999"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "id|999"s );
+      CHECK( r.cacheStats().hits == 1 );
+    }
+
+    AND_WHEN( "Routing from multiple threads" )
+    {
+      std::atomic<int> failures{ 0 };
+      auto threads = std::vector<std::thread>{};
+      for ( auto t = 0; t < 4; ++t )
+      {
+        threads.emplace_back( [&r, &failures, &request, t]
+        {
+          for ( auto i = 0; i < 1000; ++i )
+          {
+            const auto id = std::to_string( ( i + t ) % 50 );
+            auto resp = r.route( "GET"sv, "/device/sensor/id/"s.append( id ), request );
+            if ( !resp || *resp != "id|"s.append( id ) ) ++failures;
+          }
+        } );
+      }
+      for ( auto& thread : threads ) thread.join();
+
+      CHECK( failures == 0 );
+      const auto stats = r.cacheStats();
+      CHECK( stats.hits + stats.misses == 4000 );
+      CHECK( stats.size == 50 );
+    }
+  }
+
+  GIVEN( "Router without a match cache" )
+  {
+    Router r;
+    r.add( "GET"sv, "/device/sensor/id/{id}"sv, []( const Request&, Router::MapType&& args )
+    {
+      return "id|"s.append( args["id"] );
+    } );
+
+    WHEN( "Routing a dynamic path" )
+    {
+      auto resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "id|abc"s );
+
+      const auto stats = r.cacheStats();
+      CHECK( stats.hits == 0 );
+      CHECK( stats.misses == 0 );
+      CHECK( stats.capacity == 0 );
+    }
+  }
+}
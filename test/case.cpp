@@ -0,0 +1,182 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include "../src/router.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+  int sign( int value ) { return ( value > 0 ) - ( value < 0 ); }
+}
+
+SCENARIO( "Case-insensitive routing test suite" )
+{
+  GIVEN( "Text to compare in any case" )
+  {
+    using spt::util::fold;
+    using spt::util::compareFolded;
+    using spt::util::equalsFolded;
+
+    WHEN( "Comparing with folded text" )
+    {
+      CHECK( fold( "/Device/SENSOR/Ünïcode_09~"sv ) == "/device/sensor/Ünïcode_09~"s );
+      CHECK( equalsFolded( "/device/sensor/"sv, "/DEVICE/Sensor/"sv ) );
+      CHECK_FALSE( equalsFolded( "/device/sensor/"sv, "/DEVICE/Sensor"sv ) );
+      CHECK_FALSE( equalsFolded( "/device/[sensor]"sv, "/device/{sensor}"sv ) );
+      CHECK( compareFolded( "/device/a"sv, "/DEVICE/B"sv ) < 0 );
+      CHECK( compareFolded( "/device/{"sv, "/DEVICE/Z"sv ) > 0 );
+      CHECK( compareFolded( "/device"sv, "/DEVICE/"sv ) < 0 );
+      CHECK( compareFolded( "/device/\xc3\xa9"sv, "/DEVICE/A"sv ) > 0 );
+    }
+
+    AND_WHEN( "Comparing generated text" )
+    {
+      constexpr auto alphabet = "aAzZ@[`{/~\x80\xff"sv;
+      auto engine = std::mt19937{ 7 };
+      auto pick = std::uniform_int_distribution<std::size_t>{ 0, alphabet.size() - 1 };
+      auto length = std::uniform_int_distribution<std::size_t>{ 0, 80 };
+      const auto generate = [&]
+      {
+        auto text = std::string{};
+        for ( auto n = length( engine ); n > 0; --n ) text.push_back( alphabet[pick( engine )] );
+        return text;
+      };
+
+      for ( int i = 0; i < 2000; ++i )
+      {
+        const auto text = generate();
+        auto other = fold( text );
+        // Differ in the last byte now and then, so that mismatches after long common prefixes are checked
+        if ( i % 3 == 0 && !other.empty() ) other.back() = alphabet[pick( engine )];
+        const auto folded = fold( other );
+
+        INFO( text << " " << other );
+        CHECK( sign( compareFolded( folded, text ) ) == sign( std::string_view{ folded }.compare( fold( text ) ) ) );
+        CHECK( spt::http::router::impl::foldedHash( text ) == spt::http::router::impl::hash( fold( text ) ) );
+      }
+    }
+  }
+
+  GIVEN( "A case-insensitive router" )
+  {
+    struct Request {} request;
+    using Router = spt::http::router::HttpRouter<const Request&, std::string>;
+    using Cached = spt::http::router::HttpRouter<const Request&, std::string, Router::MapType,
+        std::function<std::string( const Request&, Router::MapType&& )>, 8>;
+    using spt::http::router::RouteInput;
+
+    auto handler = []( std::string name )
+    {
+      return [name]( const Request&, Router::MapType&& args )
+      {
+        auto out = name;
+        for ( auto&& [key, value] : args ) out.append( "|" ).append( key ).append( "=" ).append( value );
+        return out;
+      };
+    };
+
+    auto r = Router::Builder{}.withCaseInsensitivity().
+        withMethodNotAllowed( []( const Request&, Router::MapType&& ) { return "405"s; } ).build();
+    Cached c{ std::nullopt, std::nullopt, std::nullopt, 16, false, true };
+    Router plain;
+    const auto configure = [&handler]( auto& router )
+    {
+      router.add( "GET"sv, "/Device/Sensor/"sv, handler( "root" ) );
+      router.add( "GET"sv, "/device/sensor/id/{sensorId}"sv, handler( "id" ) );
+      router.add( "GET"sv, "/device/sensor/code/{code:[A-Z]{3}}"sv, handler( "code" ) );
+      router.add( "GET"sv, "/device/sensor/created/between/{start}/{end}"sv, handler( "between" ) );
+      router.add( "GET"sv, "/device/sensor/customer/code/{code}/history/summary"sv, handler( "summary" ) );
+      router.add( "GET"sv, "/device/file/*"sv, handler( "file" ) );
+    };
+    configure( r );
+    configure( c );
+    configure( plain );
+
+    const auto requests = std::vector<std::pair<std::string_view, std::string_view>>{
+        { "/device/sensor/"sv, "root"sv },
+        { "/DEVICE/SENSOR/"sv, "root"sv },
+        { "/dEvIcE/sEnSoR/Id/6230F3069E7C9BE9ff4b78a1"sv, "id|sensorId=6230F3069E7C9BE9ff4b78a1"sv },
+        { "/Device/Sensor/Code/ABC"sv, "code|code=ABC"sv },
+        { "/Device/Sensor/Created/Between/2022-03-14T20:11:50.620Z/Now"sv, "between|end=Now|start=2022-03-14T20:11:50.620Z"sv },
+        { "/DEVICE/SENSOR/CUSTOMER/CODE/XyZ/HISTORY/SUMMARY"sv, "summary|code=XyZ"sv },
+        { "/Device/File/Reports/2022/Summary.PDF"sv, "file|_wildcard_=Reports/2022/Summary.PDF"sv },
+    };
+
+    WHEN( "Routing paths in any case" )
+    {
+      for ( const auto& [path, expected] : requests )
+      {
+        INFO( path );
+        CHECK( r.route( "GET"sv, path, request ) == std::string{ expected } );
+        CHECK( c.route( "GET"sv, path, request ) == std::string{ expected } );
+        CHECK( c.route( "GET"sv, path, request ) == std::string{ expected } );
+        CHECK( r.canRoute( "GET"sv, path ) == std::tuple{ true, true } );
+      }
+
+      CHECK( r.route( "POST"sv, "/DEVICE/SENSOR/"sv, request ) == "405"s );
+      CHECK( r.canRoute( "POST"sv, "/DEVICE/SENSOR/ID/1"sv ) == std::tuple{ true, false } );
+      CHECK( r.routeTarget( "GET"sv, "/Device/Sensor/ID/42?Fields=A"sv, request ) == "id|sensorId=42"s );
+    }
+
+    AND_WHEN( "Routing parameters with constraints in any case" )
+    {
+      // Constraints see the parameter value as sent
+      CHECK_FALSE( r.route( "GET"sv, "/device/sensor/code/abc"sv, request ) );
+      CHECK_FALSE( r.route( "GET"sv, "/device/sensor/code/ABCD"sv, request ) );
+      CHECK_FALSE( r.route( "GET"sv, "/device/sensors/"sv, request ) );
+      CHECK_FALSE( r.route( "GET"sv, "/device/sensor/id"sv, request ) );
+    }
+
+    AND_WHEN( "Routing paths with segments too long to fold on the stack" )
+    {
+      const auto segment = std::string( 80, 'S' ) + "egment";
+      r.add( "GET"sv, "/device/" + segment + "/{id}", handler( "long" ) );
+      r.add( "GET"sv, "/device/" + segment + "s/{id}", handler( "longer" ) );
+      CHECK( r.route( "GET"sv, "/DEVICE/" + segment + "/Id", request ) == "long|id=Id"s );
+      CHECK( r.route( "GET"sv, "/device/" + spt::util::fold( segment ) + "S/Id", request ) == "longer|id=Id"s );
+      CHECK_FALSE( r.route( "GET"sv, "/device/" + segment + "z/Id", request ) );
+    }
+
+    AND_WHEN( "Routing a batch of paths in any case" )
+    {
+      auto inputs = std::vector<RouteInput>{};
+      for ( const auto& [path, _] : requests ) inputs.push_back( { "GET"sv, path } );
+      auto responses = std::vector<std::optional<std::string>>( inputs.size() );
+      REQUIRE( r.routeBatch( inputs, responses, request ) == inputs.size() );
+      for ( std::size_t i = 0; i < inputs.size(); ++i ) CHECK( responses[i] == std::string{ requests[i].second } );
+    }
+
+    AND_WHEN( "Configuring and removing paths in another case" )
+    {
+      CHECK_THROWS_AS( r.add( "GET"sv, "/DEVICE/SENSOR/"sv, handler( "again" ) ), spt::http::router::DuplicateRouteError );
+      CHECK_THROWS_AS( r.add( "GET"sv, "/DEVICE/SENSOR/ID/{SensorId}"sv, handler( "again" ) ), spt::http::router::DuplicateRouteError );
+
+      auto routes = std::vector<Router::RouteSpec>{};
+      routes.push_back( { "PUT"sv, "/Device/Sensor/Id/{sensorId}"sv, handler( "put" ) } );
+      routes.push_back( { "GET"sv, "/Device/Firmware/"sv, handler( "firmware" ) } );
+      r.addAll( routes );
+      CHECK( r.route( "PUT"sv, "/DEVICE/SENSOR/ID/AbC"sv, request ) == "put|sensorId=AbC"s );
+      CHECK( r.route( "GET"sv, "/device/firmware/"sv, request ) == "firmware"s );
+
+      CHECK( r.remove( "GET"sv, "/DEVICE/sensor/ID/{sensorId}"sv ) );
+      CHECK( r.route( "GET"sv, "/device/sensor/id/42"sv, request ) == "405"s );
+      CHECK( r.remove( "PUT"sv, "/device/sensor/id/{sensorId}"sv ) );
+      CHECK_FALSE( std::get<0>( r.canRoute( "GET"sv, "/device/sensor/id/42"sv ) ) );
+    }
+
+    AND_WHEN( "Routing with a case-sensitive router" )
+    {
+      CHECK( plain.route( "GET"sv, "/Device/Sensor/"sv, request ) == "root"s );
+      CHECK_FALSE( plain.route( "GET"sv, "/device/sensor/"sv, request ) );
+      CHECK_FALSE( plain.route( "GET"sv, "/Device/Sensor/Id/42"sv, request ) );
+      CHECK( plain.route( "GET"sv, "/device/sensor/id/42"sv, request ) == "id|sensorId=42"s );
+    }
+  }
+}
@@ -0,0 +1,191 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+SCENARIO( "Compiled router test suite" )
+{
+  struct Request {} request;
+  using Router = spt::http::router::HttpRouter<const Request&, std::string>;
+
+  auto handler = []( std::string name )
+  {
+    return [name]( const Request&, Router::MapType&& args )
+    {
+      auto out = name;
+      for ( auto&& [key, value] : args ) out.append( "|" ).append( key ).append( "=" ).append( value );
+      return out;
+    };
+  };
+
+  GIVEN( "Router configured with static, parametrised and wildcard paths" )
+  {
+    Router r{ []( const Request&, Router::MapType&& ) { return "404"s; },
+        []( const Request&, Router::MapType&& ) { return "405"s; },
+        []( const Request&, Router::MapType&& ) { return "500"s; } };
+    r.add( "GET"sv, "/device/sensor/"sv, handler( "list" ) );
+    r.add( "POST"sv, "/device/sensor/"sv, handler( "create" ) );
+    r.add( "GET"sv, "/device/sensor/id/{id}"sv, handler( "retrieve" ) );
+    r.add( "PUT"sv, "/device/sensor/id/{id}"sv, handler( "update" ) );
+    r.add( "PURGE"sv, "/device/sensor/id/{id}"sv, handler( "purge" ) );
+    r.add( "GET"sv, "/device/sensor/identifier/{identifier}"sv, handler( "identifier" ) );
+    r.add( "GET"sv, "/device/sensor/{property}/between/{start}/{end}"sv, handler( "between" ) );
+    r.add( "GET"sv, "/device/sensor/id/{id}/*"sv, handler( "subresource" ) );
+    r.add( "GET"sv, "/device/sensor/*"sv, handler( "sensor" ) );
+    r.add( "GET"sv, "/device/{type}/id/{id}"sv, handler( "typed" ) );
+    r.add( "GET"sv, "/device/file/*"sv, handler( "file" ) );
+    r.add( "GET"sv, "/device/error"sv, []( const Request&, Router::MapType&& ) -> std::string
+    {
+      throw std::runtime_error( "error" );
+    } );
+    r.add( "PROPFIND"sv, "/dav/{collection}/*"sv, handler( "dav" ) );
+    r.add( "GET"sv, "/zzz/static"sv, handler( "last" ) );
+
+    const auto compiled = r.compile();
+    CHECK( compiled.bytes() > 0 );
+
+    const auto requests = std::vector<std::pair<std::string_view, std::string_view>>{
+        { "GET"sv, "/device/sensor/"sv },
+        { "POST"sv, "/device/sensor/"sv },
+        { "DELETE"sv, "/device/sensor/"sv },
+        { "GET"sv, "/device/sensor"sv },
+        { "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv },
+        { "PUT"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv },
+        { "PURGE"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv },
+        { "PATCH"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv },
+        { "MKCOL"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv },
+        { "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1/history/json"sv },
+        { "GET"sv, "/device/sensor/identifier/sensor one"sv },
+        { "GET"sv, "/device/sensor/created/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z"sv },
+        { "GET"sv, "/device/sensor/created/between/2022-03-14T20:11:50.620Z"sv },
+        { "GET"sv, "/device/sensor/other/path"sv },
+        { "GET"sv, "/device/camera/id/6230f3069e7c9be9ff4b78a1"sv },
+        { "GET"sv, "/device/file/path/to/file.txt"sv },
+        { "GET"sv, "/device/file/"sv },
+        { "GET"sv, "/device/error"sv },
+        { "PROPFIND"sv, "/dav/calendar/2022/03/event.ics"sv },
+        { "GET"sv, "/dav/calendar/2022/03/event.ics"sv },
+        { "GET"sv, "/other/path"sv },
+        { "GET"sv, "/zzz/static"sv },
+        { "GET"sv, "/zzzz"sv },
+        { "GET"sv, "/"sv },
+    };
+
+    WHEN( "Routing requests with the compiled router" )
+    {
+      for ( const auto& [method, path] : requests )
+      {
+        INFO( method << " " << path );
+        CHECK( compiled.route( method, path, request ) == r.route( method, path, request ) );
+        CHECK( compiled.route( method, path, request, true ) == r.route( method, path, request, true ) );
+        CHECK( compiled.canRoute( method, path ) == r.canRoute( method, path ) );
+      }
+    }
+
+    AND_WHEN( "Checking the parameters extracted" )
+    {
+      auto resp = compiled.route( "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1/history/json"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "subresource|_wildcard_=history/json|id=6230f3069e7c9be9ff4b78a1"s );
+
+      resp = compiled.route( "PUT"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "update|id=abc"s );
+
+      resp = compiled.route( "GET"sv, "/device/error"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "500"s );
+    }
+
+    AND_WHEN( "Modifying the router after compiling" )
+    {
+      r.add( "GET"sv, "/device/new"sv, handler( "new" ) );
+      CHECK( r.remove( "GET"sv, "/device/sensor/"sv ) );
+
+      auto resp = compiled.route( "GET"sv, "/device/sensor/"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "list"s );
+
+      auto [p, m] = compiled.canRoute( "GET"sv, "/device/new"sv );
+      CHECK_FALSE( p );
+      CHECK_FALSE( m );
+    }
+  }
+
+  GIVEN( "Router with a large number of routes" )
+  {
+    Router r{ []( const Request&, Router::MapType&& ) { return "404"s; } };
+    for ( auto i = 0; i < 1000; ++i )
+    {
+      const auto entity = "/entity"s + std::to_string( i );
+      r.add( "GET"sv, entity + "/", handler( entity ) );
+      r.add( "GET"sv, entity + "/id/{id}", handler( entity + "-id" ) );
+      r.add( "GET"sv, entity + "/{property}/between/{start}/{end}", handler( entity + "-between" ) );
+    }
+    const auto compiled = r.compile();
+
+    WHEN( "Routing requests with the compiled router" )
+    {
+      for ( auto i = 0; i < 1000; i += 7 )
+      {
+        const auto entity = "/entity"s + std::to_string( i );
+        for ( const auto& path : { entity + "/", entity + "/id/abc", entity + "/created/between/a/b", entity + "/none" } )
+        {
+          INFO( path );
+          CHECK( compiled.route( "GET"sv, path, request ) == r.route( "GET"sv, path, request ) );
+        }
+      }
+    }
+  }
+
+  GIVEN( "Router with paths that end at the same trie node" )
+  {
+    Router r{ []( const Request&, Router::MapType&& ) { return "404"s; },
+        []( const Request&, Router::MapType&& ) { return "405"s; } };
+    r.add( "GET"sv, "/a/{id}"sv, handler( "id" ) );
+    r.add( "POST"sv, "/a/{id}/"sv, handler( "slash" ) );
+    r.add( "GET"sv, "/b/*"sv, handler( "wildcard" ) );
+    const auto compiled = r.compile();
+
+    WHEN( "Routing requests that only match the later route" )
+    {
+      const auto requests = std::vector<std::pair<std::string_view, std::string_view>>{
+          { "POST"sv, "/a/{id}!"sv },
+          { "GET"sv, "/a/{id}!"sv },
+          { "POST"sv, "/a/{id}/"sv },
+          { "POST"sv, "/a/x"sv },
+          { "GET"sv, "/a/x"sv },
+          { "POST"sv, "/b/~!"sv },
+          { "GET"sv, "/b/x/y"sv },
+      };
+
+      for ( const auto& [method, path] : requests )
+      {
+        INFO( method << " " << path );
+        CHECK( compiled.route( method, path, request ) == r.route( method, path, request ) );
+        CHECK( compiled.canRoute( method, path ) == r.canRoute( method, path ) );
+      }
+
+      CHECK( compiled.route( "POST"sv, "/a/{id}!"sv, request ) == "slash|id={id}!"s );
+    }
+  }
+
+  GIVEN( "Router without any routes" )
+  {
+    Router r;
+    const auto compiled = r.compile();
+
+    WHEN( "Routing a request" )
+    {
+      CHECK_FALSE( compiled.route( "GET"sv, "/device/sensor/"sv, request ) );
+      auto [p, m] = compiled.canRoute( "GET"sv, "/device/sensor/"sv );
+      CHECK_FALSE( p );
+      CHECK_FALSE( m );
+    }
+  }
+}
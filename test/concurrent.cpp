@@ -0,0 +1,158 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+SCENARIO( "Concurrent add and remove test suite" )
+{
+  struct Request {} request;
+  using Router = spt::http::router::HttpRouter<const Request&, int>;
+
+  GIVEN( "Router with static, parametrised and wildcard paths" )
+  {
+    Router r{ []( const Request&, Router::MapType&& ) { return 404; },
+        []( const Request&, Router::MapType&& ) { return 405; } };
+    r.add( "GET"sv, "/device/sensor/"sv, []( const Request&, auto&& ) { return 1; } );
+    r.add( "POST"sv, "/device/sensor/"sv, []( const Request&, auto&& ) { return 2; } );
+    r.add( "GET"sv, "/device/sensor/id/{id}"sv, []( const Request&, auto&& ) { return 3; } );
+    r.add( "PURGE"sv, "/device/sensor/id/{id}"sv, []( const Request&, auto&& ) { return 4; } );
+    r.add( "GET"sv, "/device/sensor/{property}/between/{start}/{end}"sv, []( const Request&, auto&& ) { return 5; } );
+    r.add( "GET"sv, "/device/file/*"sv, []( const Request&, auto&& ) { return 6; } );
+
+    WHEN( "Removing one of the methods configured for a path" )
+    {
+      CHECK( r.remove( "POST"sv, "/device/sensor/"sv ) );
+      CHECK_FALSE( r.remove( "POST"sv, "/device/sensor/"sv ) );
+
+      auto resp = r.route( "POST"sv, "/device/sensor/"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 405 );
+      resp = r.route( "GET"sv, "/device/sensor/"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 1 );
+
+      CHECK( r.remove( "PURGE"sv, "/device/sensor/id/{id}"sv ) );
+      resp = r.route( "PURGE"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 405 );
+      auto [p, m] = r.canRoute( "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv );
+      CHECK( p );
+      CHECK( m );
+    }
+
+    AND_WHEN( "Removing all the methods configured for a path" )
+    {
+      CHECK( r.remove( "GET"sv, "/device/sensor/id/{id}"sv ) );
+      CHECK( r.remove( "PURGE"sv, "/device/sensor/id/{id}"sv ) );
+      auto resp = r.route( "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 404 );
+
+      CHECK( r.remove( "GET"sv, "/device/sensor/"sv ) );
+      CHECK( r.remove( "POST"sv, "/device/sensor/"sv ) );
+      auto [p, m] = r.canRoute( "GET"sv, "/device/sensor/"sv );
+      CHECK_FALSE( p );
+      CHECK_FALSE( m );
+
+      CHECK( r.remove( "GET"sv, "/device/file/*"sv ) );
+      resp = r.route( "GET"sv, "/device/file/path/to/file.txt"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 404 );
+
+      resp = r.route( "GET"sv, "/device/sensor/created/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 5 );
+    }
+
+    AND_WHEN( "Removing paths that are not configured" )
+    {
+      CHECK_FALSE( r.remove( "GET"sv, "/device/other/"sv ) );
+      CHECK_FALSE( r.remove( "PUT"sv, "/device/sensor/"sv ) );
+      CHECK_FALSE( r.remove( "MKCOL"sv, "/device/sensor/"sv ) );
+      CHECK_FALSE( r.remove( "GET"sv, "/device/sensor/id/{key}"sv ) );
+    }
+
+    AND_WHEN( "Adding a removed path again" )
+    {
+      CHECK( r.remove( "GET"sv, "/device/sensor/id/{id}"sv ) );
+      CHECK( r.remove( "PURGE"sv, "/device/sensor/id/{id}"sv ) );
+      r.add( "GET"sv, "/device/sensor/id/{key}"sv, []( const Request&, auto&& args )
+      {
+        REQUIRE( args.contains( "key"sv ) );
+        return 7;
+      } );
+
+      auto resp = r.route( "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 7 );
+    }
+  }
+
+  GIVEN( "Router being modified while routing requests" )
+  {
+    Router r{ []( const Request&, Router::MapType&& ) { return 404; } };
+    r.add( "GET"sv, "/stable/static"sv, []( const Request&, auto&& ) { return 1; } );
+    r.add( "GET"sv, "/stable/id/{id}"sv, []( const Request&, auto&& ) { return 2; } );
+    r.add( "GET"sv, "/stable/file/*"sv, []( const Request&, auto&& ) { return 3; } );
+    // Sorts after the volatile paths, so misses are routed to the not found handler
+    r.add( "GET"sv, "/zzz/static"sv, []( const Request&, auto&& ) { return 9; } );
+
+    WHEN( "Adding and removing routes from one thread and routing from others" )
+    {
+      std::atomic_bool done{ false };
+      std::atomic_int failures{ 0 };
+
+      auto readers = std::vector<std::thread>{};
+      for ( auto i = 0; i < 2; ++i )
+      {
+        readers.emplace_back( [&r, &done, &failures, &request]
+        {
+          while ( !done.load() )
+          {
+            auto resp = r.route( "GET"sv, "/stable/static"sv, request );
+            if ( !resp || *resp != 1 ) ++failures;
+            resp = r.route( "GET"sv, "/stable/id/abc"sv, request );
+            if ( !resp || *resp != 2 ) ++failures;
+            resp = r.route( "GET"sv, "/stable/file/path/to/file"sv, request );
+            if ( !resp || *resp != 3 ) ++failures;
+
+            resp = r.route( "GET"sv, "/volatile/static5"sv, request );
+            if ( !resp || ( *resp != 5 && *resp != 404 ) ) ++failures;
+            resp = r.route( "GET"sv, "/volatile/id/7/abc"sv, request );
+            if ( !resp || ( *resp != 7 && *resp != 404 ) ) ++failures;
+          }
+        } );
+      }
+
+      for ( auto round = 0; round < 10; ++round )
+      {
+        for ( auto i = 0; i < 10; ++i )
+        {
+          r.add( "GET"sv, "/volatile/static"s + std::to_string( i ), [i]( const Request&, auto&& ) { return i; } );
+          r.add( "GET"sv, "/volatile/id/"s + std::to_string( i ) + "/{id}", [i]( const Request&, auto&& ) { return i; } );
+        }
+        for ( auto i = 0; i < 10; ++i )
+        {
+          CHECK( r.remove( "GET"sv, "/volatile/static"s + std::to_string( i ) ) );
+          CHECK( r.remove( "GET"sv, "/volatile/id/"s + std::to_string( i ) + "/{id}" ) );
+        }
+      }
+
+      done.store( true );
+      for ( auto&& t : readers ) t.join();
+      CHECK( failures.load() == 0 );
+
+      auto resp = r.route( "GET"sv, "/volatile/static5"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 404 );
+    }
+  }
+}
@@ -0,0 +1,180 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include "../src/router.hpp"
+#include "../src/static.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+  using spt::http::router::Literal;
+  using spt::http::router::Route;
+
+  struct Request {};
+  using Map = spt::http::router::HttpRouter<const Request&, std::string>::MapType;
+
+  template <Literal Name>
+  std::string named( const Request&, Map&& args )
+  {
+    auto out = std::string{ Name.view() };
+    for ( auto&& [key, value] : args ) out.append( "|" ).append( key ).append( "=" ).append( value );
+    return out;
+  }
+
+  std::string notFound( const Request&, Map&& ) { return "404"s; }
+  std::string methodNotAllowed( const Request&, Map&& ) { return "405"s; }
+
+  using StaticRouter = spt::http::router::StaticRouter<const Request&, std::string, Map,
+      Route<"GET", "/user/{id:int}", &named<"int">>,
+      Route<"GET", "/user/{id:hex24}", &named<"hex24">>,
+      Route<"GET", "/user/{id:uuid}", &named<"uuid">>,
+      Route<"GET", "/user/{id}", &named<"name">>,
+      Route<"GET", "/user/{id:int}/history", &named<"history">>,
+      Route<"DELETE", "/order/{id:int}", &named<"order">>>;
+
+  namespace impl = spt::http::router::impl;
+  static_assert( impl::validParameters( "/user/{id:uuid}" ) );
+  static_assert( !impl::validParameters( "/user/{id:float}" ) );
+  static_assert( !impl::equivalent( "/user/{id:int}", "/user/{id}" ) );
+  static_assert( impl::equivalent( "/user/{id:int}", "/user/{key:int}" ) );
+  static_assert( impl::parameter( "{id:int}" ) == "id"sv );
+  static_assert( impl::parameter( "{id}" ) == "id"sv );
+}
+
+SCENARIO( "Parameter constraint test suite" )
+{
+  Request request;
+  using spt::http::router::Constraint;
+
+  GIVEN( "Values to validate against each constraint" )
+  {
+    WHEN( "Validating integers" )
+    {
+      for ( const auto v : { "0"sv, "42"sv, "-42"sv, "9223372036854775807"sv, "-9223372036854775808"sv, "007"sv } )
+      {
+        INFO( v );
+        CHECK( impl::valid( Constraint::Int, v ) );
+      }
+      for ( const auto v : { ""sv, "-"sv, "4a"sv, "+4"sv, " 4"sv, "9223372036854775808"sv, "-9223372036854775809"sv,
+          "12345678901234567890"sv, "1.5"sv } )
+      {
+        INFO( v );
+        CHECK_FALSE( impl::valid( Constraint::Int, v ) );
+      }
+    }
+
+    AND_WHEN( "Validating object ids" )
+    {
+      CHECK( impl::valid( Constraint::Hex24, "6230f3069e7c9be9ff4b78a1"sv ) );
+      CHECK( impl::valid( Constraint::Hex24, "6230F3069E7C9BE9FF4B78A1"sv ) );
+      CHECK_FALSE( impl::valid( Constraint::Hex24, "6230f3069e7c9be9ff4b78a"sv ) );
+      CHECK_FALSE( impl::valid( Constraint::Hex24, "6230f3069e7c9be9ff4b78a12"sv ) );
+      CHECK_FALSE( impl::valid( Constraint::Hex24, "6230f3069e7c9be9ff4b78ag"sv ) );
+      CHECK_FALSE( impl::valid( Constraint::Hex24, "g230f3069e7c9be9ff4b78a1"sv ) );
+      CHECK_FALSE( impl::valid( Constraint::Hex24, "6230f3069e7c9be9\xff" "f4b78a1"sv ) );
+    }
+
+    AND_WHEN( "Validating UUIDs" )
+    {
+      CHECK( impl::valid( Constraint::Uuid, "123e4567-e89b-12d3-a456-426614174000"sv ) );
+      CHECK( impl::valid( Constraint::Uuid, "123E4567-E89B-12D3-A456-426614174000"sv ) );
+      CHECK_FALSE( impl::valid( Constraint::Uuid, "123e4567e89b12d3a456426614174000"sv ) );
+      CHECK_FALSE( impl::valid( Constraint::Uuid, "123e4567-e89b-12d3-a456_426614174000"sv ) );
+      CHECK_FALSE( impl::valid( Constraint::Uuid, "123e4567-e89b-12d3-a4567426614174000"sv ) );
+      CHECK_FALSE( impl::valid( Constraint::Uuid, "123e4567-e89b-12d3-a456-42661417400z"sv ) );
+      CHECK_FALSE( impl::valid( Constraint::Uuid, "{23e4567-e89b-12d3-a456-426614174000"sv ) );
+    }
+
+    AND_WHEN( "Converting validated values" )
+    {
+      using spt::http::router::typed;
+      CHECK( typed<std::int64_t>( "42"sv ) == 42 );
+      CHECK( typed<std::int64_t>( "-42"sv ) == -42 );
+      CHECK( typed<std::int64_t>( "9223372036854775807"sv ) == std::numeric_limits<std::int64_t>::max() );
+      CHECK( typed<std::int64_t>( "-9223372036854775808"sv ) == std::numeric_limits<std::int64_t>::min() );
+
+      const auto oid = typed<spt::http::router::ObjectId>( "6230f3069e7c9be9ff4B78A1"sv );
+      CHECK( oid.bytes == std::array<std::uint8_t, 12>{ 0x62, 0x30, 0xf3, 0x06, 0x9e, 0x7c, 0x9b, 0xe9, 0xff, 0x4b, 0x78, 0xa1 } );
+
+      const auto uuid = typed<spt::http::router::Uuid>( "123e4567-e89b-12d3-a456-426614174000"sv );
+      CHECK( uuid.bytes == std::array<std::uint8_t, 16>{ 0x12, 0x3e, 0x45, 0x67, 0xe8, 0x9b, 0x12, 0xd3,
+          0xa4, 0x56, 0x42, 0x66, 0x14, 0x17, 0x40, 0x00 } );
+    }
+  }
+
+  GIVEN( "Routers with routes that differ only in the parameter type" )
+  {
+    using Router = spt::http::router::HttpRouter<const Request&, std::string>;
+    using Cached = spt::http::router::HttpRouter<const Request&, std::string, Map, std::function<std::string( const Request&, Map&& )>, 8>;
+    Router r{ &notFound, &methodNotAllowed };
+    Cached c{ &notFound, &methodNotAllowed, std::nullopt, 16 };
+    const auto configure = []( auto& router )
+    {
+      router.add( "GET"sv, "/user/{id:int}"sv, &named<"int"> );
+      router.add( "GET"sv, "/user/{id:hex24}"sv, &named<"hex24"> );
+      router.add( "GET"sv, "/user/{id:uuid}"sv, &named<"uuid"> );
+      router.add( "GET"sv, "/user/{id}"sv, &named<"name"> );
+      router.add( "GET"sv, "/user/{id:int}/history"sv, &named<"history"> );
+      router.add( "DELETE"sv, "/order/{id:int}"sv, &named<"order"> );
+    };
+    configure( r );
+    configure( c );
+
+    const auto compiled = r.compile();
+    const auto fixed = StaticRouter{ &notFound, &methodNotAllowed };
+
+    const auto requests = std::vector<std::tuple<std::string_view, std::string_view, std::string_view>>{
+        { "GET"sv, "/user/42"sv, "int|id=42"sv },
+        { "GET"sv, "/user/-42"sv, "int|id=-42"sv },
+        { "GET"sv, "/user/6230f3069e7c9be9ff4b78a1"sv, "hex24|id=6230f3069e7c9be9ff4b78a1"sv },
+        { "GET"sv, "/user/123e4567-e89b-12d3-a456-426614174000"sv, "uuid|id=123e4567-e89b-12d3-a456-426614174000"sv },
+        { "GET"sv, "/user/john"sv, "name|id=john"sv },
+        { "GET"sv, "/user/99999999999999999999"sv, "name|id=99999999999999999999"sv },
+        { "GET"sv, "/user/42/history"sv, "history|id=42"sv },
+        { "GET"sv, "/user/john/history"sv, "404"sv },
+        { "DELETE"sv, "/order/42"sv, "order|id=42"sv },
+        { "DELETE"sv, "/order/abc"sv, "404"sv },
+        { "GET"sv, "/order/42"sv, "405"sv },
+    };
+
+    WHEN( "Routing requests" )
+    {
+      for ( const auto& [method, path, expected] : requests )
+      {
+        INFO( method << " " << path );
+        auto resp = r.route( method, path, request );
+        REQUIRE( resp );
+        CHECK( *resp == expected );
+
+        // Twice, the second time from the cache and memo
+        CHECK( c.route( method, path, request ) == resp );
+        CHECK( c.route( method, path, request ) == resp );
+        CHECK( compiled.route( method, path, request ) == resp );
+        CHECK( fixed.route( method, path, request ) == resp );
+
+        CHECK( compiled.canRoute( method, path ) == r.canRoute( method, path ) );
+        CHECK( fixed.canRoute( method, path ) == r.canRoute( method, path ) );
+      }
+
+      auto [p, m] = r.canRoute( "DELETE"sv, "/order/abc"sv );
+      CHECK_FALSE( p );
+      CHECK_FALSE( m );
+    }
+
+    AND_WHEN( "Configuring a clashing or invalid route" )
+    {
+      CHECK_THROWS_AS( r.add( "GET"sv, "/user/{key:int}"sv, &named<"clash"> ), spt::http::router::DuplicateRouteError );
+      CHECK_THROWS_AS( r.add( "GET"sv, "/user/{id:float}"sv, &named<"float"> ), spt::http::router::InvalidParameterError );
+      CHECK_NOTHROW( r.add( "POST"sv, "/user/{key:int}"sv, &named<"post"> ) );
+
+      auto routes = std::vector<Router::RouteSpec>{};
+      routes.push_back( { "PUT"sv, "/order/{id:int}"sv, &named<"put">, {} } );
+      routes.push_back( { "PUT"sv, "/order/{key:int}"sv, &named<"put">, {} } );
+      CHECK_THROWS_AS( r.addAll( routes ), spt::http::router::DuplicateRouteError );
+    }
+  }
+}
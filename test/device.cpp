@@ -272,6 +272,70 @@ SCENARIO( "Sensor Device routes" )
       CHECK( m );
     }
   }
+
+  GIVEN( "Router configured for Sensor device API endpoints with inline parameters" )
+  {
+    const auto method = "GET"s;
+    struct Request {} request;
+    using Params = spt::http::router::InlineParams<3>;
+    spt::http::router::HttpRouter<const Request &, bool, Params> r;
+    r.add( method, "/device/sensor/", []( const Request&, auto args )
+    {
+      REQUIRE( args.size() == 0 );
+      return true;
+    } );
+    r.add( method, "/device/sensor/id/{id}", []( const Request&, auto args )
+    {
+      REQUIRE( args.size() == 1 );
+      REQUIRE( args["id"sv] == "6230f3069e7c9be9ff4b78a1"sv );
+      return true;
+    } );
+    r.add( method, "/device/sensor/identifier/{identifier}", []( const Request&, auto args )
+    {
+      REQUIRE( args.size() == 1 );
+      REQUIRE( args["identifier"sv] == "Integration Test Identifier"sv );
+      return true;
+    } );
+    r.add( method, "/device/sensor/customer/code/{code}", []( const Request&, auto args )
+    {
+      REQUIRE( args.size() == 1 );
+      REQUIRE( args["code"sv] == "int-test"sv );
+      return true;
+    } );
+    r.add( method, "/device/sensor/history/summary/{id}", []( const Request&, auto args )
+    {
+      REQUIRE( args.size() == 1 );
+      REQUIRE( args.contains( "id"sv ) );
+      return true;
+    } );
+    r.add( method, "/device/sensor/{property}/between/{start}/{end}", []( const Request&, auto args )
+    {
+      REQUIRE( args.size() == 3 );
+      REQUIRE( args["property"sv] == "created"sv );
+      REQUIRE( args["start"sv] == "2022-03-14T20:11:50.620Z"sv );
+      REQUIRE( args["end"sv] == "2022-03-16T20:11:50.620Z"sv );
+      return true;
+    } );
+
+    WHEN( "Testing configured paths" )
+    {
+      for ( auto&& url : {
+          "/device/sensor/"s,
+          "/device/sensor/id/6230f3069e7c9be9ff4b78a1"s,
+          "/device/sensor/identifier/Integration Test Identifier"s,
+          "/device/sensor/customer/code/int-test"s,
+          "/device/sensor/history/summary/6230f3069e7c9be9ff4b78a1"s,
+          "/device/sensor/created/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z"s } )
+      {
+        auto resp = r.route( method, url, request );
+        REQUIRE( resp );
+        REQUIRE( *resp );
+        auto [p, m] = r.canRoute( method, url );
+        CHECK( p );
+        CHECK( m );
+      }
+    }
+  }
 }
 
 #ifdef HAS_BOOST
@@ -0,0 +1,110 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+SCENARIO( "Static path index test suite" )
+{
+  struct Request {} request;
+
+  GIVEN( "An index with a large number of paths" )
+  {
+    spt::http::router::impl::StaticIndex index;
+    for ( std::size_t i = 0; i < 1000; ++i ) index.insert( "/entity/"s + std::to_string( i ), i );
+
+    WHEN( "Looking up configured paths" )
+    {
+      for ( std::size_t i = 0; i < 1000; ++i )
+      {
+        CHECK( index.find( "/entity/"s + std::to_string( i ) ) == i );
+      }
+    }
+
+    AND_WHEN( "Looking up paths that are not configured" )
+    {
+      CHECK( index.find( "/entity/1000"sv ) == spt::http::router::impl::StaticIndex::npos );
+      CHECK( index.find( "/entity/"sv ) == spt::http::router::impl::StaticIndex::npos );
+      CHECK( index.find( ""sv ) == spt::http::router::impl::StaticIndex::npos );
+    }
+
+    AND_WHEN( "Shifting route indices" )
+    {
+      index.shift( 500 );
+      CHECK( index.find( "/entity/499"sv ) == 499 );
+      CHECK( index.find( "/entity/500"sv ) == 501 );
+      CHECK( index.find( "/entity/999"sv ) == 1000 );
+    }
+
+    AND_WHEN( "Erasing paths" )
+    {
+      for ( std::size_t i = 0; i < 1000; i += 2 ) index.erase( "/entity/"s + std::to_string( 998 - i ), 998 - i );
+      for ( std::size_t i = 0; i < 1000; ++i )
+      {
+        const auto found = index.find( "/entity/"s + std::to_string( i ) );
+        if ( i % 2 == 0 ) CHECK( found == spt::http::router::impl::StaticIndex::npos );
+        else CHECK( found == i / 2 );
+      }
+    }
+  }
+
+  GIVEN( "Router with static and dynamic paths" )
+  {
+    using Router = spt::http::router::HttpRouter<const Request&, int>;
+    Router r{ []( const Request&, Router::MapType&& ) { return 404; },
+        []( const Request&, Router::MapType&& ) { return 405; } };
+
+    for ( auto i = 0; i < 100; ++i )
+    {
+      r.add( "GET"sv, "/service/static"s + std::to_string( i ), [i]( const Request&, auto&& args )
+      {
+        REQUIRE( args.empty() );
+        return i;
+      } );
+    }
+    r.add( "GET"sv, "/service/{name}"sv, []( const Request&, auto&& args )
+    {
+      REQUIRE( args.size() == 1 );
+      return -1;
+    } );
+    r.add( "POST"sv, "/service/entity/"sv, []( const Request&, auto&& ) { return 1000; } );
+
+    WHEN( "Routing static paths" )
+    {
+      for ( auto i = 0; i < 100; ++i )
+      {
+        auto resp = r.route( "GET"sv, "/service/static"s + std::to_string( i ), request );
+        REQUIRE( resp );
+        CHECK( *resp == i );
+      }
+    }
+
+    AND_WHEN( "Routing a static path with an unconfigured method" )
+    {
+      auto resp = r.route( "PUT"sv, "/service/static1"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 405 );
+      auto [p, m] = r.canRoute( "PUT"sv, "/service/static1"sv );
+      CHECK( p );
+      CHECK_FALSE( m );
+    }
+
+    AND_WHEN( "Routing a path that falls back to the parameter route" )
+    {
+      auto resp = r.route( "GET"sv, "/service/static100"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == -1 );
+    }
+
+    AND_WHEN( "Routing a static path without the trailing slash" )
+    {
+      auto resp = r.route( "POST"sv, "/service/entity"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 1000 );
+    }
+  }
+}
@@ -0,0 +1,221 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include <memory>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+  struct Request
+  {
+    int routed{ 0 };
+  };
+
+  using Params = spt::http::router::InlineParams<4>;
+
+  std::string_view sensors( Request& request, Params&& )
+  {
+    ++request.routed;
+    return "sensors"sv;
+  }
+
+  std::string_view sensor( Request& request, Params&& params )
+  {
+    ++request.routed;
+    return params["id"sv];
+  }
+
+  int twice( int value ) { return 2 * value; }
+}
+
+SCENARIO( "Handler function test suite" )
+{
+  GIVEN( "Inline functions" )
+  {
+    using Function = spt::http::router::InlineFunction<int( int )>;
+
+    WHEN( "Storing callables of different kinds" )
+    {
+      auto offset = 3;
+      auto counter = std::make_shared<int>( 0 );
+      Function empty;
+      Function pointer{ &twice };
+      Function reference{ [&offset]( int v ) { return v + offset; } };
+      Function owning{ [counter]( int v ) { return v + ++*counter; } };
+      Function mut{ [calls = 0]( int v ) mutable { return v + ++calls; } };
+
+      CHECK_FALSE( empty );
+      CHECK( pointer );
+      CHECK( pointer( 4 ) == 8 );
+      CHECK( reference( 4 ) == 7 );
+      offset = 10;
+      CHECK( reference( 4 ) == 14 );
+      CHECK( owning( 4 ) == 5 );
+      CHECK( owning( 4 ) == 6 );
+      CHECK( mut( 1 ) == 2 );
+      CHECK( mut( 1 ) == 3 );
+    }
+
+    AND_WHEN( "Copying and moving functions" )
+    {
+      auto counter = std::make_shared<int>( 0 );
+      Function owning{ [counter]( int v ) { return v + ++*counter; } };
+      CHECK( counter.use_count() == 2 );
+
+      auto copy = owning;
+      CHECK( counter.use_count() == 3 );
+      CHECK( copy( 1 ) == 2 );
+      CHECK( owning( 1 ) == 3 );
+
+      auto moved = std::move( copy );
+      CHECK( moved( 1 ) == 4 );
+
+      moved = Function{ &twice };
+      CHECK( moved( 1 ) == 2 );
+      copy = Function{};
+      CHECK( counter.use_count() == 2 );
+
+      owning = moved;
+      CHECK( owning( 2 ) == 4 );
+      CHECK( counter.use_count() == 1 );
+    }
+
+    AND_WHEN( "Storing callables that return a value in a function returning void" )
+    {
+      auto total = 0;
+      spt::http::router::InlineFunction<void( int )> discard{ [&total]( int v ) { return total += v; } };
+      spt::http::router::InlineFunction<void( int )> pointer{ &twice };
+      discard( 2 );
+      discard( 3 );
+      pointer( 1 );
+      CHECK( total == 5 );
+
+      spt::http::router::InlineFunction<long( int )> widened{ &twice };
+      CHECK( widened( 2 ) == 4L );
+    }
+  }
+
+  GIVEN( "Function references" )
+  {
+    using Function = spt::http::router::FunctionRef<int( int )>;
+
+    WHEN( "Referencing callables of different kinds" )
+    {
+      auto offset = 3;
+      auto lambda = [&offset]( int v ) { return v + offset; };
+      Function pointer{ &twice };
+      Function function{ twice };
+      Function reference{ lambda };
+      Function stateless{ []( int v ) { return v - 1; } };
+
+      CHECK( pointer( 4 ) == 8 );
+      CHECK( function( 4 ) == 8 );
+      CHECK( reference( 4 ) == 7 );
+      offset = 10;
+      CHECK( reference( 4 ) == 14 );
+      CHECK( stateless( 4 ) == 3 );
+
+      auto copy = reference;
+      CHECK( copy( 1 ) == 11 );
+    }
+
+    AND_WHEN( "Referencing callables that return a value from a function returning void" )
+    {
+      auto total = 0;
+      auto lambda = [&total]( int v ) { return total += v; };
+      spt::http::router::FunctionRef<void( int )> reference{ lambda };
+      spt::http::router::FunctionRef<void( int )> pointer{ &twice };
+      spt::http::router::FunctionRef<void( int )> function{ twice };
+      spt::http::router::FunctionRef<void( int )> stateless{ []( int v ) { return v; } };
+      reference( 2 );
+      reference( 3 );
+      pointer( 1 );
+      function( 1 );
+      stateless( 1 );
+      CHECK( total == 5 );
+    }
+  }
+
+  GIVEN( "Router with inline function handlers" )
+  {
+    using Function = spt::http::router::InlineFunction<std::string_view( Request&, Params&& )>;
+    using Router = spt::http::router::HttpRouter<Request&, std::string_view, Params, Function>;
+
+    auto suffix = "-sensor"s;
+    auto r = Router::Builder{}.
+        withNotFound( []( Request&, Params&& ) { return "404"sv; } ).
+        withMethodNotAllowed( []( Request&, Params&& ) { return "405"sv; } ).
+        build();
+    r.add<&sensors>( "GET"sv, "/device/sensor/"sv );
+    r.add<&sensor>( "GET"sv, "/device/sensor/id/{id}"sv );
+    r.add( "GET"sv, "/device/{type}/id/{id}"sv, [&suffix]( Request& request, Params&& params )
+    {
+      ++request.routed;
+      return params["type"sv].ends_with( suffix ) ? "typed"sv : "other"sv;
+    } );
+
+    WHEN( "Routing requests" )
+    {
+      Request request;
+      auto resp = r.route( "GET"sv, "/device/sensor/"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "sensors"sv );
+
+      resp = r.route( "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "6230f3069e7c9be9ff4b78a1"sv );
+
+      resp = r.route( "GET"sv, "/device/camera-sensor/id/6230f3069e7c9be9ff4b78a1"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "typed"sv );
+
+      resp = r.route( "PUT"sv, "/device/sensor/"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "405"sv );
+      CHECK( request.routed == 3 );
+
+      const auto compiled = r.compile();
+      resp = compiled.route( "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "6230f3069e7c9be9ff4b78a1"sv );
+      CHECK( request.routed == 4 );
+    }
+  }
+
+  GIVEN( "Router with function reference handlers" )
+  {
+    using Function = spt::http::router::FunctionRef<std::string_view( Request&, Params&& )>;
+    using Router = spt::http::router::HttpRouter<Request&, std::string_view, Params, Function>;
+
+    auto calls = 0;
+    auto counted = [&calls]( Request&, Params&& ) { ++calls; return "counted"sv; };
+
+    Router r;
+    r.add<&sensors>( "GET"sv, "/device/sensor/"sv );
+    r.add( "GET"sv, "/device/sensor/id/{id}"sv, &sensor );
+    r.add( "GET"sv, "/device/sensor/count"sv, counted );
+
+    WHEN( "Routing requests" )
+    {
+      Request request;
+      auto resp = r.route( "GET"sv, "/device/sensor/"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "sensors"sv );
+
+      resp = r.route( "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "6230f3069e7c9be9ff4b78a1"sv );
+
+      resp = r.route( "GET"sv, "/device/sensor/count"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "counted"sv );
+      CHECK( calls == 1 );
+      CHECK( request.routed == 2 );
+    }
+  }
+}
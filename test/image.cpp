@@ -0,0 +1,193 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include "../src/router.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+SCENARIO( "Compiled router image test suite" )
+{
+  struct Request {} request;
+  using Router = spt::http::router::HttpRouter<const Request&, std::string>;
+  using Compiled = spt::http::router::CompiledRouter<const Request&, std::string, Router::MapType>;
+  using spt::http::router::RouteId;
+
+  auto handler = []( std::string name )
+  {
+    return [name]( const Request&, Router::MapType&& args )
+    {
+      auto out = name;
+      for ( auto&& [key, value] : args ) out.append( "|" ).append( key ).append( "=" ).append( value );
+      return out;
+    };
+  };
+
+  // Handlers named after the method and path they are configured for, so they can be bound by RouteId
+  auto bind = [&handler]( const RouteId& r ) { return Router::Handler{ handler( std::string{ r.method } + " " + std::string{ r.path } ) }; };
+
+  auto save = []( const Compiled& compiled )
+  {
+    auto out = std::ostringstream{};
+    compiled.save( out );
+    const auto str = out.str();
+    auto image = std::vector<std::byte>( str.size() );
+    std::memcpy( image.data(), str.data(), str.size() );
+    return image;
+  };
+
+  GIVEN( "Router configured with static, parametrised, custom method and wildcard paths" )
+  {
+    Router r{ []( const Request&, Router::MapType&& ) { return "404"s; },
+        []( const Request&, Router::MapType&& ) { return "405"s; } };
+    for ( const auto& [method, path] : std::vector<std::pair<std::string_view, std::string_view>>{
+        { "GET"sv, "/device/sensor/"sv },
+        { "POST"sv, "/device/sensor/"sv },
+        { "GET"sv, "/device/sensor/id/{id}"sv },
+        { "PUT"sv, "/device/sensor/id/{id}"sv },
+        { "PURGE"sv, "/device/sensor/id/{id}"sv },
+        { "GET"sv, "/device/sensor/{property}/between/{start}/{end}"sv },
+        { "GET"sv, "/device/sensor/id/{id}/*"sv },
+        { "GET"sv, "/device/file/*"sv },
+        { "PROPFIND"sv, "/dav/{collection}/*"sv } } )
+    {
+      r.add( method, path, handler( std::string{ method } + " " + std::string{ path } ) );
+    }
+
+    const auto compiled = r.compile();
+    const auto image = save( compiled );
+
+    const auto requests = std::vector<std::pair<std::string_view, std::string_view>>{
+        { "GET"sv, "/device/sensor/"sv },
+        { "POST"sv, "/device/sensor/"sv },
+        { "DELETE"sv, "/device/sensor/"sv },
+        { "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv },
+        { "PUT"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv },
+        { "PURGE"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv },
+        { "MKCOL"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv },
+        { "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1/history/json"sv },
+        { "GET"sv, "/device/sensor/created/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z"sv },
+        { "GET"sv, "/device/file/path/to/file.txt"sv },
+        { "PROPFIND"sv, "/dav/calendar/2022/03/event.ics"sv },
+        { "GET"sv, "/dav/calendar/2022/03/event.ics"sv },
+        { "GET"sv, "/other/path"sv },
+        { "GET"sv, "/"sv },
+    };
+
+    WHEN( "Loading the router from the saved image" )
+    {
+      auto ids = std::vector<RouteId>{};
+      const auto loaded = Compiled::load( image, nullptr, [&]( const RouteId& id )
+      {
+        ids.push_back( RouteId{ id.id, id.method, {} } );
+        return bind( id );
+      }, []( const Request&, Router::MapType&& ) { return "404"s; },
+          []( const Request&, Router::MapType&& ) { return "405"s; } );
+
+      CHECK( loaded.bytes() == compiled.bytes() );
+      CHECK( ids.size() == 9 );
+
+      for ( const auto& [method, path] : requests )
+      {
+        INFO( method << " " << path );
+        CHECK( loaded.route( method, path, request ) == r.route( method, path, request ) );
+        CHECK( loaded.route( method, path, request, true ) == r.route( method, path, request, true ) );
+        CHECK( loaded.canRoute( method, path ) == r.canRoute( method, path ) );
+      }
+
+      auto resp = loaded.route( "GET"sv, "/device/file/path/to/file.txt"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "GET /device/file/*|_wildcard_=path/to/file.txt"s );
+    }
+
+    AND_WHEN( "Memory mapping the image from a file" )
+    {
+      const auto file = ( std::filesystem::temp_directory_path() / "http-router-image.bin" ).string();
+      {
+        auto out = std::ofstream{ file, std::ios::binary };
+        compiled.save( out );
+      }
+
+      {
+        const auto loaded = Compiled::map( file, bind, []( const Request&, Router::MapType&& ) { return "404"s; },
+            []( const Request&, Router::MapType&& ) { return "405"s; } );
+        for ( const auto& [method, path] : requests )
+        {
+          INFO( method << " " << path );
+          CHECK( loaded.route( method, path, request ) == compiled.route( method, path, request ) );
+          CHECK( loaded.canRoute( method, path ) == r.canRoute( method, path ) );
+        }
+      }
+
+      std::remove( file.c_str() );
+    }
+
+    AND_WHEN( "Loading an invalid image" )
+    {
+      auto bad = image;
+      bad[0] = std::byte{ 'X' };
+      CHECK_THROWS_AS( Compiled::load( bad, nullptr, bind ), spt::http::router::InvalidImageError );
+
+      auto truncated = std::span<const std::byte>{ image }.first( image.size() - 1 );
+      CHECK_THROWS_AS( Compiled::load( truncated, nullptr, bind ), spt::http::router::InvalidImageError );
+
+      auto header = std::span<const std::byte>{ image }.first( 16 );
+      CHECK_THROWS_AS( Compiled::load( header, nullptr, bind ), spt::http::router::InvalidImageError );
+
+      CHECK_THROWS_AS( Compiled::map( "/non/existent/router.bin"s, bind ), std::system_error );
+    }
+
+    AND_WHEN( "Loading a corrupt image" )
+    {
+      // Overwrite each word of the routing data in turn.  The image must either be
+      // rejected, or route without reading outside the routing data.
+      auto rejected = 0;
+      for ( auto offset = image.size() - compiled.bytes(); offset + sizeof( std::uint32_t ) <= image.size(); offset += sizeof( std::uint32_t ) )
+      {
+        for ( const auto value : { std::uint32_t{ 0x7fffffff }, std::uint32_t{ 0x1000 } } )
+        {
+          auto corrupt = image;
+          std::memcpy( corrupt.data() + offset, &value, sizeof( value ) );
+          try
+          {
+            const auto loaded = Compiled::load( corrupt, nullptr, bind );
+            for ( const auto& [method, path] : requests )
+            {
+              [[maybe_unused]] const auto resp = loaded.route( method, path, request );
+              [[maybe_unused]] const auto can = loaded.canRoute( method, path );
+            }
+          }
+          catch ( const spt::http::router::InvalidImageError& )
+          {
+            ++rejected;
+          }
+        }
+      }
+      CHECK( rejected > 0 );
+    }
+  }
+
+  GIVEN( "Router without any routes" )
+  {
+    Router r;
+    const auto image = save( r.compile() );
+
+    WHEN( "Loading the router from the saved image" )
+    {
+      const auto loaded = Compiled::load( image, nullptr, bind );
+      CHECK_FALSE( loaded.route( "GET"sv, "/device/sensor/"sv, request ) );
+      auto [p, m] = loaded.canRoute( "GET"sv, "/device/sensor/"sv );
+      CHECK_FALSE( p );
+      CHECK_FALSE( m );
+    }
+  }
+}
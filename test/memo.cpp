@@ -0,0 +1,150 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+SCENARIO( "Thread local route memo test suite" )
+{
+  struct Request {} request;
+  using Map = spt::http::router::HttpRouter<const Request&, std::string>::MapType;
+  using Router = spt::http::router::HttpRouter<const Request&, std::string, Map,
+      std::function<std::string( const Request&, Map&& )>, 32>;
+
+  GIVEN( "Router with a route memo" )
+  {
+    auto r = Router::Builder{}.
+        withNotFound( []( const Request&, Map&& ) { return "404"s; } ).
+        withMethodNotAllowed( []( const Request&, Map&& ) { return "405"s; } ).build();
+    r.add( "GET"sv, "/device/sensor/"sv, []( const Request&, auto&& ) { return "root"s; } );
+    r.add( "GET"sv, "/device/sensor/id/{id}"sv, []( const Request&, Map&& args )
+    {
+      return "id|"s.append( args["id"] );
+    } );
+    r.add( "GET"sv, "/device/sensor/{property}/between/{start}/{end}"sv, []( const Request&, Map&& args )
+    {
+      return "between|"s.append( args["property"] ).append( "|" ).append( args["start"] ).append( "|" ).append( args["end"] );
+    } );
+    r.add( "GET"sv, "/device/file/*"sv, []( const Request&, Map&& args )
+    {
+      return "file|"s.append( args[Router::WildcardKey] );
+    } );
+
+    WHEN( "Routing the same paths repeatedly" )
+    {
+      for ( auto i = 0; i < 3; ++i )
+      {
+        auto resp = r.route( "GET"sv, "/device/sensor/"sv, request );
+        REQUIRE( resp );
+        CHECK( *resp == "root"s );
+
+        resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+        REQUIRE( resp );
+        CHECK( *resp == "id|abc"s );
+
+        resp = r.route( "GET"sv, "/device/sensor/count/between/1/2"sv, request );
+        REQUIRE( resp );
+        CHECK( *resp == "between|count|1|2"s );
+
+        resp = r.route( "GET"sv, "/device/file/a/b/c.txt"sv, request );
+        REQUIRE( resp );
+        CHECK( *resp == "file|a/b/c.txt"s );
+
+        resp = r.route( "POST"sv, "/device/sensor/id/abc"sv, request );
+        REQUIRE( resp );
+        CHECK( *resp == "405"s );
+      }
+    }
+
+    AND_WHEN( "Adding and removing routes that match memoised paths" )
+    {
+      auto resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "id|abc"s );
+
+      r.add( "GET"sv, "/device/sensor/id/abc"sv, []( const Request&, auto&& ) { return "static"s; } );
+      resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "static"s );
+
+      CHECK( r.remove( "GET"sv, "/device/sensor/id/abc"sv ) );
+      resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "id|abc"s );
+
+      CHECK( r.remove( "GET"sv, "/device/sensor/id/{id}"sv ) );
+      resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "404"s );
+    }
+
+    AND_WHEN( "Routing the same path with another router of the same type" )
+    {
+      auto resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "id|abc"s );
+
+      Router other;
+      other.add( "GET"sv, "/device/{type}/id/{id}"sv, []( const Request&, Map&& args )
+      {
+        return "other|"s.append( args["type"] ).append( "|" ).append( args["id"] );
+      } );
+
+      resp = other.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "other|sensor|abc"s );
+
+      resp = r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "id|abc"s );
+    }
+
+    AND_WHEN( "Routing more distinct paths than the memo holds" )
+    {
+      for ( auto j = 0; j < 2; ++j )
+      {
+        for ( auto i = 0; i < 100; ++i )
+        {
+          const auto id = std::to_string( i );
+          auto resp = r.route( "GET"sv, "/device/sensor/id/"s.append( id ), request );
+          REQUIRE( resp );
+          CHECK( *resp == "id|"s.append( id ) );
+        }
+      }
+    }
+
+    AND_WHEN( "Routing from multiple threads while adding routes" )
+    {
+      std::atomic<int> failures{ 0 };
+      auto threads = std::vector<std::thread>{};
+      for ( auto t = 0; t < 4; ++t )
+      {
+        threads.emplace_back( [&r, &failures, &request, t]
+        {
+          for ( auto i = 0; i < 1000; ++i )
+          {
+            const auto id = std::to_string( ( i + t ) % 20 );
+            auto resp = r.route( "GET"sv, "/device/sensor/id/"s.append( id ), request );
+            if ( !resp || *resp != "id|"s.append( id ) ) ++failures;
+          }
+        } );
+      }
+
+      for ( auto i = 0; i < 20; ++i )
+      {
+        r.add( "GET"sv, "/device/other/"s.append( std::to_string( i ) ), []( const Request&, auto&& ) { return "other"s; } );
+      }
+      for ( auto& thread : threads ) thread.join();
+
+      CHECK( failures == 0 );
+    }
+  }
+}
@@ -0,0 +1,145 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include "../src/router.hpp"
+
+#include <vector>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+SCENARIO( "HTTP method test suite" )
+{
+  struct Request {} request;
+
+  GIVEN( "The standard methods" )
+  {
+    using spt::http::router::Method;
+    using spt::http::router::impl::parse;
+
+    WHEN( "Parsing method names" )
+    {
+      CHECK( parse( "GET"sv ) == Method::Get );
+      CHECK( parse( "HEAD"sv ) == Method::Head );
+      CHECK( parse( "POST"sv ) == Method::Post );
+      CHECK( parse( "PUT"sv ) == Method::Put );
+      CHECK( parse( "DELETE"sv ) == Method::Delete );
+      CHECK( parse( "CONNECT"sv ) == Method::Connect );
+      CHECK( parse( "OPTIONS"sv ) == Method::Options );
+      CHECK( parse( "TRACE"sv ) == Method::Trace );
+      CHECK( parse( "PATCH"sv ) == Method::Patch );
+      CHECK( parse( "get"sv ) == Method::Other );
+      CHECK( parse( "PURGE"sv ) == Method::Other );
+      CHECK( parse( ""sv ) == Method::Other );
+    }
+  }
+
+  GIVEN( "Router configured with standard and custom methods" )
+  {
+    using Router = spt::http::router::HttpRouter<const Request&, int>;
+    Router r{ std::nullopt, []( const Request&, Router::MapType&& ) { return 405; } };
+
+    r.add( "GET"sv, "/cache/{key}"sv, []( const Request&, auto&& ) { return 1; } );
+    r.add( "PURGE"sv, "/cache/{key}"sv, []( const Request&, auto&& ) { return 2; } );
+    r.add( "PROPFIND"sv, "/dav/*"sv, []( const Request&, auto&& ) { return 3; } );
+
+    WHEN( "Routing standard and custom methods" )
+    {
+      auto resp = r.route( "GET"sv, "/cache/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 1 );
+
+      resp = r.route( "PURGE"sv, "/cache/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 2 );
+
+      resp = r.route( "PROPFIND"sv, "/dav/folder/file"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 3 );
+    }
+
+    AND_WHEN( "Routing methods that are not configured" )
+    {
+      auto resp = r.route( "POST"sv, "/cache/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 405 );
+
+      resp = r.route( "get"sv, "/cache/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 405 );
+
+      resp = r.route( "PURGE"sv, "/dav/folder"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 405 );
+
+      auto [p, m] = r.canRoute( "MKCOL"sv, "/dav/folder"sv );
+      CHECK( p );
+      CHECK_FALSE( m );
+    }
+
+#ifdef HAS_BOOST
+    AND_WHEN( "Serialising to JSON" )
+    {
+      auto json = r.json();
+      auto obj = json.as_object();
+      auto path = obj["paths"].as_array()[0].as_object();
+      auto& methods = path["methods"].as_array();
+      REQUIRE( methods.size() == 2 );
+      CHECK( methods[0].as_string() == "GET"sv );
+      CHECK( methods[1].as_string() == "PURGE"sv );
+    }
+#endif
+
+    AND_WHEN( "Configuring too many custom methods" )
+    {
+      auto configure = [&r]
+      {
+        for ( auto i = 0; i < 64; ++i )
+        {
+          r.add( "CUSTOM"s + std::to_string( i ), "/custom"sv, []( const Request&, auto&& ) { return 0; } );
+        }
+      };
+      REQUIRE_THROWS_AS( configure(), spt::http::router::InvalidMethodError );
+    }
+
+    AND_WHEN( "Configuring invalid routes with new custom methods" )
+    {
+      using spt::http::router::impl::MaxMethods;
+      using spt::http::router::impl::StandardMethods;
+
+      CHECK_THROWS_AS( r.add( "REPORT"sv, "/report/{id:float}"sv, []( const Request&, auto&& ) { return 4; } ),
+          spt::http::router::InvalidParameterError );
+      CHECK_THROWS_AS( r.add( "REPORT"sv, "/report/*/more"sv, []( const Request&, auto&& ) { return 4; } ),
+          spt::http::router::InvalidWildcardError );
+
+      auto routes = std::vector<Router::RouteSpec>{};
+      routes.push_back( { "MKCOL"sv, "/dav/{folder}"sv, []( const Request&, auto&& ) { return 5; } } );
+      routes.push_back( { "MKCOL"sv, "/dav/{id:float}"sv, []( const Request&, auto&& ) { return 5; } } );
+      CHECK_THROWS_AS( r.addAll( routes ), spt::http::router::InvalidParameterError );
+
+      // Neither copy of the table holds the rejected methods, so every remaining custom method can be added
+      const auto available = MaxMethods - StandardMethods - 2;
+      for ( std::size_t i = 0; i < available; ++i )
+      {
+        INFO( i );
+        CHECK_NOTHROW( r.add( "CUSTOM"s + std::to_string( i ), "/custom"sv,
+            [i]( const Request&, auto&& ) { return static_cast<int>( 10 + i ); } ) );
+      }
+      CHECK_THROWS_AS( r.add( "REPORT"sv, "/report"sv, []( const Request&, auto&& ) { return 4; } ),
+          spt::http::router::InvalidMethodError );
+
+      for ( std::size_t i = 0; i < available; ++i )
+      {
+        auto resp = r.route( "CUSTOM"s + std::to_string( i ), "/custom"sv, request );
+        REQUIRE( resp );
+        CHECK( *resp == static_cast<int>( 10 + i ) );
+      }
+      auto resp = r.route( "PURGE"sv, "/cache/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == 2 );
+      CHECK( std::get<1>( r.canRoute( "MKCOL"sv, "/dav/folder"sv ) ) == false );
+    }
+  }
+}
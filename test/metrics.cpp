@@ -0,0 +1,147 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+SCENARIO( "Route metrics test suite" )
+{
+  struct Request {} request;
+  using Map = spt::http::router::HttpRouter<const Request&, int>::MapType;
+  using Router = spt::http::router::HttpRouter<const Request&, int, Map,
+      std::function<int( const Request&, Map&& )>, 0, true>;
+
+  const auto find = []( const spt::http::router::RouterStats& stats, std::string_view path ) -> const spt::http::router::PathStats&
+  {
+    return *std::find_if( stats.paths.begin(), stats.paths.end(), [path]( const auto& p ) { return p.path == path; } );
+  };
+
+  GIVEN( "An instrumented router" )
+  {
+    auto r = Router::Builder{}.
+        withNotFound( []( const Request&, Map&& ) { return 404; } ).
+        withMethodNotAllowed( []( const Request&, Map&& ) { return 405; } ).
+        withErrorHandler( []( const Request&, Map&& ) { return 500; } ).build();
+    r.add( "GET"sv, "/device/sensor/"sv, []( const Request&, auto&& ) { return 1; } );
+    r.add( "POST"sv, "/device/sensor/"sv, []( const Request&, auto&& ) { return 2; } );
+    r.add( "GET"sv, "/device/sensor/id/{id}"sv, []( const Request&, auto&& ) { return 3; } );
+    r.add( "GET"sv, "/device/file/*"sv, []( const Request&, auto&& ) { return 4; } );
+    r.add( "GET"sv, "/device/error/{id}"sv, []( const Request&, auto&& ) -> int { throw std::runtime_error{ "error" }; } );
+
+    WHEN( "Routing requests with every outcome" )
+    {
+      CHECK( r.route( "GET"sv, "/device/sensor/"sv, request ) == 1 );
+      CHECK( r.route( "GET"sv, "/device/sensor/"sv, request ) == 1 );
+      CHECK( r.route( "POST"sv, "/device/sensor/"sv, request ) == 2 );
+      CHECK( r.route( "PUT"sv, "/device/sensor/"sv, request ) == 405 );
+      CHECK( r.route( "GET"sv, "/device/sensor/id/abc"sv, request ) == 3 );
+      CHECK( r.route( "DELETE"sv, "/device/sensor/id/abc"sv, request ) == 405 );
+      CHECK( r.route( "GET"sv, "/device/file/a/b"sv, request ) == 4 );
+      CHECK( r.route( "GET"sv, "/device/error/abc"sv, request ) == 500 );
+      CHECK( r.route( "GET"sv, "/device/abc/x"sv, request ) == 404 );
+      CHECK_FALSE( r.route( "GET"sv, "/zzz"sv, request ) );
+
+      const auto stats = r.stats();
+      CHECK( stats.notFound == 2 );
+      REQUIRE( stats.paths.size() == 4 );
+
+      const auto& sensor = find( stats, "/device/sensor/"sv );
+      CHECK( sensor.methodNotAllowed == 1 );
+      REQUIRE( sensor.methods.size() == 2 );
+      CHECK( sensor.methods[0].method == "GET"s );
+      CHECK( sensor.methods[0].requests == 2 );
+      CHECK( sensor.methods[0].errors == 0 );
+      CHECK( sensor.methods[0].latency.count() == 2 );
+      CHECK( sensor.methods[1].method == "POST"s );
+      CHECK( sensor.methods[1].requests == 1 );
+
+      const auto& id = find( stats, "/device/sensor/id/{id}"sv );
+      CHECK( id.methodNotAllowed == 1 );
+      REQUIRE( id.methods.size() == 1 );
+      CHECK( id.methods[0].requests == 1 );
+
+      const auto& file = find( stats, "/device/file/*"sv );
+      REQUIRE( file.methods.size() == 1 );
+      CHECK( file.methods[0].requests == 1 );
+
+      const auto& error = find( stats, "/device/error/{id}"sv );
+      REQUIRE( error.methods.size() == 1 );
+      CHECK( error.methods[0].requests == 1 );
+      CHECK( error.methods[0].errors == 1 );
+    }
+
+#ifdef HAS_BOOST
+    AND_WHEN( "Serialising to JSON" )
+    {
+      CHECK( r.route( "GET"sv, "/device/sensor/"sv, request ) == 1 );
+      CHECK( r.route( "GET"sv, "/device/abc/x"sv, request ) == 404 );
+
+      auto json = r.json();
+      auto& obj = json.as_object();
+      REQUIRE( obj.contains( "notFound" ) );
+      CHECK( obj["notFound"].as_uint64() == 1 );
+
+      auto& paths = obj["paths"].as_array();
+      auto sensor = std::find_if( paths.begin(), paths.end(), []( auto& p ) { return p.as_object()["path"].as_string() == "/device/sensor/"sv; } );
+      REQUIRE( sensor != paths.end() );
+      auto& stats = sensor->as_object()["stats"].as_object();
+      CHECK( stats["methodNotAllowed"].as_uint64() == 0 );
+      auto& get = stats["methods"].as_object()["GET"].as_object();
+      CHECK( get["requests"].as_uint64() == 1 );
+      CHECK( get["errors"].as_uint64() == 0 );
+      CHECK( get["latency"].as_array().size() == spt::http::router::LatencyHistogram::Buckets );
+    }
+#endif
+
+    AND_WHEN( "Removing a route" )
+    {
+      CHECK( r.route( "POST"sv, "/device/sensor/"sv, request ) == 2 );
+      CHECK( r.remove( "POST"sv, "/device/sensor/"sv ) );
+      CHECK( r.route( "POST"sv, "/device/sensor/"sv, request ) == 405 );
+      CHECK( r.remove( "GET"sv, "/device/sensor/id/{id}"sv ) );
+
+      const auto stats = r.stats();
+      REQUIRE( stats.paths.size() == 3 );
+      const auto& sensor = find( stats, "/device/sensor/"sv );
+      CHECK( sensor.methodNotAllowed == 1 );
+      REQUIRE( sensor.methods.size() == 1 );
+      CHECK( sensor.methods[0].method == "GET"s );
+    }
+
+    AND_WHEN( "Routing from multiple threads" )
+    {
+      auto threads = std::vector<std::thread>{};
+      for ( auto t = 0; t < 8; ++t )
+      {
+        threads.emplace_back( [&r, &request]
+        {
+          for ( auto i = 0; i < 1000; ++i ) r.route( "GET"sv, "/device/sensor/id/abc"sv, request );
+        } );
+      }
+      for ( auto& thread : threads ) thread.join();
+
+      const auto stats = r.stats();
+      CHECK( find( stats, "/device/sensor/id/{id}"sv ).methods[0].requests == 8000 );
+    }
+  }
+
+  GIVEN( "The latency histogram" )
+  {
+    using spt::http::router::LatencyHistogram;
+    CHECK( LatencyHistogram::bucket( 0 ) == 0 );
+    CHECK( LatencyHistogram::bucket( 1 ) == 1 );
+    CHECK( LatencyHistogram::bucket( 1023 ) == 10 );
+    CHECK( LatencyHistogram::bucket( 1024 ) == 11 );
+    CHECK( LatencyHistogram::bucket( std::uint64_t{ 1 } << 40 ) == LatencyHistogram::Buckets - 1 );
+    CHECK( 1023 < LatencyHistogram::bound( 10 ) );
+  }
+}
@@ -0,0 +1,201 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include "../src/router.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+  // Straightforward version to check the vectorised one against: decode, split, then resolve the segments
+  std::string reference( std::string_view path )
+  {
+    if ( !path.starts_with( '/' ) ) return std::string{ path };
+
+    auto segments = std::vector<std::string>{};
+    auto current = std::string{};
+    auto trailing = false;
+    const auto flush = [&]( bool last )
+    {
+      trailing = last && ( current.empty() || current == "." || current == ".." );
+      if ( current == ".." ) { if ( !segments.empty() ) segments.pop_back(); }
+      else if ( !current.empty() && current != "." ) segments.push_back( current );
+      current.clear();
+    };
+
+    for ( std::size_t i = 1; i < path.size(); ++i )
+    {
+      const auto c = path[i];
+      if ( c == '/' ) { flush( false ); continue; }
+      if ( c == '%' && i + 2 < path.size() )
+      {
+        const auto hex = std::string{ path.substr( i + 1, 2 ) };
+        if ( std::isxdigit( static_cast<unsigned char>( hex[0] ) ) && std::isxdigit( static_cast<unsigned char>( hex[1] ) ) )
+        {
+          const auto d = static_cast<char>( std::stoi( hex, nullptr, 16 ) );
+          if ( std::isalnum( static_cast<unsigned char>( d ) ) || d == '-' || d == '.' || d == '_' || d == '~' )
+          {
+            current.push_back( d );
+            i += 2;
+            continue;
+          }
+        }
+      }
+      current.push_back( c );
+    }
+    flush( true );
+
+    auto out = std::string{};
+    for ( const auto& s : segments ) out.append( "/" ).append( s );
+    if ( trailing || out.empty() ) out.append( "/" );
+    return out;
+  }
+}
+
+SCENARIO( "Path normalisation test suite" )
+{
+  using spt::util::normalise;
+
+  GIVEN( "Paths to normalise" )
+  {
+    auto buffer = std::string{};
+
+    WHEN( "Normalising paths that need rewriting" )
+    {
+      for ( const auto& [path, expected] : std::vector<std::pair<std::string_view, std::string_view>>{
+          { "//device//sensor/"sv, "/device/sensor/"sv },
+          { "/device/sensor//"sv, "/device/sensor/"sv },
+          { "//"sv, "/"sv },
+          { "/a/./b/../c"sv, "/a/c"sv },
+          { "/a/b/.."sv, "/a/"sv },
+          { "/a/b/."sv, "/a/b/"sv },
+          { "/../../a"sv, "/a"sv },
+          { "/.."sv, "/"sv },
+          { "/%7Euser/%61%62c"sv, "/~user/abc"sv },
+          { "/a/%2E%2E/b"sv, "/b"sv },
+          { "/a/%2e/b"sv, "/a/b"sv },
+          { "http://example.com/device/sensor/"sv, "/device/sensor/"sv },
+          { "https://example.com:8443//device/./sensor"sv, "/device/sensor"sv },
+          { "http://example.com"sv, "/"sv },
+          { "/device/sensor/id/6230f3069e7c9be9ff4b78a1/history/./json"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1/history/json"sv },
+          { "/device/sensor/id/6230f3069e7c9be9ff4b78a1/history/archive/2022/../json"sv,
+              "/device/sensor/id/6230f3069e7c9be9ff4b78a1/history/archive/json"sv },
+        } )
+      {
+        INFO( path );
+        CHECK( normalise( path, buffer ) == expected );
+        CHECK( normalise( path, buffer ) == reference( path.starts_with( "http" ) ? expected : path ) );
+      }
+    }
+
+    AND_WHEN( "Normalising paths that are already normal" )
+    {
+      for ( const auto path : { "/"sv, "/device/sensor/"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1/history/json"sv,
+          "/.well-known/openid-configuration"sv, "/a/..b/c."sv, "/file%2Fname/100%25"sv, "/%zz"sv, "*"sv, "/a%2"sv } )
+      {
+        INFO( path );
+        const auto result = normalise( path, buffer );
+        CHECK( result == path );
+        CHECK( result.data() == path.data() );
+      }
+      CHECK( buffer.empty() );
+    }
+
+    AND_WHEN( "Normalising into a fixed buffer" )
+    {
+      auto fixed = std::array<char, 8>{};
+      CHECK( normalise( "/a//b"sv, fixed ) == "/a/b"sv );
+      CHECK_FALSE( normalise( "/device//sensor"sv, fixed ) );
+      CHECK( normalise( "/device/sensor"sv, fixed ) == "/device/sensor"sv );
+    }
+
+    AND_WHEN( "Normalising generated paths" )
+    {
+      constexpr auto alphabet = "//..ab%2E7e"sv;
+      auto engine = std::mt19937{ 42 };
+      auto pick = std::uniform_int_distribution<std::size_t>{ 0, alphabet.size() - 1 };
+      auto length = std::uniform_int_distribution<std::size_t>{ 0, 80 };
+      for ( int i = 0; i < 2000; ++i )
+      {
+        auto path = "/"s;
+        for ( auto n = length( engine ); n > 0; --n ) path.push_back( alphabet[pick( engine )] );
+        INFO( path );
+        CHECK( normalise( path, buffer ) == reference( path ) );
+      }
+    }
+  }
+
+  GIVEN( "Routers that normalise request paths" )
+  {
+    struct Request {} request;
+    using Router = spt::http::router::HttpRouter<const Request&, std::string>;
+    using Cached = spt::http::router::HttpRouter<const Request&, std::string, Router::MapType,
+        std::function<std::string( const Request&, Router::MapType&& )>, 8>;
+
+    auto handler = []( std::string name )
+    {
+      return [name]( const Request&, Router::MapType&& args )
+      {
+        auto out = name;
+        for ( auto&& [key, value] : args ) out.append( "|" ).append( key ).append( "=" ).append( value );
+        return out;
+      };
+    };
+
+    auto r = Router::Builder{}.withNormalisation().build();
+    Cached c{ std::nullopt, std::nullopt, std::nullopt, 16, true };
+    Router plain;
+    for ( auto* router : { &r, &plain } )
+    {
+      router->add( "GET"sv, "/device/sensor/"sv, handler( "root" ) );
+      router->add( "GET"sv, "/device/sensor/id/{id}"sv, handler( "id" ) );
+      router->add( "GET"sv, "/~user/{name}"sv, handler( "user" ) );
+      router->add( "GET"sv, "/device/file/*"sv, handler( "file" ) );
+    }
+    c.add( "GET"sv, "/device/sensor/"sv, handler( "root" ) );
+    c.add( "GET"sv, "/device/sensor/id/{id}"sv, handler( "id" ) );
+    c.add( "GET"sv, "/~user/{name}"sv, handler( "user" ) );
+    c.add( "GET"sv, "/device/file/*"sv, handler( "file" ) );
+
+    const auto requests = std::vector<std::pair<std::string_view, std::string_view>>{
+        { "//device//sensor/"sv, "root"sv },
+        { "/device/./sensor/x/../"sv, "root"sv },
+        { "http://example.com/device/sensor/"sv, "root"sv },
+        { "/device/sensor/id/%61bc"sv, "id|id=abc"sv },
+        { "/device/sensor/id/42/../.."sv, "root"sv },
+        { "/%7Euser/john"sv, "user|name=john"sv },
+        { "/device/file/a//b/./c.txt"sv, "file|_wildcard_=a/b/c.txt"sv },
+    };
+
+    WHEN( "Routing paths that need normalising" )
+    {
+      for ( const auto& [path, expected] : requests )
+      {
+        INFO( path );
+        CHECK( r.route( "GET"sv, path, request ) == std::string{ expected } );
+        CHECK( c.route( "GET"sv, path, request ) == std::string{ expected } );
+        CHECK( c.route( "GET"sv, path, request ) == std::string{ expected } );
+        CHECK( std::get<0>( r.canRoute( "GET"sv, path ) ) );
+      }
+
+      CHECK( r.routeTarget( "GET"sv, "/device//sensor/id/42?a=b"sv, request ) == "id|id=42"s );
+      CHECK_FALSE( plain.route( "GET"sv, "/device/./sensor/"sv, request ) );
+      CHECK_FALSE( std::get<0>( plain.canRoute( "GET"sv, "/%7Euser/john"sv ) ) );
+    }
+
+    AND_WHEN( "Routing a path longer than the stack buffer" )
+    {
+      auto path = "/device/file/"s;
+      while ( path.size() < 2048 ) path.append( "segment/./" );
+      auto expected = "file|_wildcard_="s;
+      for ( auto n = ( path.size() - 13 ) / 10; n > 0; --n ) expected.append( "segment/" );
+      CHECK( r.route( "GET"sv, path, request ) == expected );
+    }
+  }
+}
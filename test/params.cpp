@@ -0,0 +1,99 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+SCENARIO( "Inline parameters test suite" )
+{
+  struct Request {} request;
+  using Params = spt::http::router::InlineParams<3>;
+
+  GIVEN( "An empty parameter map" )
+  {
+    Params params;
+    REQUIRE( params.empty() );
+    REQUIRE( params.size() == 0 );
+    REQUIRE( Params::capacity() == 3 );
+
+    WHEN( "Inserting parameters" )
+    {
+      auto [it, inserted] = params.try_emplace( "id"sv, "abc"sv );
+      CHECK( inserted );
+      CHECK( it->first == "id"sv );
+      CHECK( it->second == "abc"sv );
+
+      auto [dit, dinserted] = params.try_emplace( "id"sv, "def"sv );
+      CHECK_FALSE( dinserted );
+      CHECK( dit->second == "abc"sv );
+
+      params["name"s] = "value"sv;
+      CHECK( params.size() == 2 );
+      CHECK( params.contains( "name" ) );
+      CHECK( params.count( "name"sv ) == 1 );
+      CHECK( params.at( "name"sv ) == "value"sv );
+      CHECK( params["id"s] == "abc"sv );
+      CHECK_FALSE( params.contains( "other"s ) );
+      CHECK( params.find( "other"sv ) == params.end() );
+      CHECK_THROWS_AS( params.at( "other"sv ), std::out_of_range );
+    }
+
+    AND_WHEN( "Inserting more parameters than the capacity" )
+    {
+      params.try_emplace( "a"sv, "1"sv );
+      params.try_emplace( "b"sv, "2"sv );
+      params.try_emplace( "c"sv, "3"sv );
+      CHECK( params.size() == 3 );
+      CHECK_THROWS_AS( params.try_emplace( "d"sv, "4"sv ), std::length_error );
+
+      std::size_t total = 0;
+      for ( auto&& [key, value] : params ) total += key.size() + value.size();
+      CHECK( total == 6 );
+
+      params.clear();
+      CHECK( params.empty() );
+    }
+  }
+
+  GIVEN( "Router using inline parameters" )
+  {
+    spt::http::router::HttpRouter<const Request&, std::string, Params> r;
+    r.add( "GET"sv, "/device/sensor/{property}/between/{start}/{end}"sv, []( const Request&, Params&& args )
+    {
+      REQUIRE( args.size() == 3 );
+      return std::string{ args["property"] };
+    } );
+    r.add( "GET"sv, "/device/{type}/id/{id}/*"sv, [&r]( const Request&, Params&& args )
+    {
+      REQUIRE( args.size() == 3 );
+      return std::string{ args[r.WildcardKey] };
+    } );
+
+    WHEN( "Routing parametrised paths" )
+    {
+      auto resp = r.route( "GET"sv, "/device/sensor/created/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "created"s );
+
+      resp = r.route( "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1/detail/json"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "detail/json"s );
+    }
+
+    AND_WHEN( "Configuring a path with more parameters than the capacity" )
+    {
+      REQUIRE_THROWS_AS(
+          r.add( "GET"sv, "/device/{type}/{property}/between/{start}/{end}"sv, []( const Request&, auto&& ) { return ""s; } ),
+          spt::http::router::InvalidParameterError
+      );
+      REQUIRE_THROWS_AS(
+          r.add( "GET"sv, "/device/{type}/{property}/{id}/*"sv, []( const Request&, auto&& ) { return ""s; } ),
+          spt::http::router::InvalidParameterError
+      );
+    }
+  }
+}
@@ -0,0 +1,77 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+  std::string golden( std::string_view name )
+  {
+    auto file = std::ifstream{ std::string{ GOLDEN_DIR } + "/" + std::string{ name } };
+    auto ss = std::ostringstream{};
+    ss << file.rdbuf();
+    return ss.str();
+  }
+
+  std::string line( const std::string& text, std::string_view prefix )
+  {
+    auto ss = std::istringstream{ text };
+    for ( std::string l; std::getline( ss, l ); ) if ( l.starts_with( prefix ) ) return l;
+    return {};
+  }
+}
+
+SCENARIO( "Prometheus exposition test suite" )
+{
+  struct Request {} request;
+  using Map = spt::http::router::HttpRouter<const Request&, int>::MapType;
+  using Router = spt::http::router::HttpRouter<const Request&, int, Map,
+      std::function<int( const Request&, Map&& )>, 0, true>;
+
+  GIVEN( "An instrumented router" )
+  {
+    auto r = Router::Builder{}.
+        withNotFound( []( const Request&, Map&& ) { return 404; } ).
+        withMethodNotAllowed( []( const Request&, Map&& ) { return 405; } ).build();
+    r.add( "GET"sv, "/device/sensor/"sv, []( const Request&, auto&& ) { return 1; } );
+    r.add( "POST"sv, "/device/sensor/"sv, []( const Request&, auto&& ) { return 2; } );
+    r.add( "GET"sv, "/device/sensor/id/{id}"sv, []( const Request&, auto&& ) { return 3; } );
+    r.add( "GET"sv, "/device/file/*"sv, []( const Request&, auto&& ) { return 4; } );
+    r.add( "GET"sv, "/device/say\"hi\"/"sv, []( const Request&, auto&& ) { return 5; } );
+
+    WHEN( "Rendering the counters for requests that were not handled" )
+    {
+      CHECK( r.route( "PUT"sv, "/device/sensor/"sv, request ) == 405 );
+      CHECK( r.route( "PUT"sv, "/device/sensor/"sv, request ) == 405 );
+      CHECK( r.route( "DELETE"sv, "/device/sensor/id/abc"sv, request ) == 405 );
+      CHECK( r.route( "GET"sv, "/device/abc/x"sv, request ) == 404 );
+
+      auto out = std::string{};
+      r.prometheus( out );
+      CHECK( out == golden( "prometheus.txt" ) );
+    }
+
+    AND_WHEN( "Rendering the counters for requests that were handled" )
+    {
+      for ( auto i = 0; i < 5; ++i ) CHECK( r.route( "GET"sv, "/device/sensor/id/abc"sv, request ) == 3 );
+
+      auto out = std::string{ "# previous content\n" };
+      r.prometheus( out );
+      CHECK( out.starts_with( "# previous content\n" ) );
+      const auto series = R"(http_router_request_duration_seconds_count{path="/device/sensor/id/{id}",method="GET"} )"s;
+      CHECK( line( out, series ) == series + "5" );
+      const auto inf = R"(http_router_request_duration_seconds_bucket{path="/device/sensor/id/{id}",method="GET",le="+Inf"} )"s;
+      CHECK( line( out, inf ) == inf + "5" );
+      const auto sum = R"(http_router_request_duration_seconds_sum{path="/device/sensor/id/{id}",method="GET"} )"s;
+      CHECK( line( out, sum ).size() == sum.size() + 11 );
+    }
+  }
+}
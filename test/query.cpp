@@ -0,0 +1,163 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include "../src/router.hpp"
+
+#include <vector>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+  using spt::http::router::Query;
+  using spt::http::router::QueryParam;
+
+  struct Request {};
+  using Map = spt::http::router::HttpRouter<const Request&, std::string>::MapType;
+
+  // Path parameters and then the query parameters, decoded
+  template <typename Params>
+  std::string describe( std::string_view name, const Params& args, const Query& query )
+  {
+    auto out = std::string{ name };
+    for ( auto&& [key, value] : args ) out.append( "|" ).append( key ).append( "=" ).append( value );
+    auto kb = std::string{};
+    auto vb = std::string{};
+    for ( const auto& p : query ) out.append( "|?" ).append( Query::decode( p.key, kb ) ).append( "=" ).append( Query::decode( p.value, vb ) );
+    return out;
+  }
+
+  std::string bound( const Request&, Map&& args, const Query& query ) { return describe( "bound"sv, args, query ); }
+  std::string plain( const Request&, Map&& args ) { return describe( "plain"sv, args, Query{} ); }
+
+  namespace impl = spt::http::router::impl;
+  static_assert( impl::target( "/a/b?c=d#e" ).path == "/a/b"sv );
+  static_assert( impl::target( "/a/b?c=d#e" ).query.raw() == "c=d"sv );
+  static_assert( impl::target( "/a/b#e?c=d" ).query.raw().empty() );
+  static_assert( impl::target( "/a/b" ).path == "/a/b"sv );
+  static_assert( Query{ "a=1&b=2&a=3" }.count( "a" ) == 2 );
+  static_assert( Query{ "a%5B%5D=1" }.find( "a[]" ) == "1"sv );
+}
+
+SCENARIO( "Query string test suite" )
+{
+  Request request;
+
+  GIVEN( "Query strings to parse" )
+  {
+    WHEN( "Iterating the parameters" )
+    {
+      const auto query = Query{ "a=1&&b&c=&=d&a=2%20x+y"sv };
+      const auto params = std::vector<QueryParam>( std::begin( query ), std::end( query ) );
+      CHECK( params == std::vector<QueryParam>{ { "a"sv, "1"sv }, { "b"sv, ""sv }, { "c"sv, ""sv }, { ""sv, "d"sv }, { "a"sv, "2%20x+y"sv } } );
+      CHECK( Query{}.empty() );
+      CHECK( Query{ "&&"sv }.empty() );
+    }
+
+    AND_WHEN( "Looking up keys" )
+    {
+      const auto query = Query{ "id=1&name=J%C3%B6rg&id=2&tag%5B%5D=x&id=3"sv };
+      CHECK( query.find( "id"sv ) == "1"sv );
+      CHECK( query.find( "name"sv ) == "J%C3%B6rg"sv );
+      CHECK( query.find( "tag[]"sv ) == "x"sv );
+      CHECK_FALSE( query.find( "missing"sv ) );
+      CHECK_FALSE( query.find( "i"sv ) );
+      CHECK( query.contains( "name"sv ) );
+      CHECK( query.count( "id"sv ) == 3 );
+
+      auto ids = std::vector<std::string_view>{};
+      for ( const auto& p : query.values( "id"sv ) ) ids.push_back( p.value );
+      CHECK( ids == std::vector{ "1"sv, "2"sv, "3"sv } );
+    }
+
+    AND_WHEN( "Decoding values" )
+    {
+      auto buffer = std::string{};
+      const auto raw = "plain-value"sv;
+      const auto decoded = Query::decode( raw, buffer );
+      CHECK( decoded.data() == raw.data() );
+      CHECK( buffer.empty() );
+
+      CHECK( Query::decode( "J%C3%B6rg+M%c3%bcller"sv, buffer ) == "J\xc3\xb6rg M\xc3\xbcller"sv );
+      CHECK( Query::decode( "100%"sv, buffer ) == "100%"sv );
+      CHECK( Query::decode( "%zz%4"sv, buffer ) == "%zz%4"sv );
+      CHECK( Query::decode( "a%26b%3Dc"sv, buffer ) == "a&b=c"sv );
+    }
+  }
+
+  GIVEN( "Routers with handlers that accept the query" )
+  {
+    using Function = std::function<std::string( const Request&, Map&&, const Query& )>;
+    using Router = spt::http::router::HttpRouter<const Request&, std::string, Map, Function>;
+    using Cached = spt::http::router::HttpRouter<const Request&, std::string, Map, Function, 8>;
+    const auto notFound = []( const Request&, Map&&, const Query& query ) { return describe( "404"sv, Map{}, query ); };
+    const auto methodNotAllowed = []( const Request&, Map&&, const Query& query ) { return describe( "405"sv, Map{}, query ); };
+
+    Router r{ notFound, methodNotAllowed };
+    Cached c{ notFound, methodNotAllowed, std::nullopt, 16 };
+    const auto configure = []( auto& router )
+    {
+      router.add( "GET"sv, "/device/sensor/"sv, &bound );
+      router.template add<&plain>( "POST"sv, "/device/sensor/"sv );
+      router.template add<&bound>( "GET"sv, "/device/sensor/id/{id}"sv );
+      router.add( "GET"sv, "/device/file/*"sv, []( const Request&, Map&& args, const Query& query )
+      {
+        return describe( "file"sv, args, query );
+      } );
+    };
+    configure( r );
+    configure( c );
+    const auto compiled = r.compile();
+
+    const auto requests = std::vector<std::tuple<std::string_view, std::string_view, std::string_view>>{
+        { "GET"sv, "/device/sensor/?limit=10&sort=name"sv, "bound|?limit=10|?sort=name"sv },
+        { "GET"sv, "/device/sensor/#top"sv, "bound"sv },
+        { "POST"sv, "/device/sensor/?dry=true"sv, "plain"sv },
+        { "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1?fields=a&fields=b#x"sv,
+            "bound|id=6230f3069e7c9be9ff4b78a1|?fields=a|?fields=b"sv },
+        { "GET"sv, "/device/file/path/to/file.txt?download=1"sv, "file|_wildcard_=path/to/file.txt|?download=1"sv },
+        { "GET"sv, "/device/other?q=a+b"sv, "404|?q=a b"sv },
+        { "DELETE"sv, "/device/sensor/id/1?force=%74rue"sv, "405|?force=true"sv },
+    };
+
+    WHEN( "Routing request targets" )
+    {
+      for ( const auto& [method, target, expected] : requests )
+      {
+        INFO( method << " " << target );
+        auto resp = r.routeTarget( method, target, request );
+        REQUIRE( resp );
+        CHECK( *resp == expected );
+
+        // Twice, the second time from the cache and memo
+        CHECK( c.routeTarget( method, target, request ) == resp );
+        CHECK( c.routeTarget( method, target, request ) == resp );
+        CHECK( compiled.routeTarget( method, target, request ) == resp );
+      }
+    }
+
+    AND_WHEN( "Routing paths without a query" )
+    {
+      CHECK( r.route( "GET"sv, "/device/sensor/id/42"sv, request ) == "bound|id=42"s );
+      CHECK( compiled.route( "GET"sv, "/device/sensor/id/42"sv, request ) == "bound|id=42"s );
+      CHECK( r.routeTarget( "GET"sv, "/device/sensor/id/42/?a=b"sv, request, true ) == "bound|id=42|?a=b"s );
+      CHECK_FALSE( r.routeTarget( "GET"sv, "?a=b"sv, request ) );
+    }
+  }
+
+  GIVEN( "Router with handlers that do not accept the query" )
+  {
+    using Router = spt::http::router::HttpRouter<const Request&, std::string>;
+    Router r;
+    r.add( "GET"sv, "/device/sensor/id/{id}"sv, &plain );
+
+    WHEN( "Routing request targets" )
+    {
+      CHECK( r.routeTarget( "GET"sv, "/device/sensor/id/42?fields=a"sv, request ) == "plain|id=42"s );
+      CHECK( r.route( "GET"sv, "/device/sensor/id/42?fields=a"sv, request ) == "plain|id=42?fields=a"s );
+    }
+  }
+}
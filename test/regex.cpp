@@ -0,0 +1,232 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include "../src/router.hpp"
+#include "../src/static.hpp"
+
+#include <cstring>
+#include <sstream>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+  using spt::http::router::Literal;
+  using spt::http::router::Route;
+
+  struct Request {};
+  using Map = spt::http::router::HttpRouter<const Request&, std::string>::MapType;
+
+  template <Literal Name>
+  std::string named( const Request&, Map&& args )
+  {
+    auto out = std::string{ Name.view() };
+    for ( auto&& [key, value] : args ) out.append( "|" ).append( key ).append( "=" ).append( value );
+    return out;
+  }
+
+  std::string notFound( const Request&, Map&& ) { return "404"s; }
+  std::string methodNotAllowed( const Request&, Map&& ) { return "405"s; }
+
+  using StaticRouter = spt::http::router::StaticRouter<const Request&, std::string, Map,
+      Route<"GET", "/report/{date:\\d{4}-\\d{2}-\\d{2}}", &named<"date">>,
+      Route<"GET", "/report/{code:[A-Z]{3}-\\d+}", &named<"code">>,
+      Route<"GET", "/report/{id:int}", &named<"int">>,
+      Route<"GET", "/report/{name}", &named<"name">>,
+      Route<"GET", "/report/{date:\\d{4}-\\d{2}-\\d{2}}/summary", &named<"summary">>,
+      Route<"GET", "/file/{file:(?:[a-z0-9_-]+\\.)+(json|csv)}", &named<"file">>,
+      Route<"GET", "/tag/{tag:[a-z]*-v\\d*}", &named<"tag">>,
+      Route<"GET", "/tag/{tag:[a-z]*-v\\d*}/*", &named<"tagged">>,
+      Route<"GET", "/page/{page:[a-z]{2,4}}", &named<"page">>>;
+
+  namespace impl = spt::http::router::impl;
+  static_assert( impl::check( "\\d{4}-\\d{2}-\\d{2}" ).empty() );
+  static_assert( !impl::check( "[a-z" ).empty() );
+  static_assert( !impl::check( "(ab" ).empty() );
+  static_assert( !impl::check( "a{2,1}" ).empty() );
+  static_assert( impl::validParameters( "/report/{code:[A-Z]{3}-\\d+}" ) );
+  static_assert( !impl::validParameters( "/report/{code:[A-Z}" ) );
+  static_assert( impl::equivalent( "/report/{code:[A-Z]+}", "/report/{key:[A-Z]+}" ) );
+  static_assert( !impl::equivalent( "/report/{code:[A-Z]+}", "/report/{code:[a-z]+}" ) );
+  static_assert( impl::wildcard( "/tag/{tag:[a-z]*}" ) == std::string_view::npos );
+  static_assert( impl::wildcard( "/tag/{tag:[a-z]*}/*" ) == 18 );
+  static_assert( impl::validWildcard( "/tag/{tag:[a-z]*}/*" ) );
+  static_assert( !impl::validWildcard( "/tag/{tag:[a-z]*}/a*" ) );
+  static_assert( !impl::validWildcard( "/tag/*/{tag:[a-z]*}" ) );
+}
+
+SCENARIO( "Regular expression constraint test suite" )
+{
+  Request request;
+  using impl::Dfa;
+
+  GIVEN( "Patterns compiled to automata" )
+  {
+    WHEN( "Matching dates" )
+    {
+      const auto dfa = Dfa::compile( "\\d{4}-\\d{2}-\\d{2}"sv );
+      CHECK( dfa.match( "2022-03-14"sv ) );
+      CHECK( dfa.match( "0000-00-00"sv ) );
+      CHECK_FALSE( dfa.match( "2022-3-14"sv ) );
+      CHECK_FALSE( dfa.match( "2022-03-14T20:11"sv ) );
+      CHECK_FALSE( dfa.match( "x2022-03-14"sv ) );
+      CHECK_FALSE( dfa.match( ""sv ) );
+    }
+
+    AND_WHEN( "Matching classes, repetition and alternation" )
+    {
+      const auto code = Dfa::compile( "^[A-Z]{3}-\\d+$"sv );
+      CHECK( code.match( "ABC-1"sv ) );
+      CHECK( code.match( "XYZ-0123456789"sv ) );
+      CHECK_FALSE( code.match( "AB-1"sv ) );
+      CHECK_FALSE( code.match( "abc-1"sv ) );
+      CHECK_FALSE( code.match( "ABC-"sv ) );
+
+      const auto file = Dfa::compile( "(?:[a-z0-9_-]+\\.)+(json|csv)"sv );
+      CHECK( file.match( "report.json"sv ) );
+      CHECK( file.match( "report.2022_03.csv"sv ) );
+      CHECK_FALSE( file.match( "report.xml"sv ) );
+      CHECK_FALSE( file.match( ".json"sv ) );
+      CHECK_FALSE( file.match( "report.jsoncsv"sv ) );
+
+      const auto other = Dfa::compile( "[^.]*\\s?\\W|a.c|x*"sv );
+      CHECK( other.match( "abc!"sv ) );
+      CHECK( other.match( "ab !"sv ) );
+      CHECK( other.match( "a.c"sv ) );
+      CHECK( other.match( "xxx"sv ) );
+      CHECK( other.match( ""sv ) );
+      CHECK_FALSE( other.match( "a.cd"sv ) );
+      CHECK_FALSE( other.match( "ab.c!"sv ) );
+
+      const auto high = Dfa::compile( "\\W{2}"sv );
+      CHECK( high.match( "\xc3\xa9"sv ) );
+      CHECK_FALSE( high.match( "e"sv ) );
+    }
+
+    AND_WHEN( "Compiling invalid patterns" )
+    {
+      for ( const auto p : { "[a-z"sv, "(ab"sv, "ab)"sv, "*a"sv, "a{2,1}"sv, "a{1001}"sv, "\\1"sv, "a\\"sv, "[z-a]"sv } )
+      {
+        INFO( p );
+        CHECK_THROWS_AS( Dfa::compile( p ), spt::http::router::InvalidParameterError );
+      }
+      CHECK_THROWS_AS( Dfa::compile( "(a|b)*a(a|b){16}"sv ), spt::http::router::InvalidParameterError );
+    }
+  }
+
+  GIVEN( "Routers with routes constrained by regular expressions" )
+  {
+    using Router = spt::http::router::HttpRouter<const Request&, std::string>;
+    using Cached = spt::http::router::HttpRouter<const Request&, std::string, Map, std::function<std::string( const Request&, Map&& )>, 8>;
+    Router r{ &notFound, &methodNotAllowed };
+    Cached c{ &notFound, &methodNotAllowed, std::nullopt, 16 };
+    const auto configure = []( auto& router )
+    {
+      router.add( "GET"sv, "/report/{date:\\d{4}-\\d{2}-\\d{2}}"sv, &named<"date"> );
+      router.add( "GET"sv, "/report/{code:[A-Z]{3}-\\d+}"sv, &named<"code"> );
+      router.add( "GET"sv, "/report/{id:int}"sv, &named<"int"> );
+      router.add( "GET"sv, "/report/{name}"sv, &named<"name"> );
+      router.add( "GET"sv, "/report/{date:\\d{4}-\\d{2}-\\d{2}}/summary"sv, &named<"summary"> );
+      router.add( "GET"sv, "/file/{file:(?:[a-z0-9_-]+\\.)+(json|csv)}"sv, &named<"file"> );
+      router.add( "GET"sv, "/tag/{tag:[a-z]*-v\\d*}"sv, &named<"tag"> );
+      router.add( "GET"sv, "/tag/{tag:[a-z]*-v\\d*}/*"sv, &named<"tagged"> );
+      router.add( "GET"sv, "/page/{page:[a-z]{2,4}}"sv, &named<"page"> );
+    };
+    configure( r );
+    configure( c );
+
+    const auto compiled = r.compile();
+    const auto fixed = StaticRouter{ &notFound, &methodNotAllowed };
+
+    const auto requests = std::vector<std::tuple<std::string_view, std::string_view, std::string_view>>{
+        { "GET"sv, "/report/2022-03-14"sv, "date|date=2022-03-14"sv },
+        { "GET"sv, "/report/ABC-42"sv, "code|code=ABC-42"sv },
+        { "GET"sv, "/report/42"sv, "int|id=42"sv },
+        { "GET"sv, "/report/2022-3-14"sv, "name|name=2022-3-14"sv },
+        { "GET"sv, "/report/abc-42"sv, "name|name=abc-42"sv },
+        { "GET"sv, "/report/2022-03-14/summary"sv, "summary|date=2022-03-14"sv },
+        { "GET"sv, "/report/ABC-42/summary"sv, "404"sv },
+        { "GET"sv, "/file/report.json"sv, "file|file=report.json"sv },
+        { "GET"sv, "/file/report.xml"sv, "404"sv },
+        { "POST"sv, "/file/report.json"sv, "405"sv },
+        { "GET"sv, "/tag/-v"sv, "tag|tag=-v"sv },
+        { "GET"sv, "/tag/release-v42"sv, "tag|tag=release-v42"sv },
+        { "GET"sv, "/tag/Release-v42"sv, "404"sv },
+        { "GET"sv, "/tag/release-v42/notes/en.md"sv, "tagged|_wildcard_=notes/en.md|tag=release-v42"sv },
+        { "GET"sv, "/page/ab"sv, "page|page=ab"sv },
+        { "GET"sv, "/page/abcd"sv, "page|page=abcd"sv },
+        { "GET"sv, "/page/a"sv, "404"sv },
+        { "GET"sv, "/page/abcde"sv, "404"sv },
+    };
+
+    WHEN( "Routing requests" )
+    {
+      for ( const auto& [method, path, expected] : requests )
+      {
+        INFO( method << " " << path );
+        auto resp = r.route( method, path, request );
+        REQUIRE( resp );
+        CHECK( *resp == expected );
+
+        // Twice, the second time from the cache and memo
+        CHECK( c.route( method, path, request ) == resp );
+        CHECK( c.route( method, path, request ) == resp );
+        CHECK( compiled.route( method, path, request ) == resp );
+        CHECK( fixed.route( method, path, request ) == resp );
+
+        CHECK( compiled.canRoute( method, path ) == r.canRoute( method, path ) );
+        CHECK( fixed.canRoute( method, path ) == r.canRoute( method, path ) );
+      }
+    }
+
+    AND_WHEN( "Loading the compiled router from a saved image" )
+    {
+      using Compiled = spt::http::router::CompiledRouter<const Request&, std::string, Map>;
+      auto out = std::ostringstream{};
+      compiled.save( out );
+      const auto str = out.str();
+      auto image = std::vector<std::byte>( str.size() );
+      std::memcpy( image.data(), str.data(), str.size() );
+
+      const auto loaded = Compiled::load( image, nullptr, []( const spt::http::router::RouteId& id )
+      {
+        return Router::Handler{ [path = std::string{ id.path }]( const Request&, Map&& args )
+        {
+          auto resp = path;
+          for ( auto&& [key, value] : args ) resp.append( "|" ).append( key ).append( "=" ).append( value );
+          return resp;
+        } };
+      }, &notFound, &methodNotAllowed );
+
+      CHECK( loaded.bytes() == compiled.bytes() );
+      CHECK( loaded.route( "GET"sv, "/report/2022-03-14"sv, request ) == "/report/{date:\\d{4}-\\d{2}-\\d{2}}|date=2022-03-14"s );
+      CHECK( loaded.route( "GET"sv, "/report/ABC-42"sv, request ) == "/report/{code:[A-Z]{3}-\\d+}|code=ABC-42"s );
+      CHECK( loaded.route( "GET"sv, "/report/john"sv, request ) == "/report/{name}|name=john"s );
+      CHECK( loaded.route( "GET"sv, "/file/report.xml"sv, request ) == "404"s );
+    }
+
+    AND_WHEN( "Configuring a clashing or invalid route" )
+    {
+      CHECK_THROWS_AS( r.add( "GET"sv, "/report/{day:\\d{4}-\\d{2}-\\d{2}}"sv, &named<"clash"> ), spt::http::router::DuplicateRouteError );
+      CHECK_NOTHROW( r.add( "GET"sv, "/report/{day:\\d{2}-\\d{2}-\\d{4}}"sv, &named<"day"> ) );
+      CHECK_THROWS_AS( r.add( "GET"sv, "/report/{code:[A-Z}"sv, &named<"invalid"> ), spt::http::router::InvalidParameterError );
+      CHECK( r.route( "GET"sv, "/report/14-03-2022"sv, request ) == "day|day=14-03-2022"s );
+
+      // `*` in a regular expression is a quantifier, only a trailing `/*` segment is a wildcard
+      CHECK_THROWS_AS( r.add( "GET"sv, "/tag/{tag:[a-z]*}/a*"sv, &named<"invalid"> ), spt::http::router::InvalidWildcardError );
+      CHECK_THROWS_AS( r.add( "GET"sv, "/tag/*/{tag:[a-z]*}"sv, &named<"invalid"> ), spt::http::router::InvalidWildcardError );
+      auto routes = std::vector<Router::RouteSpec>{};
+      routes.push_back( { "GET"sv, "/label/{label:x*y}"sv, &named<"label"> } );
+      routes.push_back( { "GET"sv, "/label/{label:x*y}/*"sv, &named<"labelled"> } );
+      routes.push_back( { "GET"sv, "/label/{label:x{1,2}z}"sv, &named<"short"> } );
+      CHECK_NOTHROW( r.addAll( routes ) );
+      CHECK( r.route( "GET"sv, "/label/xxxy"sv, request ) == "label|label=xxxy"s );
+      CHECK( r.route( "GET"sv, "/label/y/a/b"sv, request ) == "labelled|_wildcard_=a/b|label=y"s );
+      CHECK( r.route( "GET"sv, "/label/xxz"sv, request ) == "short|label=xxz"s );
+      CHECK( r.route( "GET"sv, "/label/xxxz"sv, request ) == "404"s );
+    }
+  }
+}
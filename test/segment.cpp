@@ -0,0 +1,70 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include <array>
+#include <random>
+#include <string>
+#include "../src/split.hpp"
+
+using namespace std::string_view_literals;
+
+SCENARIO( "Path segmenter test suite" )
+{
+  GIVEN( "Paths of varying length and structure" )
+  {
+    auto paths = std::vector<std::string>{ "", "/", "//", "/a", "a", "a/", "/device/sensor/", "//device//sensor//id/",
+        "/device/sensor/id/6230f3069e7c9be9ff4b78a1/history/json" };
+
+    auto engine = std::mt19937{ 42 };
+    auto byte = std::uniform_int_distribution<int>{ 0, 3 };
+    for ( std::size_t size : { 15u, 16u, 17u, 31u, 32u, 33u, 63u, 64u, 65u, 100u, 255u, 2000u } )
+    {
+      for ( auto i = 0; i < 5; ++i )
+      {
+        auto path = std::string( size, 'x' );
+        for ( auto& c : path ) c = byte( engine ) == 0 ? '/' : 'a' + byte( engine );
+        paths.push_back( std::move( path ) );
+      }
+    }
+
+    WHEN( "Segmenting into views" )
+    {
+      for ( const auto& path : paths )
+      {
+        INFO( path );
+        const auto expected = spt::util::split<std::string_view>( path );
+        auto buffer = std::array<std::string_view, 1024>{};
+        const auto count = spt::util::segment( path, buffer );
+        REQUIRE( count == expected.size() );
+        for ( std::size_t i = 0; i < count && i < buffer.size(); ++i ) CHECK( buffer[i] == expected[i] );
+      }
+    }
+
+    AND_WHEN( "Segmenting into offsets" )
+    {
+      for ( const auto& path : paths )
+      {
+        INFO( path );
+        const auto expected = spt::util::split<std::string_view>( path );
+        auto buffer = std::array<spt::util::Segment, 1024>{};
+        const auto count = spt::util::segment( path, buffer );
+        REQUIRE( count == expected.size() );
+        for ( std::size_t i = 0; i < count && i < buffer.size(); ++i )
+        {
+          CHECK( std::string_view{ path }.substr( buffer[i].offset, buffer[i].size ) == expected[i] );
+        }
+      }
+    }
+
+    AND_WHEN( "Segmenting into a buffer that is too small" )
+    {
+      auto buffer = std::array<std::string_view, 2>{};
+      const auto count = spt::util::segment( "/device/sensor/id/abc"sv, buffer );
+      CHECK( count == 4 );
+      CHECK( buffer[0] == "device"sv );
+      CHECK( buffer[1] == "sensor"sv );
+    }
+  }
+}
@@ -0,0 +1,248 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include "../src/router.hpp"
+#include "../src/static.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+  using spt::http::router::Literal;
+  using spt::http::router::Route;
+
+  struct Request {};
+  using Map = spt::http::router::HttpRouter<const Request&, std::string>::MapType;
+
+  template <Literal Name>
+  std::string named( const Request&, Map&& args )
+  {
+    auto out = std::string{ Name.view() };
+    for ( auto&& [key, value] : args ) out.append( "|" ).append( key ).append( "=" ).append( value );
+    return out;
+  }
+
+  std::string failing( const Request&, Map&& )
+  {
+    throw std::runtime_error( "error" );
+  }
+
+  std::string notFound( const Request&, Map&& ) { return "404"s; }
+  std::string methodNotAllowed( const Request&, Map&& ) { return "405"s; }
+  std::string error( const Request&, Map&& ) { return "500"s; }
+
+  using StaticRouter = spt::http::router::StaticRouter<const Request&, std::string, Map,
+      Route<"GET", "/device/sensor/", &named<"list">>,
+      Route<"POST", "/device/sensor/", &named<"create">>,
+      Route<"GET", "/device/sensor/id/{id}", &named<"retrieve">>,
+      Route<"PUT", "/device/sensor/id/{id}", &named<"update">>,
+      Route<"PURGE", "/device/sensor/id/{id}", &named<"purge">>,
+      Route<"GET", "/device/sensor/identifier/{identifier}", &named<"identifier">>,
+      Route<"GET", "/device/sensor/{property}/between/{start}/{end}", &named<"between">>,
+      Route<"GET", "/device/sensor/id/{id}/*", &named<"subresource">>,
+      Route<"GET", "/device/sensor/*", &named<"sensor">>,
+      Route<"GET", "/device/{type}/id/{id}", &named<"typed">>,
+      Route<"GET", "/device/file/*", &named<"file">>,
+      Route<"GET", "/device/error", &failing>,
+      Route<"PROPFIND", "/dav/{collection}/*", &named<"dav">>,
+      Route<"GET", "/zzz/static", &named<"last">>>;
+
+  namespace impl = spt::http::router::impl;
+  static_assert( impl::validParameters( "/device/sensor/id/{id}" ) );
+  static_assert( !impl::validParameters( "/device/sensor/id/{id" ) );
+  static_assert( !impl::validParameters( "/device/sensor/id/:id" ) );
+  static_assert( impl::validWildcard( "/device/sensor/*" ) );
+  static_assert( !impl::validWildcard( "/device/sensor*" ) );
+  static_assert( !impl::validWildcard( "/device/*/sensor" ) );
+  static_assert( impl::equivalent( "/device/{type}/id/{id}", "/device/{kind}/id/{identifier}" ) );
+  static_assert( !impl::equivalent( "/device/{type}/id/{id}", "/device/sensor/id/{id}" ) );
+}
+
+SCENARIO( "Static router test suite" )
+{
+  Request request;
+
+  GIVEN( "Static and runtime routers configured with the same routes" )
+  {
+    using Router = spt::http::router::HttpRouter<const Request&, std::string>;
+    Router r{ &notFound, &methodNotAllowed, &error };
+    r.add( "GET"sv, "/device/sensor/"sv, &named<"list"> );
+    r.add( "POST"sv, "/device/sensor/"sv, &named<"create"> );
+    r.add( "GET"sv, "/device/sensor/id/{id}"sv, &named<"retrieve"> );
+    r.add( "PUT"sv, "/device/sensor/id/{id}"sv, &named<"update"> );
+    r.add( "PURGE"sv, "/device/sensor/id/{id}"sv, &named<"purge"> );
+    r.add( "GET"sv, "/device/sensor/identifier/{identifier}"sv, &named<"identifier"> );
+    r.add( "GET"sv, "/device/sensor/{property}/between/{start}/{end}"sv, &named<"between"> );
+    r.add( "GET"sv, "/device/sensor/id/{id}/*"sv, &named<"subresource"> );
+    r.add( "GET"sv, "/device/sensor/*"sv, &named<"sensor"> );
+    r.add( "GET"sv, "/device/{type}/id/{id}"sv, &named<"typed"> );
+    r.add( "GET"sv, "/device/file/*"sv, &named<"file"> );
+    r.add( "GET"sv, "/device/error"sv, &failing );
+    r.add( "PROPFIND"sv, "/dav/{collection}/*"sv, &named<"dav"> );
+    r.add( "GET"sv, "/zzz/static"sv, &named<"last"> );
+
+    const auto fixed = StaticRouter{ &notFound, &methodNotAllowed, &error };
+
+    WHEN( "Routing requests with the static router" )
+    {
+      const auto requests = std::vector<std::pair<std::string_view, std::string_view>>{
+          { "GET"sv, "/device/sensor/"sv },
+          { "POST"sv, "/device/sensor/"sv },
+          { "DELETE"sv, "/device/sensor/"sv },
+          { "GET"sv, "/device/sensor"sv },
+          { "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv },
+          { "PUT"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv },
+          { "PURGE"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv },
+          { "PATCH"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1"sv },
+          { "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1/history/json"sv },
+          { "GET"sv, "/device/sensor/identifier/sensor one"sv },
+          { "GET"sv, "/device/sensor/created/between/2022-03-14T20:11:50.620Z/2022-03-16T20:11:50.620Z"sv },
+          { "GET"sv, "/device/sensor/created/between/2022-03-14T20:11:50.620Z"sv },
+          { "GET"sv, "/device/sensor/other/path"sv },
+          { "GET"sv, "/device/camera/id/6230f3069e7c9be9ff4b78a1"sv },
+          { "GET"sv, "/device/file/path/to/file.txt"sv },
+          { "GET"sv, "/device/file/"sv },
+          { "GET"sv, "/device/error"sv },
+          { "PROPFIND"sv, "/dav/calendar/2022/03/event.ics"sv },
+          { "GET"sv, "/dav/calendar/2022/03/event.ics"sv },
+          { "GET"sv, "/other/path"sv },
+          { "GET"sv, "/zzz/static"sv },
+      };
+
+      for ( const auto& [method, path] : requests )
+      {
+        INFO( method << " " << path );
+        CHECK( fixed.route( method, path, request ) == r.route( method, path, request ) );
+        CHECK( fixed.route( method, path, request, true ) == r.route( method, path, request, true ) );
+        CHECK( fixed.canRoute( method, path ) == r.canRoute( method, path ) );
+      }
+    }
+
+    AND_WHEN( "Checking the parameters extracted" )
+    {
+      auto resp = fixed.route( "GET"sv, "/device/sensor/id/6230f3069e7c9be9ff4b78a1/history/json"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "subresource|_wildcard_=history/json|id=6230f3069e7c9be9ff4b78a1"s );
+
+      resp = fixed.route( "GET"sv, "/device/sensor/created/between/a/b"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "between|end=b|property=created|start=a"s );
+
+      resp = fixed.route( "PATCH"sv, "/device/sensor/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "405"s );
+    }
+  }
+
+  GIVEN( "Static and runtime routers with paths that sort before the parameters" )
+  {
+    using Router = spt::http::router::HttpRouter<const Request&, std::string>;
+    Router r;
+    r.add( "GET"sv, "/a/{id}"sv, &named<"id"> );
+    r.add( "GET"sv, "/a/{id}/*"sv, &named<"nested"> );
+    r.add( "GET"sv, "/w/*"sv, &named<"wildcard"> );
+    r.add( "GET"sv, "/w/|"sv, &named<"bar"> );
+
+    using Fixed = spt::http::router::StaticRouter<const Request&, std::string, Map,
+        Route<"GET", "/a/{id}", &named<"id">>,
+        Route<"GET", "/a/{id}/*", &named<"nested">>,
+        Route<"GET", "/w/*", &named<"wildcard">>,
+        Route<"GET", "/w/|", &named<"bar">>>;
+    const auto fixed = Fixed{};
+
+    WHEN( "Routing the same requests with both routers" )
+    {
+      const auto requests = std::vector<std::string_view>{
+          "/a/x"sv, "/a/{"sv, "/a/|"sv, "/a/}"sv, "/a/~x"sv, "/a/x/~"sv, "/a/~/x"sv, "/a/x/y/z"sv,
+          "/w/x"sv, "/w/{"sv, "/w/|"sv, "/w/~"sv, "/w/~~"sv, "/w/~/x"sv,
+      };
+
+      for ( const auto path : requests )
+      {
+        INFO( path );
+        CHECK( fixed.route( "GET"sv, path, request ) == r.route( "GET"sv, path, request ) );
+        CHECK( fixed.canRoute( "GET"sv, path ) == r.canRoute( "GET"sv, path ) );
+      }
+
+      CHECK_FALSE( fixed.route( "GET"sv, "/a/~x"sv, request ) );
+      CHECK_FALSE( fixed.route( "GET"sv, "/a/|"sv, request ) );
+      CHECK_FALSE( fixed.route( "GET"sv, "/a/}"sv, request ) );
+      CHECK( fixed.route( "GET"sv, "/a/{"sv, request ) == "id|id={"s );
+    }
+  }
+
+  GIVEN( "Static and runtime routers with paths that end at the same node" )
+  {
+    using Router = spt::http::router::HttpRouter<const Request&, std::string>;
+    Router r{ &notFound, &methodNotAllowed };
+    r.add( "GET"sv, "/a/{id}"sv, &named<"a"> );
+    r.add( "POST"sv, "/a/{id}/"sv, &named<"b"> );
+    r.add( "GET"sv, "/s/~x"sv, &named<"x"> );
+    r.add( "POST"sv, "/s/~x/"sv, &named<"y"> );
+
+    using Fixed = spt::http::router::StaticRouter<const Request&, std::string, Map,
+        Route<"GET", "/a/{id}", &named<"a">>,
+        Route<"POST", "/a/{id}/", &named<"b">>,
+        Route<"GET", "/s/~x", &named<"x">>,
+        Route<"POST", "/s/~x/", &named<"y">>>;
+    const auto fixed = Fixed{ &notFound, &methodNotAllowed };
+
+    WHEN( "Routing the same requests with both routers" )
+    {
+      const auto requests = std::vector<std::pair<std::string_view, std::string_view>>{
+          { "POST"sv, "/a/{id}/"sv },
+          { "POST"sv, "/a/{id}!"sv },
+          { "GET"sv, "/a/{id}"sv },
+          { "POST"sv, "/a/{id}"sv },
+          { "GET"sv, "/a/{id}/"sv },
+          { "GET"sv, "/a/x"sv },
+          { "POST"sv, "/a/x/"sv },
+          { "GET"sv, "/s/~x"sv },
+          { "POST"sv, "/s/~x/"sv },
+          { "GET"sv, "/s/~x/"sv },
+          { "GET"sv, "/z"sv },
+      };
+
+      for ( const auto& [method, path] : requests )
+      {
+        INFO( method << " " << path );
+        CHECK( fixed.route( method, path, request ) == r.route( method, path, request ) );
+        CHECK( fixed.route( method, path, request, true ) == r.route( method, path, request, true ) );
+        CHECK( fixed.canRoute( method, path ) == r.canRoute( method, path ) );
+      }
+
+      CHECK( fixed.route( "POST"sv, "/a/{id}/"sv, request ) == "b"s );
+      CHECK( fixed.route( "POST"sv, "/a/{id}!"sv, request ) == "b|id={id}!"s );
+      CHECK( fixed.route( "GET"sv, "/a/{id}"sv, request ) == "a"s );
+      CHECK_FALSE( fixed.route( "GET"sv, "/z"sv, request ) );
+    }
+  }
+
+  GIVEN( "Static router without error handlers" )
+  {
+    using Router = spt::http::router::StaticRouter<const Request&, std::string, Map,
+        Route<"GET", "/", &named<"root">>,
+        Route<"GET", "/{filename}", &named<"file">>,
+        Route<"GET", "/service/~static", &named<"static">>,
+        Route<"GET", "/service/{name}", &named<"service">>>;
+    const auto r = Router{};
+
+    WHEN( "Routing requests" )
+    {
+      CHECK( r.route( "GET"sv, "/"sv, request ) == "root"s );
+      CHECK( r.route( "GET"sv, "/index.html"sv, request ) == "file|filename=index.html"s );
+      CHECK( r.route( "GET"sv, "/service/~static"sv, request ) == "static"s );
+      CHECK( r.route( "GET"sv, "/service/other"sv, request ) == "service|name=other"s );
+      CHECK_FALSE( r.route( "GET"sv, "/service/other/path"sv, request ) );
+      CHECK_FALSE( r.route( "POST"sv, "/"sv, request ) );
+      CHECK_FALSE( r.route( ""sv, "/"sv, request ) );
+
+      auto [p, m] = r.canRoute( "POST"sv, "/index.html"sv );
+      CHECK( p );
+      CHECK_FALSE( m );
+    }
+  }
+}
@@ -0,0 +1,129 @@
+#if __GNUC__ > 10 || defined _WIN32
+#include <catch2/catch.hpp>
+#else
+#include <catch2/catch_test_macros.hpp>
+#endif
+#include <map>
+#include "../src/router.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+SCENARIO( "Trie matching test suite" )
+{
+  struct Request {} request;
+  using Params = std::map<std::string, std::string>;
+  using Router = spt::http::router::HttpRouter<const Request&, std::string, Params>;
+
+  GIVEN( "Router with overlapping static, parameter and wildcard paths" )
+  {
+    const auto method = "GET"sv;
+    Router r{ []( const Request&, Params&& ) { return "404"s; },
+        []( const Request&, Params&& ) { return "405"s; } };
+
+    r.add( method, "/entity/id/{id}"sv, []( const Request&, Params&& args ) { return "id:"s + args["id"]; } );
+    r.add( method, "/entity/{property}/between/{start}/{end}"sv, []( const Request&, Params&& args )
+    {
+      return "between:"s + args["property"] + ":" + args["start"] + ":" + args["end"];
+    } );
+    r.add( method, "/entity/{property}"sv, []( const Request&, Params&& args ) { return "property:"s + args["property"]; } );
+    r.add( method, "/entity/*"sv, [&r]( const Request&, Params&& args ) { return "wildcard:"s + args[r.WildcardKey]; } );
+    r.add( "POST"sv, "/entity/id/{id}/history"sv, []( const Request&, Params&& args ) { return "history:"s + args["id"]; } );
+
+    WHEN( "Routing to the static branch" )
+    {
+      auto resp = r.route( method, "/entity/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "id:abc"s );
+    }
+
+    AND_WHEN( "Static branch does not match the remaining segments" )
+    {
+      auto resp = r.route( method, "/entity/id/between/start/end"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "between:id:start:end"s );
+    }
+
+    AND_WHEN( "Parameter branch matches a single segment" )
+    {
+      auto resp = r.route( method, "/entity/name"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "property:name"s );
+    }
+
+    AND_WHEN( "Falling back to the wildcard" )
+    {
+      auto resp = r.route( method, "/entity/name/other/value"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "wildcard:name/other/value"s );
+      auto [p, m] = r.canRoute( method, "/entity/name/other/value"sv );
+      CHECK( p );
+      CHECK( m );
+    }
+
+    AND_WHEN( "First matching route is not configured for the method" )
+    {
+      auto resp = r.route( method, "/entity/id/abc/history"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "405"s );
+      auto [p, m] = r.canRoute( method, "/entity/id/abc/history"sv );
+      CHECK( p );
+      CHECK_FALSE( m );
+
+      resp = r.route( "POST"sv, "/entity/id/abc/history"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "history:abc"s );
+    }
+
+    AND_WHEN( "No route matches" )
+    {
+      auto resp = r.route( method, "/device/id/abc"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "404"s );
+      auto [p, m] = r.canRoute( method, "/device/id/abc"sv );
+      CHECK_FALSE( p );
+      CHECK_FALSE( m );
+    }
+  }
+
+  GIVEN( "Router with a large number of routes" )
+  {
+    const auto method = "GET"sv;
+    Router r;
+    r.add( method, "/{filename}"sv, []( const Request&, Params&& args ) { return args["filename"]; } );
+    for ( auto i = 0; i < 2000; ++i )
+    {
+      auto entity = "/entity"s + std::to_string( i );
+      r.add( method, entity + "/id/{id}", [i]( const Request&, Params&& args )
+      {
+        return std::to_string( i ) + ":" + args["id"];
+      } );
+      r.add( method, entity + "/{property}/between/{start}/{end}", [i]( const Request&, Params&& args )
+      {
+        return std::to_string( i ) + ":" + args["property"];
+      } );
+    }
+
+    WHEN( "Routing parametrised paths" )
+    {
+      for ( auto i = 0; i < 2000; i += 97 )
+      {
+        auto entity = "/entity"s + std::to_string( i );
+        auto resp = r.route( method, entity + "/id/abc", request );
+        REQUIRE( resp );
+        CHECK( *resp == std::to_string( i ) + ":abc" );
+
+        resp = r.route( method, entity + "/created/between/start/end", request );
+        REQUIRE( resp );
+        CHECK( *resp == std::to_string( i ) + ":created" );
+      }
+    }
+
+    AND_WHEN( "Routing the root parameter path" )
+    {
+      auto resp = r.route( method, "/index.html"sv, request );
+      REQUIRE( resp );
+      CHECK( *resp == "index.html"s );
+    }
+  }
+}
@@ -47,6 +47,22 @@ SCENARIO( "Wildcard paths test suite" )
       CHECK( p );
       CHECK( m );
     }
+
+    AND_WHEN( "Adding another method for the wildcard path" )
+    {
+      r.add( "POST"s, "/device/sensor/*", []( const Request&, auto )
+      {
+        return "post"sv;
+      } );
+
+      auto url = "/device/sensor/id"s;
+      auto resp = r.route( "POST"s, url, request );
+      REQUIRE( resp );
+      CHECK( *resp == "post"sv );
+      resp = r.route( method, url, request );
+      REQUIRE( resp );
+      CHECK( *resp == "id"sv );
+    }
   }
 
   GIVEN( "Router with multiple wildcard paths" )